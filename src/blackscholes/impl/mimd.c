@@ -5,27 +5,58 @@
 #include "include/types.h"
 #include "CNDF.h"
 #include "blackscholes.h"
+#include "scalar.h"
+#include "simd.h"
+
+/* Default thread count when the caller does not pick one */
+#define MIMD_DEFAULT_NTHREADS 4
+
+/* State shared by all workers of one impl_mimd call */
+typedef struct {
+    args_t* args;
+    size_t  chunk_size;
+    size_t  next;        /* Next unclaimed option, advanced atomically */
+} shared_state_t;
 
 /* Structure to hold arguments for each thread */
 typedef struct {
-    float* sptPrice;
-    float* strike;
-    float* rate;
-    float* volatility;
-    float* otime;
-    char* otype;
-    float* output;
-    size_t start;
+    shared_state_t* shared;
+    size_t start;        /* Static range, used when chunk_size == 0 */
     size_t end;
 } thread_args_t;
 
+/* Run the selected kernel over [begin, end); both variants map NaN/Inf to 0 */
+static void run_range(args_t* args, size_t begin, size_t end) {
+    if (args->variant == BS_VARIANT_SIMD) {
+        simd_kernel(args, begin, end);
+    } else {
+        scalar_kernel(args, begin, end);
+    }
+
+    for (size_t i = begin; i < end; i++) {
+        float result = args->output[i];
+        args->output[i] = (isnan(result) || isinf(result)) ? 0.0f : result;
+    }
+}
+
 /* Thread function to compute Black-Scholes for a subset of options */
 void* thread_func(void* args) {
     thread_args_t* targs = (thread_args_t*)args;
+    shared_state_t* shared = targs->shared;
+    size_t num_stocks = shared->args->num_stocks;
+
+    /* Static partitioning */
+    if (shared->chunk_size == 0) {
+        run_range(shared->args, targs->start, targs->end);
+        return NULL;
+    }
 
-    for (size_t i = targs->start; i < targs->end; i++) {
-        float result = blackScholes(targs->sptPrice[i], targs->strike[i], targs->rate[i], targs->volatility[i], targs->otime[i], targs->otype[i]);
-        targs->output[i] = (isnan(result) || isinf(result)) ? 0.0f : result;
+    /* Dynamic partitioning: claim chunks until the book is exhausted */
+    for (;;) {
+        size_t begin = __atomic_fetch_add(&shared->next, shared->chunk_size, __ATOMIC_RELAXED);
+        if (begin >= num_stocks) break;
+        size_t end = begin + shared->chunk_size;
+        run_range(shared->args, begin, end < num_stocks ? end : num_stocks);
     }
     return NULL;
 }
@@ -34,27 +65,32 @@ void* thread_func(void* args) {
 void* impl_mimd(void* args) {
     args_t* arguments = (args_t*)args;
     size_t num_stocks = arguments->num_stocks;
-    int nthreads = 4;
+    int nthreads = arguments->nthreads > 0 ? arguments->nthreads : MIMD_DEFAULT_NTHREADS;
 
     pthread_t threads[nthreads];
     thread_args_t targs[nthreads];
     size_t chunk_size = num_stocks / nthreads;
 
+    shared_state_t shared = {
+        .args       = arguments,
+        .chunk_size = arguments->chunk_size,
+        .next       = 0
+    };
+
     for (int i = 0; i < nthreads; i++) {
-        targs[i].sptPrice   = arguments->sptPrice;
-        targs[i].strike     = arguments->strike;
-        targs[i].rate       = arguments->rate;
-        targs[i].volatility = arguments->volatility;
-        targs[i].otime      = arguments->otime;
-        targs[i].otype      = arguments->otype;
-        targs[i].output     = arguments->output;
-        targs[i].start      = i * chunk_size;
-        targs[i].end        = (i == nthreads - 1) ? num_stocks : (i + 1) * chunk_size;
-
-        pthread_create(&threads[i], NULL, thread_func, &targs[i]);
+        targs[i].shared = &shared;
+        targs[i].start  = i * chunk_size;
+        targs[i].end    = (i == nthreads - 1) ? num_stocks : (i + 1) * chunk_size;
+
+        /* The calling thread takes the first share itself */
+        if (i > 0) {
+            pthread_create(&threads[i], NULL, thread_func, &targs[i]);
+        }
     }
 
-    for (int i = 0; i < nthreads; i++) {
+    thread_func(&targs[0]);
+
+    for (int i = 1; i < nthreads; i++) {
         pthread_join(threads[i], NULL);
     }
 
@@ -12,14 +12,17 @@
 #include "include/types.h"
 #include "blackscholes.h"
 #include "CNDF.h"
-void* impl_scalar(void* args) { 
-    args_t* arguments = (args_t*)args;
-    size_t num_stocks = arguments->num_stocks;
-    float* output = arguments->output;
-    for (size_t i = 0; i < num_stocks; i++) {
-    output[i] = blackScholes( arguments->sptPrice[i], arguments->strike[i], arguments->rate[i], arguments->volatility[i], arguments->otime[i], arguments->otype[i] );
 
+/* Price options [begin, end) one at a time */
+void scalar_kernel(args_t* arguments, size_t begin, size_t end) {
+    float* output = arguments->output;
+    for (size_t i = begin; i < end; i++) {
+        output[i] = blackScholes( arguments->sptPrice[i], arguments->strike[i], arguments->rate[i], arguments->volatility[i], arguments->otime[i], arguments->otype[i] );
+    }
 }
-return NULL; 
 
+void* impl_scalar(void* args) { 
+    args_t* arguments = (args_t*)args;
+    scalar_kernel(arguments, 0, arguments->num_stocks);
+    return NULL; 
 }
\ No newline at end of file
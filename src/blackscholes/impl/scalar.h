@@ -9,7 +9,12 @@
 #ifndef __IMPL_SCALAR_H_
 #define __IMPL_SCALAR_H_
 
+#include "include/types.h"
+
 /* Function declaration */
 void* impl_scalar(void* args);
 
+/* Range kernel, shared with impl_mimd workers */
+void scalar_kernel(args_t* args, size_t begin, size_t end);
+
 #endif //__IMPL_SCALAR_H_
@@ -1,7 +1,12 @@
 #ifndef __IMPL_SIMD_H_
 #define __IMPL_SIMD_H_
 
+#include "include/types.h"
+
 /* Function declaration */
 void* impl_simd(void* args);
 
+/* Range kernel, shared with impl_mimd workers */
+void simd_kernel(args_t* args, size_t begin, size_t end);
+
 #endif // __IMPL_SIMD_H_
@@ -9,6 +9,19 @@
 #ifndef __INCLUDE_TYPES_H_
 #define __INCLUDE_TYPES_H_
 
+#include <stddef.h>
+
+/* Kernels that impl_mimd can run inside each worker */
+typedef enum {
+  BS_VARIANT_SCALAR = 0,
+  BS_VARIANT_SIMD   = 1,
+  BS_NUM_VARIANTS
+} bs_variant_t;
+
+#define __variant_name(x) ((x) == BS_VARIANT_SCALAR ? "scalar" : \
+                          ((x) == BS_VARIANT_SIMD   ? "simd"   : \
+                                                      "unknown"))
+
 typedef struct {
   size_t num_stocks;
 
@@ -22,6 +35,10 @@ typedef struct {
 
   int    cpu;
   int    nthreads;
+
+  /* impl_mimd scheduling: options per work item (0 = static split) */
+  size_t chunk_size;
+  int    variant;
 } args_t;
 
 #endif //__INCLUDE_TYPES_H_
@@ -5,6 +5,7 @@
 #include <math.h>
 #include <string.h>
 #include <ctype.h> // For tolower
+#include <stdbool.h>
 #include <time.h>
 
 /* Include implementation headers */
@@ -12,24 +13,28 @@
 #include "impl/mimd.h" 
 #include "impl/simd.h" 
 
-/* Structure to hold Black-Scholes parameters */
-typedef struct {
-    size_t num_stocks;
-    float* sptPrice;
-    float* strike;
-    float* rate;
-    float* volatility;
-    float* otime;
-    int* otype;
-    float* output;
-} args_t;
-
-/* Function prototypes for different implementations */
-void* impl_scalar(void* args);
-void* impl_vector(void* args);
-void* impl_parallel(void* args);
-void* impl_mimd(void* args);
-void* impl_simd(void* args);
+/* Include application-specific headers */
+#include "include/types.h"
+#include "tune/profile.h"
+#include "tune/autotune.h"
+
+/* Book sizes tuned by --autotune when --sizes is not given */
+static const size_t default_tune_sizes[] = { 1024, 16384, 262144, 1048576 };
+
+/* Parse a comma-separated list of sizes; returns the count or -1 */
+static int parse_sizes(const char* str, size_t* sizes, int max_sizes) {
+    int n = 0;
+    char* end;
+    while (*str != '\0') {
+        if (n == max_sizes) return -1;
+        unsigned long long v = strtoull(str, &end, 10);
+        if (end == str || v == 0) return -1;
+        sizes[n++] = (size_t)v;
+        str = (*end == ',') ? end + 1 : end;
+        if (*end != ',' && *end != '\0') return -1;
+    }
+    return n;
+}
 
 /* Helper function to free allocated memory */
 void free_args(args_t* args) {
@@ -64,6 +69,18 @@ int main(int argc, char** argv) {
     void* (*impl)(void* args) = NULL;
     const char* impl_str = NULL;
 
+    /* impl_mimd configuration; a loaded profile overrides it */
+    int nthreads = 0;
+    size_t chunk_size = 0;
+    int variant = BS_VARIANT_SCALAR;
+
+    /* Autotuning */
+    bool do_autotune = false;
+    const char* profile_path = NULL;
+    size_t tune_sizes[PROFILE_MAX_ENTRIES];
+    int ntune_sizes = 0;
+    int tune_runs = 5;
+
     for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "-i") == 0 || strcmp(argv[i], "--impl") == 0) {
             assert(++i < argc);
@@ -90,10 +107,84 @@ int main(int argc, char** argv) {
             nruns = atoi(argv[i]);
             continue;
         }
+
+        if (strcmp(argv[i], "-n") == 0 || strcmp(argv[i], "--nthreads") == 0) {
+            assert(++i < argc);
+            nthreads = atoi(argv[i]);
+            continue;
+        }
+
+        if (strcmp(argv[i], "--chunk") == 0) {
+            assert(++i < argc);
+            chunk_size = strtoull(argv[i], NULL, 10);
+            continue;
+        }
+
+        if (strcmp(argv[i], "--variant") == 0) {
+            assert(++i < argc);
+            if (strcmp(argv[i], "scalar") == 0) {
+                variant = BS_VARIANT_SCALAR;
+            } else if (strcmp(argv[i], "simd") == 0) {
+                variant = BS_VARIANT_SIMD;
+            } else {
+                fprintf(stderr, "Unknown variant: %s\n", argv[i]);
+                exit(1);
+            }
+            continue;
+        }
+
+        if (strcmp(argv[i], "--autotune") == 0) {
+            do_autotune = true;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--profile") == 0) {
+            assert(++i < argc);
+            profile_path = argv[i];
+            continue;
+        }
+
+        if (strcmp(argv[i], "--sizes") == 0) {
+            assert(++i < argc);
+            ntune_sizes = parse_sizes(argv[i], tune_sizes, PROFILE_MAX_ENTRIES);
+            if (ntune_sizes <= 0) {
+                fprintf(stderr, "Invalid size list: %s\n", argv[i]);
+                exit(1);
+            }
+            continue;
+        }
+
+        if (strcmp(argv[i], "--tune-runs") == 0) {
+            assert(++i < argc);
+            tune_runs = atoi(argv[i]);
+            continue;
+        }
+    }
+
+    /* Search the configuration space and persist the winners */
+    if (do_autotune) {
+        if (ntune_sizes == 0) {
+            ntune_sizes = sizeof(default_tune_sizes) / sizeof(default_tune_sizes[0]);
+            memcpy(tune_sizes, default_tune_sizes, sizeof(default_tune_sizes));
+        }
+        if (profile_path == NULL) {
+            profile_path = "blackscholes.profile";
+        }
+
+        profile_t profile;
+        if (autotune(tune_sizes, ntune_sizes, nthreads, tune_runs, &profile) != 0 ||
+            profile_save(profile_path, &profile) != 0) {
+            return 1;
+        }
+        printf("Profile written to %s\n", profile_path);
+        return 0;
     }
 
     if (impl_str == NULL) {
-        fprintf(stderr, "Usage: %s -i {naive|simd|mimd|all} [--nruns nruns]\n", argv[0]);
+        fprintf(stderr, "Usage: %s -i {naive|simd|mimd|all} [--nruns nruns] [-n nthreads]\n"
+                        "          [--chunk size] [--variant {scalar|simd}] [--profile file]\n"
+                        "       %s --autotune [--sizes n1,n2,...] [-n max_threads]\n"
+                        "          [--tune-runs runs] [--profile file]\n", argv[0], argv[0]);
         exit(1);
     }
 
@@ -117,7 +208,7 @@ int main(int argc, char** argv) {
     float* rate = malloc(num_stocks * sizeof(float));
     float* volatility = malloc(num_stocks * sizeof(float));
     float* otime = malloc(num_stocks * sizeof(float));
-    int* otype = malloc(num_stocks * sizeof(int));
+    char* otype = malloc(num_stocks * sizeof(char));
     float* output = malloc(num_stocks * sizeof(float));
 
     if (!sptPrice || !strike || !rate || !volatility || !otime || !otype || !output) {
@@ -144,9 +235,27 @@ int main(int argc, char** argv) {
         .volatility = volatility,
         .otime = otime,
         .otype = otype,
-        .output = output
+        .output = output,
+        .nthreads = nthreads,
+        .chunk_size = chunk_size,
+        .variant = variant
     };
 
+    /* Pick the tuned impl_mimd configuration for this book size */
+    if (profile_path != NULL) {
+        profile_t profile;
+        if (profile_load(profile_path, &profile) != 0) {
+            free_args(&args);
+            return 1;
+        }
+        const profile_entry_t* entry = profile_lookup(&profile, num_stocks);
+        if (entry != NULL) {
+            profile_apply(entry, &args);
+            printf("Using tuned profile entry for %zu stocks: nthreads = %d, chunk = %zu, variant = %s\n",
+                   entry->num_stocks, args.nthreads, args.chunk_size, __variant_name(args.variant));
+        }
+    }
+
     printf("Running implementation: %s\n", impl_str);
     printf("Number of stocks: %zu\n", num_stocks);
     printf("Number of runs: %d\n", nruns);
@@ -0,0 +1,194 @@
+/* autotune.c
+ *
+ * Exhaustive search of impl_mimd configurations. The input book is
+ * built from the PARSEC reference dataset (include/dataset.h), and every
+ * kernel variant is checked against impl_scalar before it is allowed to
+ * compete, so an inaccurate variant can never win on speed alone.
+ */
+
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Include application-specific headers */
+#include "include/types.h"
+#include "include/dataset.h"
+#include "impl/scalar.h"
+#include "impl/simd.h"
+#include "impl/mimd.h"
+#include "tune/autotune.h"
+
+/* Chunk sizes tried by the search; 0 is a static split */
+static const size_t chunk_candidates[] = { 0, 256, 1024, 4096, 16384, 65536 };
+#define NUM_CHUNK_CANDIDATES (sizeof(chunk_candidates) / sizeof(chunk_candidates[0]))
+
+/* Relative error a variant may have against impl_scalar */
+#define VARIANT_TOLERANCE 1e-3f
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static int cmp_double(const void* a, const void* b) {
+  double x = *(const double*)a, y = *(const double*)b;
+  return (x > y) - (x < y);
+}
+
+/* Median wall-clock time of impl_mimd under the given configuration */
+static double time_config(args_t* args, int nreps, double* samples) {
+  impl_mimd(args);
+
+  for (int r = 0; r < nreps; r++) {
+    double t0 = now_ns();
+    impl_mimd(args);
+    samples[r] = now_ns() - t0;
+  }
+
+  qsort(samples, nreps, sizeof(double), cmp_double);
+  return samples[nreps / 2];
+}
+
+/* Powers of two, always ending with max_threads itself */
+static int next_thread_count(int t, int max_threads) {
+  if (t == max_threads) return max_threads + 1;
+  return (t * 2 < max_threads) ? t * 2 : max_threads;
+}
+
+static int variant_matches(const float* ref, const float* out, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    float tol = VARIANT_TOLERANCE * fmaxf(1.0f, fabsf(ref[i]));
+    if (!(fabsf(ref[i] - out[i]) <= tol)) return 0;
+  }
+  return 1;
+}
+
+static int alloc_book(args_t* args, size_t n) {
+  memset(args, 0, sizeof(*args));
+  args->num_stocks = n;
+  args->sptPrice   = malloc(n * sizeof(float));
+  args->strike     = malloc(n * sizeof(float));
+  args->rate       = malloc(n * sizeof(float));
+  args->volatility = malloc(n * sizeof(float));
+  args->otime      = malloc(n * sizeof(float));
+  args->otype      = malloc(n * sizeof(char));
+  args->output     = malloc(n * sizeof(float));
+
+  return (args->sptPrice && args->strike && args->rate && args->volatility &&
+          args->otime && args->otype && args->output) ? 0 : -1;
+}
+
+static void free_book(args_t* args) {
+  free(args->sptPrice);
+  free(args->strike);
+  free(args->rate);
+  free(args->volatility);
+  free(args->otime);
+  free(args->otype);
+  free(args->output);
+}
+
+int autotune(const size_t* sizes, size_t nsizes, int max_threads, int nreps,
+             profile_t* profile) {
+  if (nsizes > PROFILE_MAX_ENTRIES) {
+    fprintf(stderr, "Error: at most %d book sizes can be tuned.\n", PROFILE_MAX_ENTRIES);
+    return -1;
+  }
+  if (max_threads <= 0) {
+    max_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (max_threads <= 0) max_threads = 1;
+  }
+  if (nreps <= 0) nreps = 1;
+
+  double* samples = malloc(nreps * sizeof(double));
+  if (samples == NULL) {
+    fprintf(stderr, "Memory allocation failed.\n");
+    return -1;
+  }
+
+  profile->nentries = 0;
+  printf("Autotuning impl_mimd: up to %d threads, %d runs per candidate\n", max_threads, nreps);
+
+  for (size_t s = 0; s < nsizes; s++) {
+    size_t n = sizes[s];
+    args_t args;
+    memset(&args, 0, sizeof(args));
+    float* ref = malloc(n * sizeof(float));
+
+    if (n == 0 || ref == NULL || alloc_book(&args, n) != 0) {
+      fprintf(stderr, "Error: cannot set up a book of %zu options.\n", n);
+      free(ref);
+      free_book(&args);
+      free(samples);
+      return -1;
+    }
+
+    /* Build the book; the dataset marks options as 'C'/'P' */
+    genDataset(&args);
+    for (size_t i = 0; i < n; i++) {
+      args.otype[i] = (args.otype[i] == 'P') ? 1 : 0;
+    }
+
+    /* Reference prices and variant validation */
+    float* out = args.output;
+    args.output = ref;
+    impl_scalar(&args);
+    args.output = out;
+
+    int valid[BS_NUM_VARIANTS];
+    for (int v = 0; v < BS_NUM_VARIANTS; v++) {
+      args.nthreads = 1; args.chunk_size = 0; args.variant = v;
+      impl_mimd(&args);
+      valid[v] = variant_matches(ref, args.output, n);
+      if (!valid[v]) {
+        printf("  [%zu] variant %s disagrees with impl_scalar, skipped\n", n, __variant_name(v));
+      }
+    }
+
+    profile_entry_t best = { .num_stocks = n, .runtime_ns = INFINITY };
+
+    for (int v = 0; v < BS_NUM_VARIANTS; v++) {
+      if (!valid[v]) continue;
+
+      for (int t = 1; t <= max_threads; t = next_thread_count(t, max_threads)) {
+        for (size_t c = 0; c < NUM_CHUNK_CANDIDATES; c++) {
+          size_t chunk = chunk_candidates[c];
+          if (chunk >= n || (t == 1 && chunk != 0)) continue;
+
+          args.nthreads = t; args.chunk_size = chunk; args.variant = v;
+          double runtime = time_config(&args, nreps, samples);
+
+          if (runtime < best.runtime_ns) {
+            best.nthreads   = t;
+            best.chunk_size = chunk;
+            best.variant    = v;
+            best.runtime_ns = runtime;
+          }
+        }
+      }
+    }
+
+    if (isinf(best.runtime_ns)) {
+      fprintf(stderr, "Error: no valid configuration for %zu options.\n", n);
+      free(ref);
+      free_book(&args);
+      free(samples);
+      return -1;
+    }
+
+    printf("  [%zu] nthreads = %d, chunk = %zu, variant = %s: %.0f ns\n",
+           n, best.nthreads, best.chunk_size, __variant_name(best.variant), best.runtime_ns);
+    profile->entries[profile->nentries++] = best;
+
+    free(ref);
+    free_book(&args);
+  }
+
+  free(samples);
+  return 0;
+}
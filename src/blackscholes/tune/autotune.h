@@ -0,0 +1,21 @@
+/* autotune.h
+ *
+ * Search over impl_mimd configurations (thread count, chunk size and
+ * kernel variant) for a set of book sizes on the current host.
+ */
+
+#ifndef __TUNE_AUTOTUNE_H_
+#define __TUNE_AUTOTUNE_H_
+
+#include <stddef.h>
+
+#include "tune/profile.h"
+
+/* Tune every size in `sizes` and store the winners in `profile`. Each
+ * candidate is timed `nreps` times after a warm-up run, and the median
+ * wall-clock time is kept. `max_threads` <= 0 uses all online CPUs.
+ * Returns 0 on success, -1 on failure.                               */
+int autotune(const size_t* sizes, size_t nsizes, int max_threads, int nreps,
+             profile_t* profile);
+
+#endif //__TUNE_AUTOTUNE_H_
@@ -0,0 +1,100 @@
+/* profile.c
+ *
+ * Reading, writing and querying of autotuning profiles.
+ */
+
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Include application-specific headers */
+#include "include/types.h"
+#include "tune/profile.h"
+
+static int parse_variant(const char* str) {
+  for (int v = 0; v < BS_NUM_VARIANTS; v++) {
+    if (strcmp(str, __variant_name(v)) == 0) return v;
+  }
+  return -1;
+}
+
+int profile_save(const char* path, const profile_t* profile) {
+  FILE* fp = fopen(path, "w");
+  if (fp == NULL) {
+    fprintf(stderr, "Error opening profile %s for writing.\n", path);
+    return -1;
+  }
+
+  fprintf(fp, "# blackscholes autotune profile\n");
+  fprintf(fp, "# num_stocks nthreads chunk_size variant runtime_ns\n");
+  for (size_t i = 0; i < profile->nentries; i++) {
+    const profile_entry_t* e = &profile->entries[i];
+    fprintf(fp, "%zu %d %zu %s %.0f\n", e->num_stocks, e->nthreads,
+            e->chunk_size, __variant_name(e->variant), e->runtime_ns);
+  }
+
+  fclose(fp);
+  return 0;
+}
+
+int profile_load(const char* path, profile_t* profile) {
+  FILE* fp = fopen(path, "r");
+  if (fp == NULL) {
+    fprintf(stderr, "Error opening profile %s for reading.\n", path);
+    return -1;
+  }
+
+  char line[256];
+  int  lineno = 0;
+  profile->nentries = 0;
+
+  while (fgets(line, sizeof(line), fp) != NULL) {
+    lineno++;
+    if (line[0] == '#' || line[0] == '\n') continue;
+
+    profile_entry_t e;
+    char variant[32];
+    if (sscanf(line, "%zu %d %zu %31s %lf", &e.num_stocks, &e.nthreads,
+               &e.chunk_size, variant, &e.runtime_ns) != 5 ||
+        (e.variant = parse_variant(variant)) < 0 || e.nthreads <= 0) {
+      fprintf(stderr, "Error: malformed entry at %s:%d.\n", path, lineno);
+      fclose(fp);
+      return -1;
+    }
+
+    if (profile->nentries == PROFILE_MAX_ENTRIES) {
+      fprintf(stderr, "Error: %s has more than %d entries.\n", path, PROFILE_MAX_ENTRIES);
+      fclose(fp);
+      return -1;
+    }
+    profile->entries[profile->nentries++] = e;
+  }
+
+  fclose(fp);
+  return 0;
+}
+
+const profile_entry_t* profile_lookup(const profile_t* profile, size_t num_stocks) {
+  const profile_entry_t* best     = NULL;
+  const profile_entry_t* smallest = NULL;
+
+  for (size_t i = 0; i < profile->nentries; i++) {
+    const profile_entry_t* e = &profile->entries[i];
+    if (smallest == NULL || e->num_stocks < smallest->num_stocks) {
+      smallest = e;
+    }
+    if (e->num_stocks <= num_stocks &&
+        (best == NULL || e->num_stocks > best->num_stocks)) {
+      best = e;
+    }
+  }
+
+  return best != NULL ? best : smallest;
+}
+
+void profile_apply(const profile_entry_t* entry, args_t* args) {
+  args->nthreads   = entry->nthreads;
+  args->chunk_size = entry->chunk_size;
+  args->variant    = entry->variant;
+}
@@ -0,0 +1,44 @@
+/* profile.h
+ *
+ * Persisted autotuning profile for the blackscholes benchmark. A
+ * profile is a list of book sizes, each with the thread count, chunk
+ * size and kernel variant that won the search on this host. It is
+ * stored as a plain text file, one entry per line:
+ *
+ *   num_stocks nthreads chunk_size variant runtime_ns
+ */
+
+#ifndef __TUNE_PROFILE_H_
+#define __TUNE_PROFILE_H_
+
+#include <stddef.h>
+
+#include "include/types.h"
+
+#define PROFILE_MAX_ENTRIES 64
+
+typedef struct {
+  size_t num_stocks;
+  int    nthreads;
+  size_t chunk_size;
+  int    variant;
+  double runtime_ns;
+} profile_entry_t;
+
+typedef struct {
+  size_t          nentries;
+  profile_entry_t entries[PROFILE_MAX_ENTRIES];
+} profile_t;
+
+/* Return 0 on success, -1 on failure (a message is printed) */
+int profile_save(const char* path, const profile_t* profile);
+int profile_load(const char* path, profile_t* profile);
+
+/* Entry tuned for the largest book size not above num_stocks; falls
+ * back to the smallest tuned size. NULL if the profile is empty.     */
+const profile_entry_t* profile_lookup(const profile_t* profile, size_t num_stocks);
+
+/* Copy the tuned configuration into the arguments of impl_mimd */
+void profile_apply(const profile_entry_t* entry, args_t* args);
+
+#endif //__TUNE_PROFILE_H_
@@ -0,0 +1,93 @@
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Include all implementations declarations */
+#include "impl/naive.h"
+#include "impl/simd.h"
+#include "impl/batched.h"
+
+/* Include application-specific headers */
+#include "include/types.h"
+#include "bench/bench.h"
+#include "bench/batched.h"
+
+/* 24 and 64 exercise the generic kernel */
+static const size_t batch_sizes[] = { 4, 8, 16, 24, 32, 64 };
+#define NUM_BATCH_SIZES (sizeof(batch_sizes) / sizeof(batch_sizes[0]))
+#define BATCH_RUNS 3
+
+int bench_batched(size_t batch, int nthreads) {
+    int failures = 0;
+
+    printf("Batched GEMM, %zu matrices per size, %d thread(s)\n", batch, nthreads > 0 ? nthreads : 1);
+    printf("%4s %16s %16s %16s %10s\n", "size", "strided (mat/s)", "pointers (mat/s)",
+           "per-call (mat/s)", "GFLOP/s");
+
+    for (size_t s = 0; s < NUM_BATCH_SIZES; s++) {
+        size_t n = batch_sizes[s], nn = n * n;
+
+        float* A   = bench_alloc_matrix(batch * n, n, n, MMULT_ROW_MAJOR);
+        float* B   = bench_alloc_matrix(batch * n, n, n, MMULT_ROW_MAJOR);
+        float* C   = bench_alloc_matrix(batch * n, n, n, MMULT_ROW_MAJOR);
+        float* ref = bench_alloc_matrix(batch * n, n, n, MMULT_ROW_MAJOR);
+
+        const float** Ap = malloc(batch * sizeof(float*));
+        const float** Bp = malloc(batch * sizeof(float*));
+        float**       Cp = malloc(batch * sizeof(float*));
+        if (!Ap || !Bp || !Cp) {
+            fprintf(stderr, "Memory allocation failed.\n");
+            exit(1);
+        }
+
+        /* Reference, one naive call per matrix */
+        args_t args;
+        for (size_t b = 0; b < batch; b++) {
+            bench_setup_args(&args, n, n, n, MMULT_ROW_MAJOR, 0, A + b * nn, B + b * nn, ref + b * nn);
+            impl_scalar_naive(&args);
+            Ap[b] = A + b * nn;
+            Bp[b] = B + b * nn;
+            Cp[b] = C + b * nn;
+        }
+
+        double t_strided = 0.0, t_ptr = 0.0, t_call = 0.0;
+        for (int r = 0; r < BATCH_RUNS; r++) {
+            double t0 = bench_now();
+            gemm_batched_strided(n, n, n, A, n, nn, B, n, nn, C, n, nn, batch, nthreads);
+            double t1 = bench_now();
+            failures += bench_max_abs_diff(ref, C, batch * n, n, n, MMULT_ROW_MAJOR) != 0.0f;
+
+            double t2 = bench_now();
+            gemm_batched(n, n, n, Ap, n, Bp, n, Cp, n, batch, nthreads);
+            double t3 = bench_now();
+            failures += bench_max_abs_diff(ref, C, batch * n, n, n, MMULT_ROW_MAJOR) != 0.0f;
+
+            double t4 = bench_now();
+            for (size_t b = 0; b < batch; b++) {
+                bench_setup_args(&args, n, n, n, MMULT_ROW_MAJOR, 0, A + b * nn, B + b * nn, C + b * nn);
+                impl_simd(&args);
+            }
+            double t5 = bench_now();
+
+            if (r == 0 || t1 - t0 < t_strided) t_strided = t1 - t0;
+            if (r == 0 || t3 - t2 < t_ptr)     t_ptr     = t3 - t2;
+            if (r == 0 || t5 - t4 < t_call)    t_call    = t5 - t4;
+        }
+
+        printf("%4zu %16.0f %16.0f %16.0f %10.2f\n", n, batch / t_strided, batch / t_ptr,
+               batch / t_call, bench_gflops(batch * n, n, n, t_strided));
+
+        free(A);
+        free(B);
+        free(C);
+        free(ref);
+        free(Ap);
+        free(Bp);
+        free(Cp);
+    }
+
+    if (failures > 0) {
+        printf("%d batched result(s) do not match the naive kernel.\n", failures);
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,12 @@
+#ifndef __BENCH_BATCHED_H_
+#define __BENCH_BATCHED_H_
+
+#include <stddef.h>
+
+/* Multiply `batch` small square matrices per size (4 to 64) with the
+ * strided and pointer-array batched APIs and with one impl_simd call
+ * per matrix. Results are checked against impl_scalar_naive, and
+ * matrices/sec and GFLOP/s are reported for each path.              */
+int bench_batched(size_t batch, int nthreads);
+
+#endif //__BENCH_BATCHED_H_
@@ -0,0 +1,119 @@
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+/* Include common headers */
+#include "common/macros.h"
+#include "common/types.h"
+
+/* Include all implementations declarations */
+#include "impl/naive.h"
+#include "impl/opt.h"
+#include "impl/simd.h"
+#include "impl/mimd.h"
+#include "impl/strassen.h"
+#include "impl/morton.h"
+#include "impl/transpose.h"
+#include "impl/pipeline.h"
+
+/* Include application-specific headers */
+#include "include/types.h"
+#include "include/layout.h"
+#include "bench/bench.h"
+
+const bench_impl_t bench_impls[] = {
+    { "naive", "Naive",     impl_scalar_naive },
+    { "opt",   "Optimized", impl_scalar_opt   },
+    { "simd",  "SIMD",      impl_simd         },
+    { "mimd",  "MIMD",      impl_mimd         },
+    { "strassen", "Strassen", impl_strassen    },
+    { "morton", "Morton",    impl_morton      },
+    { "transposed", "Transposed-B", impl_transposed },
+    { "pipelined", "Pipelined", impl_pipelined },
+};
+const int bench_num_impls = sizeof(bench_impls) / sizeof(bench_impls[0]);
+
+const bench_impl_t* bench_find_impl(const char* name) {
+    for (int i = 0; i < bench_num_impls; i++) {
+        if (strcmp(bench_impls[i].name, name) == 0) return &bench_impls[i];
+    }
+    return NULL;
+}
+
+double bench_now(void) {
+    struct timespec ts;
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) == -1) {
+        printf("\n\n    ERROR: getting time failed!\n\n");
+        exit(-1);
+    }
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+double bench_gflops(size_t M, size_t N, size_t K, double seconds) {
+    return seconds > 0 ? (2.0 * M * N * K) / seconds * 1e-9 : 0.0;
+}
+
+size_t bench_leading_dim(size_t rows, size_t cols, mmult_layout_t layout, size_t pad) {
+    return (layout == MMULT_COL_MAJOR ? rows : cols) + pad;
+}
+
+size_t bench_matrix_elems(size_t rows, size_t cols, size_t ld, mmult_layout_t layout) {
+    return (layout == MMULT_COL_MAJOR ? cols : rows) * ld;
+}
+
+float* bench_alloc_matrix(size_t rows, size_t cols, size_t ld, mmult_layout_t layout) {
+    size_t n = bench_matrix_elems(rows, cols, ld, layout);
+    float* m = malloc((n ? n : 1) * sizeof(float));
+    if (m == NULL) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        exit(1);
+    }
+    for (size_t i = 0; i < n; i++) {
+        m[i] = (float)(rand() % 10);
+    }
+    return m;
+}
+
+float bench_max_abs_diff(const float* X, const float* Y, size_t rows, size_t cols,
+                         size_t ld, mmult_layout_t layout) {
+    float diff = 0.0f;
+    for (size_t i = 0; i < rows; i++) {
+        for (size_t j = 0; j < cols; j++) {
+            size_t idx = mmult_index(layout, i, j, ld);
+            diff = fmaxf(diff, fabsf(X[idx] - Y[idx]));
+        }
+    }
+    return diff;
+}
+
+void bench_setup_args(args_t* args, size_t M, size_t K, size_t N,
+                      mmult_layout_t layout, size_t pad,
+                      float* A, float* B, float* R) {
+    memset(args, 0, sizeof(*args));
+    args->input0 = A;
+    args->input1 = B;
+    args->output = R;
+    args->M = M;
+    args->K = K;
+    args->N = N;
+    args->lda = bench_leading_dim(M, K, layout, pad);
+    args->ldb = bench_leading_dim(K, N, layout, pad);
+    args->ldr = bench_leading_dim(M, N, layout, pad);
+    args->layout = layout;
+    args->transa = MMULT_NO_TRANS;
+    args->transb = MMULT_NO_TRANS;
+    args->alpha = 1.0f;
+    args->beta = 0.0f;
+}
+
+void bench_set_transpose(args_t* args, mmult_trans_t transa, mmult_trans_t transb, size_t pad) {
+    args->transa = transa;
+    args->transb = transb;
+    args->lda = transa == MMULT_TRANS ? bench_leading_dim(args->K, args->M, args->layout, pad)
+                                      : bench_leading_dim(args->M, args->K, args->layout, pad);
+    args->ldb = transb == MMULT_TRANS ? bench_leading_dim(args->N, args->K, args->layout, pad)
+                                      : bench_leading_dim(args->K, args->N, args->layout, pad);
+}
@@ -0,0 +1,49 @@
+#ifndef __BENCH_BENCH_H_
+#define __BENCH_BENCH_H_
+
+#include <stddef.h>
+
+#include "include/types.h"
+
+/* An implementation selectable with -i */
+typedef struct {
+    const char* name;            // Name on the command line
+    const char* label;           // Name in reports
+    void* (*fn)(void* args);
+} bench_impl_t;
+
+extern const bench_impl_t bench_impls[];
+extern const int bench_num_impls;
+
+/* Look up an implementation by its -i name, NULL if unknown */
+const bench_impl_t* bench_find_impl(const char* name);
+
+/* Wall-clock time in seconds (CLOCK_MONOTONIC) */
+double bench_now(void);
+
+/* Convert a runtime into GFLOP/s (2*M*N*K flops) */
+double bench_gflops(size_t M, size_t N, size_t K, double seconds);
+
+/* Leading dimension of a rows x cols matrix with `pad` extra elements */
+size_t bench_leading_dim(size_t rows, size_t cols, mmult_layout_t layout, size_t pad);
+
+/* Number of floats backing a rows x cols matrix */
+size_t bench_matrix_elems(size_t rows, size_t cols, size_t ld, mmult_layout_t layout);
+
+/* Allocate a matrix filled with rand() % 10 (padding included) */
+float* bench_alloc_matrix(size_t rows, size_t cols, size_t ld, mmult_layout_t layout);
+
+/* Largest absolute difference over the logical rows x cols elements */
+float bench_max_abs_diff(const float* X, const float* Y, size_t rows, size_t cols,
+                         size_t ld, mmult_layout_t layout);
+
+/* Fill args for R = A * B; leading dimensions are taken from the shape */
+void bench_setup_args(args_t* args, size_t M, size_t K, size_t N,
+                      mmult_layout_t layout, size_t pad,
+                      float* A, float* B, float* R);
+
+/* Switch args to op(A)/op(B); a transposed operand is stored as its
+ * transpose, so its leading dimension is recomputed from that shape  */
+void bench_set_transpose(args_t* args, mmult_trans_t transa, mmult_trans_t transb, size_t pad);
+
+#endif //__BENCH_BENCH_H_
@@ -0,0 +1,153 @@
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+
+/* Include common headers */
+#include "common/macros.h"
+
+/* Include application-specific headers */
+#include "impl/conv.h"
+#include "bench/bench.h"
+#include "bench/conv.h"
+
+#define CONV_RUNS 3
+
+/* N, C, H, W, K, R, S, stride, pad; layout filled in per run */
+static const conv_shape_t conv_suite[] = {
+    { 4,   3, 224, 224,  64, 7, 7, 2, 2, 3, 3, CONV_NCHW },   /* Stem 7x7 / 2     */
+    { 4,  64,  56,  56,  64, 3, 3, 1, 1, 1, 1, CONV_NCHW },   /* 3x3 body         */
+    { 4, 256,  56,  56,  64, 1, 1, 1, 1, 0, 0, CONV_NCHW },   /* 1x1 reduction    */
+    { 4, 128,  56,  56, 128, 3, 3, 2, 2, 1, 1, CONV_NCHW },   /* 3x3 / 2          */
+    { 4, 256,  14,  14, 256, 3, 3, 1, 1, 1, 1, CONV_NCHW },   /* Small spatial    */
+};
+#define NUM_CONV_SUITE (sizeof(conv_suite) / sizeof(conv_suite[0]))
+
+static const char* conv_layout_name(conv_layout_t layout) {
+    return layout == CONV_NCHW ? "NCHW" : "NHWC";
+}
+
+static size_t conv_in_idx(const conv_shape_t* s, size_t n, size_t c, size_t h, size_t w) {
+    return s->layout == CONV_NCHW ? ((n * s->C + c) * s->H + h) * s->W + w
+                                  : ((n * s->H + h) * s->W + w) * s->C + c;
+}
+
+static size_t conv_filt_idx(const conv_shape_t* s, size_t k, size_t c, size_t r, size_t t) {
+    return s->layout == CONV_NCHW ? ((k * s->C + c) * s->R + r) * s->S + t
+                                  : ((r * s->S + t) * s->C + c) * s->K + k;
+}
+
+static size_t conv_out_idx(const conv_shape_t* s, size_t n, size_t k, size_t p, size_t q) {
+    size_t P = conv_out_h(s), Q = conv_out_w(s);
+    return s->layout == CONV_NCHW ? ((n * s->K + k) * P + p) * Q + q
+                                  : ((n * P + p) * Q + q) * s->K + k;
+}
+
+/* Direct convolution, one output at a time */
+static void conv_reference(const conv_shape_t* s, const float* in, const float* filters, float* out) {
+    size_t P = conv_out_h(s), Q = conv_out_w(s);
+    for (size_t n = 0; n < s->N; n++) {
+        for (size_t k = 0; k < s->K; k++) {
+            for (size_t p = 0; p < P; p++) {
+                for (size_t q = 0; q < Q; q++) {
+                    double acc = 0.0;
+                    for (size_t c = 0; c < s->C; c++) {
+                        for (size_t r = 0; r < s->R; r++) {
+                            long h = (long)(p * s->stride_h + r) - (long)s->pad_h;
+                            if (h < 0 || h >= (long)s->H) continue;
+                            for (size_t t = 0; t < s->S; t++) {
+                                long w = (long)(q * s->stride_w + t) - (long)s->pad_w;
+                                if (w < 0 || w >= (long)s->W) continue;
+                                acc += (double)in[conv_in_idx(s, n, c, h, w)] *
+                                       filters[conv_filt_idx(s, k, c, r, t)];
+                            }
+                        }
+                    }
+                    out[conv_out_idx(s, n, k, p, q)] = (float)acc;
+                }
+            }
+        }
+    }
+}
+
+static float conv_max_diff(const float* X, const float* Y, size_t n) {
+    float d = 0.0f;
+    for (size_t i = 0; i < n; i++) d = fmaxf(d, fabsf(X[i] - Y[i]));
+    return d;
+}
+
+static int conv_run(const conv_shape_t* s, int nthreads) {
+    size_t P = conv_out_h(s), Q = conv_out_w(s);
+    size_t nin = conv_input_elems(s), nfilt = conv_filter_elems(s), nout = conv_output_elems(s);
+    size_t ncol = conv_col_elems(s);
+    double flops = 2.0 * s->N * s->K * P * Q * s->C * s->R * s->S;
+
+    float* in      = __ALLOC_DATA(float, nin);
+    float* filters = __ALLOC_DATA(float, nfilt);
+    float* col     = __ALLOC_DATA(float, ncol);
+    float* ref     = __ALLOC_DATA(float, nout);
+    float* out     = __ALLOC_DATA(float, nout);
+
+    for (size_t i = 0; i < nin; i++) in[i] = (float)(rand() % 10);
+    for (size_t i = 0; i < nfilt; i++) filters[i] = (float)(rand() % 10);
+    conv_reference(s, in, filters, ref);
+
+    double t_exp = INFINITY, t_low = 0.0, t_imp = INFINITY;
+    float d_exp = 0.0f, d_imp = 0.0f;
+    for (int run = 0; run < CONV_RUNS; run++) {
+        double lower, t0 = bench_now();
+        conv_explicit(s, in, filters, out, col, nthreads, &lower);
+        double t = bench_now() - t0;
+        if (t < t_exp) {
+            t_exp = t;
+            t_low = lower;
+        }
+        d_exp = fmaxf(d_exp, conv_max_diff(out, ref, nout));
+
+        memset(out, 0, nout * sizeof(float));
+        t0 = bench_now();
+        conv_implicit(s, in, filters, out, nthreads);
+        t_imp = fmin(t_imp, bench_now() - t0);
+        d_imp = fmaxf(d_imp, conv_max_diff(out, ref, nout));
+    }
+
+    int bad = d_exp != 0.0f || d_imp != 0.0f;
+    printf("%3zux%3zux%3zux%3zu %3zu %zux%zu/%zu p%zu  %s %9.2f %6.1f%% %9.2f %9.1f %9.1f %9.2f%s\n",
+           s->N, s->C, s->H, s->W, s->K, s->R, s->S, s->stride_h, s->pad_h, conv_layout_name(s->layout),
+           flops / t_exp * 1e-9, 100.0 * t_low / t_exp, flops / t_imp * 1e-9,
+           (nin + nfilt + nout) * sizeof(float) / 1048576.0, ncol * sizeof(float) / 1048576.0,
+           conv_implicit_elems(s) * sizeof(float) / 1048576.0,
+           bad ? "  MISMATCH" : "");
+    if (bad) printf("    max |diff|: explicit %g, implicit %g\n", d_exp, d_imp);
+
+    free(in); free(filters); free(col); free(ref); free(out);
+    return bad;
+}
+
+int bench_conv(const conv_shape_t* shape, int layout, int nthreads) {
+    int failures = 0;
+
+    if (nthreads <= 0) nthreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (nthreads <= 0) nthreads = 1;
+
+    printf("Convolution as GEMM, %d thread%s (memory in MB, implicit space per thread)\n",
+           nthreads, nthreads > 1 ? "s" : "");
+    printf("%-15s %3s %-9s %-4s %9s %7s %9s %9s %9s %9s\n", "N x C x H x W", "K", "RxS/s pad",
+           "lay", "im2col", "lower", "implicit", "tensors", "col", "implicit");
+
+    const conv_shape_t* list = shape != NULL ? shape : conv_suite;
+    size_t count = shape != NULL ? 1 : NUM_CONV_SUITE;
+    for (size_t i = 0; i < count; i++) {
+        conv_shape_t s = list[i];
+        for (int l = CONV_NCHW; l <= CONV_NHWC; l++) {
+            if (layout >= 0 && l != layout) continue;
+            s.layout = (conv_layout_t)l;
+            failures += conv_run(&s, nthreads);
+        }
+    }
+
+    if (failures) printf("%d run(s) differ from the direct convolution\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,16 @@
+#ifndef __BENCH_CONV_H_
+#define __BENCH_CONV_H_
+
+#include "impl/conv.h"
+
+/* Convolution benchmark. Every layer of a ResNet-like suite (or the
+ * single shape, if not NULL) runs in NCHW and NHWC (only in layout if
+ * it is not negative), through im2col + GEMM and through the implicit
+ * GEMM, on nthreads threads (0 = all CPUs). Reports the GFLOP/s of each (2 N K P Q C R S
+ * flops), the share of the explicit time spent in im2col, the memory
+ * of the col buffer against the implicit packing space, and the
+ * largest difference from a direct convolution on rand() % 10 values,
+ * which has to be zero: every sum is an exact integer in float.    */
+int bench_conv(const conv_shape_t* shape, int layout, int nthreads);
+
+#endif //__BENCH_CONV_H_
@@ -0,0 +1,121 @@
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+
+/* Include application-specific headers */
+#include "include/types.h"
+#include "impl/simd.h"
+#include "bench/bench.h"
+#include "bench/epilogue.h"
+
+/* M x K x N; with a shallow K the extra passes over R dominate */
+static const size_t epilogue_shapes[][3] = {
+    {  256,  256,  256 },
+    { 1024, 1024, 1024 },
+    { 2048, 2048, 2048 },
+    { 2048,   64, 2048 },
+    { 4096,   16, 4096 },
+};
+#define NUM_EPILOGUE_SHAPES (sizeof(epilogue_shapes) / sizeof(epilogue_shapes[0]))
+
+static const struct {
+    const char* name;
+    unsigned ops;
+} epilogue_sets[] = {
+    { "bias+relu",      MMULT_EPI_ROW_BIAS | MMULT_EPI_RELU },
+    { "bias+clamp",     MMULT_EPI_COL_BIAS | MMULT_EPI_CLAMP },
+    { "all",            MMULT_EPI_ALL },
+};
+#define NUM_EPILOGUE_SETS (sizeof(epilogue_sets) / sizeof(epilogue_sets[0]))
+
+#define EPILOGUE_RUNS 3
+
+/* What we did before: one loop over R per operation */
+static void epilogue_unfused(size_t M, size_t N, const mmult_epilogue_t* e, float* R) {
+    if (e->ops & MMULT_EPI_ROW_BIAS) {
+        for (size_t i = 0; i < M; i++)
+            for (size_t j = 0; j < N; j++) R[i * N + j] += e->row_bias[i];
+    }
+    if (e->ops & MMULT_EPI_COL_BIAS) {
+        for (size_t i = 0; i < M; i++)
+            for (size_t j = 0; j < N; j++) R[i * N + j] += e->col_bias[j];
+    }
+    if (e->ops & MMULT_EPI_RELU) {
+        for (size_t i = 0; i < M * N; i++) R[i] = R[i] > 0.0f ? R[i] : 0.0f;
+    }
+    if (e->ops & MMULT_EPI_CLAMP) {
+        for (size_t i = 0; i < M * N; i++) {
+            float v = R[i] > e->lo ? R[i] : e->lo;
+            R[i] = v < e->hi ? v : e->hi;
+        }
+    }
+    if (e->ops & MMULT_EPI_SCALE) {
+        for (size_t i = 0; i < M * N; i++) R[i] *= e->scale;
+    }
+}
+
+int bench_epilogue(void) {
+    int failures = 0;
+
+    printf("Fused vs unfused epilogues (SIMD kernel)\n");
+    printf("%6s %6s %6s  %-12s %12s %12s %9s\n", "M", "K", "N", "epilogue",
+           "unfused ms", "fused ms", "speedup");
+
+    for (size_t s = 0; s < NUM_EPILOGUE_SHAPES; s++) {
+        size_t M = epilogue_shapes[s][0], K = epilogue_shapes[s][1], N = epilogue_shapes[s][2];
+
+        args_t args;
+        float* A  = bench_alloc_matrix(M, K, K, MMULT_ROW_MAJOR);
+        float* B  = bench_alloc_matrix(K, N, N, MMULT_ROW_MAJOR);
+        float* Ru = bench_alloc_matrix(M, N, N, MMULT_ROW_MAJOR);
+        float* Rf = bench_alloc_matrix(M, N, N, MMULT_ROW_MAJOR);
+        float* row_bias = bench_alloc_matrix(M, 1, 1, MMULT_ROW_MAJOR);
+        float* col_bias = bench_alloc_matrix(1, N, N, MMULT_ROW_MAJOR);
+
+        /* Entries of R average about 20 K; shift about half below zero */
+        for (size_t i = 0; i < M; i++) row_bias[i] = -4.5f * row_bias[i] * (float)K;
+        for (size_t j = 0; j < N; j++) col_bias[j] = -col_bias[j];
+
+        for (size_t e = 0; e < NUM_EPILOGUE_SETS; e++) {
+            mmult_epilogue_t epi = {
+                .ops = epilogue_sets[e].ops,
+                .row_bias = row_bias, .col_bias = col_bias,
+                .lo = 0.0f, .hi = 20.0f * (float)K, .scale = 1.0f / 64.0f,
+            };
+
+            double unfused = 0.0, fused = 0.0;
+            for (int r = 0; r < EPILOGUE_RUNS; r++) {
+                bench_setup_args(&args, M, K, N, MMULT_ROW_MAJOR, 0, A, B, Ru);
+                double t0 = bench_now();
+                impl_simd(&args);
+                epilogue_unfused(M, N, &epi, Ru);
+                double t = bench_now() - t0;
+                if (r == 0 || t < unfused) unfused = t;
+
+                args.output = Rf;
+                args.epilogue = &epi;
+                t0 = bench_now();
+                impl_simd(&args);
+                t = bench_now() - t0;
+                if (r == 0 || t < fused) fused = t;
+            }
+
+            float err = 0.0f;
+            for (size_t i = 0; i < M * N; i++) {
+                err = fmaxf(err, fabsf(Rf[i] - Ru[i]) / fmaxf(1.0f, fabsf(Ru[i])));
+            }
+            bool ok = err <= 1e-6f;
+            failures += !ok;
+
+            printf("%6zu %6zu %6zu  %-12s %12.3f %12.3f %8.2fx%s\n", M, K, N, epilogue_sets[e].name,
+                   unfused * 1e3, fused * 1e3, unfused / fused, ok ? "" : "  MISMATCH");
+        }
+
+        free(A); free(B); free(Ru); free(Rf);
+        free(row_bias); free(col_bias);
+    }
+
+    return failures == 0 ? 0 : 1;
+}
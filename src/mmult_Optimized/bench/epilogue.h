@@ -0,0 +1,10 @@
+#ifndef __BENCH_EPILOGUE_H_
+#define __BENCH_EPILOGUE_H_
+
+/* Fused vs unfused epilogues. For a few shapes and sets of
+ * operations, times the packed kernel with the epilogue fused into
+ * the micro-kernel against the plain product followed by one pass
+ * over R per operation, and checks both give the same R.            */
+int bench_epilogue(void);
+
+#endif //__BENCH_EPILOGUE_H_
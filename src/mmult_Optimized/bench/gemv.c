@@ -0,0 +1,213 @@
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <math.h>
+#include <string.h>
+#include <stdint.h>
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+/* Include common headers */
+#include "common/macros.h"
+#include "common/types.h"
+
+/* Include application-specific headers */
+#include "include/types.h"
+#include "impl/gemm.h"
+#include "impl/gemv.h"
+#include "bench/bench.h"
+#include "bench/gemv.h"
+
+/* M x K x N in eighths of the side D of a square operand (0 = a
+ * vector dimension of 1), op(A), op(B); every matrix operand, or the
+ * output of the rank-1 update, holds D x D floats                     */
+static const struct {
+    size_t M, K, N;
+    int transa, transb;
+    const char* name;
+} gemv_shapes[] = {
+    {  8,  8,  0, 0, 0, "A x"      },
+    {  8,  8,  0, 1, 0, "A^T x"    },
+    {  0,  8,  8, 0, 0, "x^T B"    },
+    {  0,  8,  8, 0, 1, "x^T B^T"  },
+    { 64,  1,  0, 0, 0, "tall A x" },
+    {  8,  0,  8, 0, 0, "a b^T"    },
+};
+#define NUM_GEMV_SHAPES (sizeof(gemv_shapes) / sizeof(gemv_shapes[0]))
+
+#define GEMV_RUNS 3
+
+/* Operands are at least this large, and GEMV_LLC_FACTOR x the LLC */
+#define GEMV_MIN_BYTES  ((size_t)256 << 20)
+#define GEMV_LLC_FACTOR 4
+
+/* Bytes of a buffer that no cache level can hold: GEMV_LLC_FACTOR x
+ * the largest cache reported, bounded by a quarter of the memory as
+ * the rank-1 shape keeps two outputs of that size alive.            */
+static size_t gemv_stream_bytes(size_t* llc) {
+    long c = sysconf(_SC_LEVEL3_CACHE_SIZE);
+    if (c <= 0) c = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    *llc = c > 0 ? (size_t)c : 0;
+
+    size_t bytes = *llc * GEMV_LLC_FACTOR;
+    if (bytes < GEMV_MIN_BYTES) bytes = GEMV_MIN_BYTES;
+
+    long pages = sysconf(_SC_PHYS_PAGES), page = sysconf(_SC_PAGESIZE);
+    if (pages > 0 && page > 0 && bytes > (size_t)pages * page / 4) {
+        bytes = (size_t)pages * page / 4;
+    }
+    return bytes;
+}
+
+/* Dimension of a shape entry for the square side d */
+static size_t gemv_dim(size_t eighths, size_t d) {
+    return eighths ? eighths * (d / 8) : 1;
+}
+
+/* Keeps the reference sums from being optimized away */
+static volatile float gemv_sink;
+
+typedef struct {
+    float* X;
+    size_t n;
+    float sum;
+} gemv_sum_t;
+
+static void* gemv_sum_worker(void* arg) {
+    gemv_sum_t* s = (gemv_sum_t*)arg;
+    float acc[64] = {0};
+    for (size_t i = 0; i + 64 <= s->n; i += 64) {
+        for (int l = 0; l < 64; l++) acc[l] += s->X[i + l];
+    }
+    for (int l = 0; l < 64; l++) s->sum += acc[l];
+    return NULL;
+}
+
+/* Streaming stores, as the rank-1 kernel writes large outputs */
+static void* gemv_fill_worker(void* arg) {
+    gemv_sum_t* s = (gemv_sum_t*)arg;
+    size_t i = 0;
+#if defined(__AVX__)
+    for (; i < s->n && ((uintptr_t)&s->X[i] & 31); i++) s->X[i] = 0.0f;
+    for (; i + 8 <= s->n; i += 8) _mm256_stream_ps(&s->X[i], _mm256_setzero_ps());
+    _mm_sfence();
+#endif
+    memset(&s->X[i], 0, (s->n - i) * sizeof(float));
+    return NULL;
+}
+
+/* GB/s of a plain read (or write) of n floats split over nthreads */
+static double stream_bandwidth(float* X, size_t n, int nthreads, int write) {
+    void* (*worker)(void*) = write ? gemv_fill_worker : gemv_sum_worker;
+    double best = 0.0;
+    for (int r = 0; r < GEMV_RUNS; r++) {
+        pthread_t tid[nthreads];
+        gemv_sum_t parts[nthreads];
+        double t0 = bench_now();
+        for (int t = 0; t < nthreads; t++) {
+            parts[t].X = X + n * t / nthreads;
+            parts[t].n = n * (t + 1) / nthreads - n * t / nthreads;
+            parts[t].sum = 0.0f;
+            if (t > 0) pthread_create(&tid[t], NULL, worker, &parts[t]);
+        }
+        worker(&parts[0]);
+        for (int t = 1; t < nthreads; t++) pthread_join(tid[t], NULL);
+        for (int t = 0; t < nthreads; t++) gemv_sink += parts[t].sum;
+        double gbs = n * sizeof(float) / (bench_now() - t0) * 1e-9;
+        if (gbs > best) best = gbs;
+    }
+    return best;
+}
+
+int bench_gemv(int nthreads) {
+    int failures = 0;
+
+    if (nthreads <= 0) nthreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (nthreads <= 0) nthreads = 1;
+
+    /* Side of a square operand of the streaming size, a multiple of 1024 */
+    size_t llc;
+    size_t stream = gemv_stream_bytes(&llc);
+    size_t d = (size_t)sqrt((double)stream / sizeof(float));
+    d = (d + 1023) / 1024 * 1024;
+
+    /* Reference bandwidth on a buffer as large as the operands */
+    size_t nref = d * d;
+    float* ref = bench_alloc_matrix(nref, 1, 1, MMULT_ROW_MAJOR);
+    double bw1 = stream_bandwidth(ref, nref, 1, 0);
+    double bwn = stream_bandwidth(ref, nref, nthreads, 0);
+    double wr1 = stream_bandwidth(ref, nref, 1, 1);
+    double wrn = stream_bandwidth(ref, nref, nthreads, 1);
+    free(ref);
+
+    printf("GEMV / rank-1 fast paths vs packed GEMM\n");
+    printf("Operands of %.0f MiB (LLC %.0f MiB)%s\n", nref * sizeof(float) / 1048576.0,
+           llc / 1048576.0, nref * sizeof(float) < llc * GEMV_LLC_FACTOR ? ", capped by memory" : "");
+    printf("Read bandwidth: %.2f GB/s (1 thread), %.2f GB/s (%d thread%s)\n", bw1, bwn, nthreads,
+           nthreads > 1 ? "s" : "");
+    printf("Write bandwidth: %.2f GB/s (1 thread), %.2f GB/s (%d thread%s)\n", wr1, wrn, nthreads,
+           nthreads > 1 ? "s" : "");
+    printf("%-9s %6s %6s %6s %12s %12s %7s %12s %7s\n", "shape", "M", "K", "N",
+           "packed GB/s", "fast GB/s", "of bw", "fast(n) GB/s", "of bw");
+
+    for (size_t s = 0; s < NUM_GEMV_SHAPES; s++) {
+        size_t M = gemv_dim(gemv_shapes[s].M, d);
+        size_t K = gemv_dim(gemv_shapes[s].K, d);
+        size_t N = gemv_dim(gemv_shapes[s].N, d);
+        int ta = gemv_shapes[s].transa, tb = gemv_shapes[s].transb;
+        size_t lda = ta ? M : K, ldb = tb ? K : N;
+
+        float* A  = bench_alloc_matrix(ta ? K : M, ta ? M : K, lda, MMULT_ROW_MAJOR);
+        float* B  = bench_alloc_matrix(tb ? N : K, tb ? K : N, ldb, MMULT_ROW_MAJOR);
+        float* Rp = bench_alloc_matrix(M, N, N, MMULT_ROW_MAJOR);
+        float* Rf = bench_alloc_matrix(M, N, N, MMULT_ROW_MAJOR);
+
+        /* Compulsory traffic: both operands read, R written once */
+        double bytes = (double)(M * K + K * N + M * N) * sizeof(float);
+        double t_packed = 0, t_fast = 0, t_fastn = 0;
+
+        /* Rank-1 updates mostly write: rate them against the write bandwidth */
+        int writes = M * N > M * K + K * N;
+        double ref1 = writes ? wr1 : bw1, refn = writes ? wrn : bwn;
+
+        for (int r = 0; r < GEMV_RUNS; r++) {
+            double t0, t;
+
+            t0 = bench_now();
+            gemm_sgemm_blocked(ta, tb, M, N, K, 1.0f, A, lda, B, ldb, 0.0f, Rp, N, NULL,
+                               gemm_select_blocking(M, N, K));
+            t = bench_now() - t0;
+            if (r == 0 || t < t_packed) t_packed = t;
+
+            t0 = bench_now();
+            gemv_dispatch(ta, tb, M, N, K, 1.0f, A, lda, B, ldb, 0.0f, Rf, N, NULL, 1);
+            t = bench_now() - t0;
+            if (r == 0 || t < t_fast) t_fast = t;
+
+            t0 = bench_now();
+            gemv_dispatch(ta, tb, M, N, K, 1.0f, A, lda, B, ldb, 0.0f, Rf, N, NULL, nthreads);
+            t = bench_now() - t0;
+            if (r == 0 || t < t_fastn) t_fastn = t;
+        }
+
+        /* Integer-valued inputs: both paths must agree exactly */
+        float diff = bench_max_abs_diff(Rp, Rf, M, N, N, MMULT_ROW_MAJOR);
+        if (diff != 0.0f) failures++;
+
+        printf("%-9s %6zu %6zu %6zu %12.2f %12.2f %6.0f%% %12.2f %6.0f%%%s\n",
+               gemv_shapes[s].name, M, K, N,
+               bytes / t_packed * 1e-9, bytes / t_fast * 1e-9, 100.0 * bytes / t_fast * 1e-9 / ref1,
+               bytes / t_fastn * 1e-9, 100.0 * bytes / t_fastn * 1e-9 / refn,
+               diff != 0.0f ? "  MISMATCH" : "");
+
+        free(A); free(B); free(Rp); free(Rf);
+    }
+
+    if (failures) {
+        printf("%d shape(s) disagree with the packed engine\n", failures);
+    }
+    return failures ? 1 : 0;
+}
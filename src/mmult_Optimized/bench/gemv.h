@@ -0,0 +1,13 @@
+#ifndef __BENCH_GEMV_H_
+#define __BENCH_GEMV_H_
+
+/* Matrix-vector (N == 1, M == 1, either storage of the matrix) and
+ * rank-1 (K == 1) shapes: the general packed engine against the fast
+ * paths on one and on nthreads threads (0 = all CPUs). Operands are
+ * sized to several times the last-level cache. Reports GB/s of
+ * compulsory traffic and its share of the read bandwidth of a plain
+ * multithreaded sum over a buffer of the same size (of the streaming
+ * write bandwidth for the write-bound rank-1 update).                */
+int bench_gemv(int nthreads);
+
+#endif //__BENCH_GEMV_H_
@@ -0,0 +1,147 @@
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+
+/* Include common headers */
+#include "common/macros.h"
+#include "common/types.h"
+
+/* Include application-specific headers */
+#include "include/types.h"
+#include "impl/mimd.h"
+#include "impl/igemm.h"
+#include "bench/bench.h"
+#include "bench/igemm.h"
+
+static const size_t igemm_sizes[] = { 256, 512, 1024, 2048 };
+#define NUM_IGEMM_SIZES (sizeof(igemm_sizes) / sizeof(igemm_sizes[0]))
+#define IGEMM_RUNS 3
+
+/* Magnitude bound of the wide data set: K * 2^22 passes 2^24 for any K > 4 */
+#define IGEMM_WIDE 2048
+
+/* Plain triple loop in int64, independent of the packed kernels */
+static void igemm_reference(size_t M, size_t N, size_t K,
+                            const int32_t* A, const int32_t* B, int64_t* C) {
+    for (size_t i = 0; i < M; i++) {
+        int64_t* c = &C[i * N];
+        memset(c, 0, N * sizeof(int64_t));
+        for (size_t p = 0; p < K; p++) {
+            int64_t a = A[i * K + p];
+            for (size_t j = 0; j < N; j++) c[j] += a * B[p * N + j];
+        }
+    }
+}
+
+/* int32 results must equal the reference modulo 2^32 */
+static int igemm_exact32(const int32_t* C, const int64_t* ref, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        if (C[i] != (int32_t)(uint32_t)ref[i]) return 0;
+    }
+    return 1;
+}
+
+#define IGEMM_TIME(best, call) do {                                       \
+    for (int __r = 0; __r < IGEMM_RUNS; __r++) {                          \
+        double __t0 = bench_now();                                        \
+        call;                                                             \
+        double __t = bench_now() - __t0;                                  \
+        if (__r == 0 || __t < (best)) (best) = __t;                       \
+    }                                                                     \
+} while (0)
+
+static int bench_igemm_shape(size_t M, size_t K, size_t N, int nthreads) {
+    int failures = 0;
+
+    int32_t* A   = __ALLOC_DATA(int32_t, M * K);
+    int32_t* B   = __ALLOC_DATA(int32_t, K * N);
+    int16_t* A16 = __ALLOC_DATA(int16_t, M * K);
+    int16_t* B16 = __ALLOC_DATA(int16_t, K * N);
+    int64_t* ref = __ALLOC_DATA(int64_t, M * N);
+    int32_t* C32 = __ALLOC_DATA(int32_t, M * N);
+    int64_t* C64 = __ALLOC_DATA(int64_t, M * N);
+    float*   Af  = __ALLOC_DATA(float, M * K);
+    float*   Bf  = __ALLOC_DATA(float, K * N);
+    float*   Rf  = __ALLOC_DATA(float, M * N);
+
+    printf("%5zu x %5zu x %5zu\n", M, K, N);
+
+    for (int wide = 0; wide < 2; wide++) {
+        /* The app's values first, then ones whose sums pass 2^24 */
+        for (size_t i = 0; i < M * K; i++) {
+            A[i] = wide ? rand() % (2 * IGEMM_WIDE) - IGEMM_WIDE : rand() % 10;
+        }
+        for (size_t i = 0; i < K * N; i++) {
+            B[i] = wide ? rand() % (2 * IGEMM_WIDE) - IGEMM_WIDE : rand() % 10;
+        }
+        for (size_t i = 0; i < M * K; i++) { A16[i] = (int16_t)A[i]; Af[i] = (float)A[i]; }
+        for (size_t i = 0; i < K * N; i++) { B16[i] = (int16_t)B[i]; Bf[i] = (float)B[i]; }
+        igemm_reference(M, N, K, A, B, ref);
+
+        printf("  %s\n", wide ? "values in [-2^11, 2^11):" : "values in [0, 10), as in the app:");
+
+        double t = 0.0;
+        args_t args;
+        bench_setup_args(&args, M, K, N, MMULT_ROW_MAJOR, 0, Af, Bf, Rf);
+        args.nthreads = nthreads;
+        IGEMM_TIME(t, impl_mimd(&args));
+        size_t wrong = 0;
+        double err = 0.0;
+        for (size_t i = 0; i < M * N; i++) {
+            double d = fabs((double)Rf[i] - (double)ref[i]);
+            if (d != 0.0) wrong++;
+            if (d > err) err = d;
+        }
+        printf("    %-18s %10.2f GOP/s  %zu inexact, max error %.0f\n", "float (mimd)",
+               bench_gflops(M, N, K, t), wrong, err);
+
+        IGEMM_TIME(t, igemm_s32s32s32(M, N, K, A, K, B, N, C32, N, nthreads));
+        int exact = igemm_exact32(C32, ref, M * N);
+        failures += !exact;
+        printf("    %-18s %10.2f GOP/s  %s\n", "int32 -> int32", bench_gflops(M, N, K, t),
+               exact ? "exact" : "MISMATCH");
+
+        IGEMM_TIME(t, igemm_s16s16s32(M, N, K, A16, K, B16, N, C32, N, nthreads));
+        exact = igemm_exact32(C32, ref, M * N);
+        failures += !exact;
+        printf("    %-18s %10.2f GOP/s  %s\n", "int16 -> int32", bench_gflops(M, N, K, t),
+               exact ? "exact" : "MISMATCH");
+
+        IGEMM_TIME(t, igemm_s32s32s64(M, N, K, A, K, B, N, C64, N, nthreads));
+        exact = memcmp(C64, ref, M * N * sizeof(int64_t)) == 0;
+        failures += !exact;
+        printf("    %-18s %10.2f GOP/s  %s\n", "int32 -> int64", bench_gflops(M, N, K, t),
+               exact ? "exact" : "MISMATCH");
+    }
+
+    free(A); free(B); free(A16); free(B16);
+    free(ref); free(C32); free(C64);
+    free(Af); free(Bf); free(Rf);
+    return failures;
+}
+
+int bench_igemm(size_t M, size_t K, size_t N, int nthreads) {
+    int failures = 0;
+
+    if (nthreads <= 0) nthreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (nthreads <= 0) nthreads = 1;
+
+    printf("Exact integer GEMM vs float, %d thread%s\n", nthreads, nthreads > 1 ? "s" : "");
+    if (M && K && N) {
+        failures += bench_igemm_shape(M, K, N, nthreads);
+    } else {
+        for (size_t s = 0; s < NUM_IGEMM_SIZES; s++) {
+            size_t n = igemm_sizes[s];
+            failures += bench_igemm_shape(n, n, n, nthreads);
+        }
+    }
+
+    if (failures > 0) {
+        printf("%d integer result(s) differ from the int64 reference.\n", failures);
+    }
+    return failures == 0 ? 0 : 1;
+}
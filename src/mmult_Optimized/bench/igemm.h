@@ -0,0 +1,15 @@
+#ifndef __BENCH_IGEMM_H_
+#define __BENCH_IGEMM_H_
+
+#include <stddef.h>
+
+/* Exact integer GEMM benchmark. For each square size (or the single
+ * M x K x N shape if all are non-zero), the int32, int16 and int64-
+ * accumulating kernels are timed against the float MIMD kernel on the
+ * same rand() % 10 values, on nthreads threads (0 = all CPUs), and
+ * checked bit for bit against an int64 reference. A second data set
+ * with values up to 2^11 in magnitude, whose sums pass 2^24, shows
+ * how many float results are no longer exact.                       */
+int bench_igemm(size_t M, size_t K, size_t N, int nthreads);
+
+#endif //__BENCH_IGEMM_H_
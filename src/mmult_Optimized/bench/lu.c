@@ -0,0 +1,143 @@
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include <unistd.h>
+
+/* Include common headers */
+#include "common/macros.h"
+
+/* Include application-specific headers */
+#include "impl/gemm.h"
+#include "impl/lu.h"
+#include "bench/bench.h"
+#include "bench/lu.h"
+
+static const size_t lu_sizes[] = { 256, 512, 1024, 2048, 4096, 8192 };
+#define NUM_LU_SIZES (sizeof(lu_sizes) / sizeof(lu_sizes[0]))
+
+/* PA - LU costs a full multiply, only checked up to this size */
+#define LU_CHECK_FACTORS_MAX 2048
+
+/* A scaled residual above this means the solve went wrong */
+#define LU_RESIDUAL_MAX 16.0
+
+/* ||PA - LU||_F / ||A||_F, with the L and U factors split out */
+static double lu_factor_residual(size_t n, const float* A, const float* LU, const size_t* ipiv) {
+    float* L  = __ALLOC_DATA(float, n * n);
+    float* U  = __ALLOC_DATA(float, n * n);
+    float* PA = __ALLOC_DATA(float, n * n);
+
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            float v = LU[i * n + j];
+            L[i * n + j] = (j < i) ? v : (j == i ? 1.0f : 0.0f);
+            U[i * n + j] = (j >= i) ? v : 0.0f;
+        }
+    }
+    memcpy(PA, A, n * n * sizeof(float));
+    for (size_t i = 0; i < n; i++) {
+        if (ipiv[i] != i) {
+            for (size_t j = 0; j < n; j++) {
+                float t = PA[i * n + j];
+                PA[i * n + j] = PA[ipiv[i] * n + j];
+                PA[ipiv[i] * n + j] = t;
+            }
+        }
+    }
+
+    /* PA = PA - L * U */
+    gemm_sgemm(0, 0, n, n, n, -1.0f, L, n, U, n, 1.0f, PA, n, NULL, NULL);
+
+    double num = 0.0, den = 0.0;
+    for (size_t i = 0; i < n * n; i++) {
+        num += (double)PA[i] * PA[i];
+        den += (double)A[i] * A[i];
+    }
+
+    free(L); free(U); free(PA);
+    return sqrt(num / den);
+}
+
+int bench_lu(const size_t* sizes, int nsizes, int nthreads) {
+    int failures = 0;
+
+    if (sizes == NULL) {
+        sizes = lu_sizes;
+        nsizes = NUM_LU_SIZES;
+    }
+    if (nthreads <= 0) nthreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (nthreads <= 0) nthreads = 1;
+
+    printf("Blocked LU with partial pivoting (panel %d), %d thread%s for the updates\n",
+           LU_NB, nthreads, nthreads > 1 ? "s" : "");
+    printf("%6s %12s %10s %12s %12s %12s %12s\n", "n", "factor (s)", "GFLOP/s", "solve (s)",
+           "scaled res", "fwd error", "||PA-LU||");
+
+    for (int s = 0; s < nsizes; s++) {
+        size_t n = sizes[s];
+
+        /* Uniform in [-1, 1]: well conditioned with high probability */
+        float* A  = __ALLOC_DATA(float, n * n);
+        float* LU = __ALLOC_DATA(float, n * n);
+        float* x  = __ALLOC_DATA(float, n);
+        float* b  = __ALLOC_DATA(float, n);
+        float* xt = __ALLOC_DATA(float, n);
+        size_t* ipiv = malloc(n * sizeof(size_t));
+
+        for (size_t i = 0; i < n * n; i++) A[i] = 2.0f * rand() / RAND_MAX - 1.0f;
+        for (size_t i = 0; i < n; i++) xt[i] = 2.0f * rand() / RAND_MAX - 1.0f;
+        for (size_t i = 0; i < n; i++) {
+            double acc = 0.0;
+            for (size_t j = 0; j < n; j++) acc += (double)A[i * n + j] * xt[j];
+            b[i] = (float)acc;
+        }
+        memcpy(LU, A, n * n * sizeof(float));
+        memcpy(x, b, n * sizeof(float));
+
+        double t0 = bench_now();
+        int info = lu_factor(n, LU, n, ipiv, 0, nthreads);
+        double t_factor = bench_now() - t0;
+
+        t0 = bench_now();
+        lu_solve(n, LU, n, ipiv, x);
+        double t_solve = bench_now() - t0;
+
+        /* Residuals in double */
+        double rnorm = 0.0, anorm = 0.0, xnorm = 0.0, bnorm = 0.0, ferr = 0.0, xtnorm = 0.0;
+        for (size_t i = 0; i < n; i++) {
+            double r = -(double)b[i], arow = 0.0;
+            for (size_t j = 0; j < n; j++) {
+                r += (double)A[i * n + j] * x[j];
+                arow += fabs(A[i * n + j]);
+            }
+            rnorm = fmax(rnorm, fabs(r));
+            anorm = fmax(anorm, arow);
+            xnorm = fmax(xnorm, fabs(x[i]));
+            bnorm = fmax(bnorm, fabs(b[i]));
+            ferr = fmax(ferr, fabs((double)x[i] - xt[i]));
+            xtnorm = fmax(xtnorm, fabs(xt[i]));
+        }
+        double scaled = rnorm / (FLT_EPSILON * (anorm * xnorm + bnorm) * n);
+
+        char fres[32] = "-";
+        if (n <= LU_CHECK_FACTORS_MAX) {
+            snprintf(fres, sizeof(fres), "%.2e", lu_factor_residual(n, A, LU, ipiv));
+        }
+
+        int bad = info != 0 || !(scaled < LU_RESIDUAL_MAX);
+        failures += bad;
+        printf("%6zu %12.4f %10.2f %12.6f %12.3f %12.2e %12s%s\n", n, t_factor,
+               2.0 / 3.0 * n * n * n / t_factor * 1e-9, t_solve, scaled, ferr / xtnorm, fres,
+               info != 0 ? "  SINGULAR" : (bad ? "  RESIDUAL" : ""));
+
+        free(A); free(LU); free(x); free(b); free(xt); free(ipiv);
+    }
+
+    if (failures) {
+        printf("%d size(s) failed (singular or residual above %.0f)\n", failures, LU_RESIDUAL_MAX);
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,15 @@
+#ifndef __BENCH_LU_H_
+#define __BENCH_LU_H_
+
+#include <stddef.h>
+
+/* Blocked LU with partial pivoting and the solver on random n x n
+ * systems (default sizes up to 8192), nthreads threads (0 = all CPUs)
+ * for the trailing updates. Reports the factorization GFLOP/s
+ * (2/3 n^3 flops), the solve time, the scaled residual
+ * ||Ax - b|| / (eps (||A|| ||x|| + ||b||) n) in the infinity norm, the
+ * forward error against the known solution and, up to n = 2048, the
+ * factorization residual ||PA - LU||_F / ||A||_F.                  */
+int bench_lu(const size_t* sizes, int nsizes, int nthreads);
+
+#endif //__BENCH_LU_H_
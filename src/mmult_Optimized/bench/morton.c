@@ -0,0 +1,119 @@
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/* Include application-specific headers */
+#include "include/types.h"
+#include "impl/opt.h"
+#include "impl/simd.h"
+#include "impl/morton.h"
+#include "bench/bench.h"
+#include "bench/morton.h"
+
+/* Powers of two and sizes just off them, where fixed blocks misalign */
+static const size_t morton_sizes[] = { 128, 200, 256, 384, 512, 700, 1024, 1500, 2048 };
+#define NUM_MORTON_SIZES (sizeof(morton_sizes) / sizeof(morton_sizes[0]))
+
+/* Best of a few runs for the small sizes, one run beyond */
+#define MORTON_RUNS(n) ((n) <= 512 ? 5 : 1)
+
+static void print_cache(const char* name, int key) {
+    long size = sysconf(key);
+    if (size > 0) {
+        printf("  %s %ld KiB", name, size >> 10);
+    } else {
+        printf("  %s unknown", name);
+    }
+}
+
+int bench_morton(const size_t* sizes, int nsizes) {
+    int failures = 0;
+
+    if (sizes == NULL) {
+        sizes = morton_sizes;
+        nsizes = NUM_MORTON_SIZES;
+    }
+
+    printf("Cache-oblivious Morton GEMM vs blocked (opt, block 16), single thread\n");
+    printf("Host caches:");
+    print_cache("L1d", _SC_LEVEL1_DCACHE_SIZE);
+    print_cache("L2", _SC_LEVEL2_CACHE_SIZE);
+    print_cache("L3", _SC_LEVEL3_CACHE_SIZE);
+    printf("\n");
+    printf("%6s %12s %12s %12s %9s %12s %9s\n", "n", "opt GF/s", "morton GF/s", "mult GF/s",
+           "convert", "simd GF/s", "speedup");
+
+    for (int s = 0; s < nsizes; s++) {
+        size_t n = sizes[s];
+        int runs = MORTON_RUNS(n);
+
+        args_t args;
+        float* A  = bench_alloc_matrix(n, n, n, MMULT_ROW_MAJOR);
+        float* B  = bench_alloc_matrix(n, n, n, MMULT_ROW_MAJOR);
+        float* Ro = bench_alloc_matrix(n, n, n, MMULT_ROW_MAJOR);
+        float* Rm = bench_alloc_matrix(n, n, n, MMULT_ROW_MAJOR);
+
+        double t_opt = 0, t_morton = 0, t_mult = 0, t_simd = 0;
+        for (int r = 0; r < runs; r++) {
+            double t0, t;
+
+            bench_setup_args(&args, n, n, n, MMULT_ROW_MAJOR, 0, A, B, Ro);
+            t0 = bench_now();
+            impl_scalar_opt(&args);
+            t = bench_now() - t0;
+            if (r == 0 || t < t_opt) t_opt = t;
+
+            bench_setup_args(&args, n, n, n, MMULT_ROW_MAJOR, 0, A, B, Rm);
+            t0 = bench_now();
+            impl_simd(&args);
+            t = bench_now() - t0;
+            if (r == 0 || t < t_simd) t_simd = t;
+
+            bench_setup_args(&args, n, n, n, MMULT_ROW_MAJOR, 0, A, B, Rm);
+            t0 = bench_now();
+            impl_morton(&args);
+            t = bench_now() - t0;
+            if (r == 0 || t < t_morton) t_morton = t;
+        }
+
+        /* Integer-valued inputs: every kernel must agree exactly */
+        float diff = bench_max_abs_diff(Ro, Rm, n, n, n, MMULT_ROW_MAJOR);
+
+        /* Same run with the operands already in Z-order: the multiply alone */
+        morton_t Am, Bm, Cm;
+        morton_alloc(&Am, n, n);
+        morton_alloc(&Bm, n, n);
+        morton_alloc(&Cm, n, n);
+        morton_from_row_major(&Am, A, n, 0, 1.0f);
+        morton_from_row_major(&Bm, B, n, 0, 1.0f);
+        for (int r = 0; r < runs; r++) {
+            morton_from_row_major(&Cm, NULL, n, 0, 0.0f);
+            double t0 = bench_now();
+            morton_gemm(&Cm, &Am, &Bm);
+            double t = bench_now() - t0;
+            if (r == 0 || t < t_mult) t_mult = t;
+        }
+        morton_to_row_major(&Cm, Rm, n, NULL);
+
+        float diff_mult = bench_max_abs_diff(Ro, Rm, n, n, n, MMULT_ROW_MAJOR);
+        if (diff_mult > diff) diff = diff_mult;
+        if (diff != 0.0f) failures++;
+
+        printf("%6zu %12.2f %12.2f %12.2f %8.1f%% %12.2f %8.2fx%s\n", n,
+               bench_gflops(n, n, n, t_opt), bench_gflops(n, n, n, t_morton),
+               bench_gflops(n, n, n, t_mult), 100.0 * (t_morton - t_mult) / t_morton,
+               bench_gflops(n, n, n, t_simd), t_opt / t_morton,
+               diff != 0.0f ? "  MISMATCH" : "");
+
+        morton_free(&Am);
+        morton_free(&Bm);
+        morton_free(&Cm);
+        free(A); free(B); free(Ro); free(Rm);
+    }
+
+    if (failures) {
+        printf("%d size(s) disagree with the blocked kernel\n", failures);
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,13 @@
+#ifndef __BENCH_MORTON_H_
+#define __BENCH_MORTON_H_
+
+#include <stddef.h>
+
+/* Cache-oblivious Z-order multiply vs the fixed-block kernel (opt) on
+ * square sizes, single-threaded. Prints the host's cache sizes so runs
+ * on different machines can be lined up, the Morton time split into
+ * layout conversion and multiply, and the packed SIMD kernel (tuned
+ * blocking) as a reference. sizes == NULL uses a default set.        */
+int bench_morton(const size_t* sizes, int nsizes);
+
+#endif //__BENCH_MORTON_H_
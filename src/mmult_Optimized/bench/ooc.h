@@ -0,0 +1,14 @@
+#ifndef __BENCH_OOC_H_
+#define __BENCH_OOC_H_
+
+#include <stddef.h>
+
+/* Out-of-core benchmark. Multiplies the matrix files a_path x b_path
+ * (generated as M x K and K x N random matrices when NULL) into
+ * Result/ooc_C.bin with at most mem_cap bytes of tile buffers, after
+ * dropping the inputs from the page cache. Reports the I/O-compute
+ * overlap and effective GFLOP/s, and spot-checks rows of the result. */
+int bench_ooc(size_t M, size_t K, size_t N, size_t mem_cap,
+              const char* a_path, const char* b_path);
+
+#endif //__BENCH_OOC_H_
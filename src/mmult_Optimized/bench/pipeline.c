@@ -0,0 +1,115 @@
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* Include common headers */
+#include "common/macros.h"
+#include "common/types.h"
+
+/* Include application-specific headers */
+#include "include/types.h"
+#include "impl/gemm.h"
+#include "impl/pipeline.h"
+#include "bench/bench.h"
+#include "bench/pipeline.h"
+
+/* One B panel, several panels per row of C, several K slices */
+static const size_t pipeline_sizes[] = { 256, 512, 1024, 2048, 3000 };
+#define NUM_PIPELINE_SIZES (sizeof(pipeline_sizes) / sizeof(pipeline_sizes[0]))
+
+#define PIPELINE_RUNS 5
+
+/* The blocked loop with every pack taken out: the first A block and B
+ * panel are packed once and reused by all blocks                   */
+static void compute_floor(size_t n, const float* A, const float* B, float* C,
+                          const gemm_blocking_t* blk, float* Ap, float* Bp) {
+    gemm_pack_a(blk->mc < n ? blk->mc : n, blk->kc < n ? blk->kc : n, A, n, 0, Ap);
+    gemm_pack_b(blk->kc < n ? blk->kc : n, blk->nc < n ? blk->nc : n, B, n, 0, Bp);
+
+    for (size_t jc = 0; jc < n; jc += blk->nc) {
+        size_t nc = (n - jc < blk->nc) ? n - jc : blk->nc;
+        for (size_t pc = 0; pc < n; pc += blk->kc) {
+            size_t kc = (n - pc < blk->kc) ? n - pc : blk->kc;
+            for (size_t ic = 0; ic < n; ic += blk->mc) {
+                size_t mc = (n - ic < blk->mc) ? n - ic : blk->mc;
+                gemm_macro_kernel(mc, nc, kc, Ap, Bp, &C[ic * n + jc], n,
+                                  1.0f, pc > 0 ? 1.0f : 0.0f, NULL);
+            }
+        }
+    }
+}
+
+int bench_pipeline(size_t size) {
+    int failures = 0;
+    const size_t* sizes = pipeline_sizes;
+    size_t nsizes = NUM_PIPELINE_SIZES;
+    long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+    if (size > 0) {
+        sizes = &size;
+        nsizes = 1;
+    }
+
+    printf("Packing overlapped with compute, single-threaded multiply, %ld CPU(s)\n", ncpus);
+    printf("Non-compute: time above the multiply on pre-packed operands\n");
+    printf("%6s %10s %12s %10s %12s %10s %12s %10s   %s\n", "n", "floor GF/s",
+           "serial GF/s", "non-comp", "interl GF/s", "non-comp", "thread GF/s", "non-comp",
+           "non-comp cut (interl / thread)");
+
+    for (size_t s = 0; s < nsizes; s++) {
+        size_t n = sizes[s];
+        const gemm_blocking_t* blk = gemm_select_blocking(n, n, n);
+
+        float* A   = bench_alloc_matrix(n, n, n, MMULT_ROW_MAJOR);
+        float* B   = bench_alloc_matrix(n, n, n, MMULT_ROW_MAJOR);
+        float* ref = bench_alloc_matrix(n, n, n, MMULT_ROW_MAJOR);
+        float* C   = bench_alloc_matrix(n, n, n, MMULT_ROW_MAJOR);
+        float* Ap  = __ALLOC_DATA(float, GEMM_ROUND_UP(blk->mc, GEMM_MR) * blk->kc);
+        float* Bp  = __ALLOC_DATA(float, GEMM_ROUND_UP(blk->nc, GEMM_NR) * blk->kc);
+
+        double t_floor = 0, t[GEMM_PIPE_NUM_MODES] = { 0 };
+        int bad = 0;
+        for (int r = 0; r < PIPELINE_RUNS; r++) {
+            double t0 = bench_now();
+            compute_floor(n, A, B, C, blk, Ap, Bp);
+            double dt = bench_now() - t0;
+            if (r == 0 || dt < t_floor) t_floor = dt;
+
+            for (int m = 0; m < GEMM_PIPE_NUM_MODES; m++) {
+                float* out = (m == GEMM_PIPE_SERIAL) ? ref : C;
+                t0 = bench_now();
+                gemm_sgemm_pipelined((gemm_pipe_mode_t)m, 0, 0, n, n, n, 1.0f, A, n, B, n,
+                                     0.0f, out, n, NULL, blk);
+                dt = bench_now() - t0;
+                if (r == 0 || dt < t[m]) t[m] = dt;
+                /* Same micro-kernels in the same order: bit-identical */
+                if (m != GEMM_PIPE_SERIAL) bad |= memcmp(C, ref, n * n * sizeof(float)) != 0;
+            }
+        }
+        if (bad) failures++;
+
+        printf("%6zu %10.2f", n, bench_gflops(n, n, n, t_floor));
+        for (int m = 0; m < GEMM_PIPE_NUM_MODES; m++) {
+            double over = t[m] - t_floor;
+            printf(" %12.2f %9.1f%%", bench_gflops(n, n, n, t[m]), 100.0 * over / t[m]);
+        }
+        /* Share of the serial non-compute time the pipelines remove */
+        double serial_over = t[GEMM_PIPE_SERIAL] - t_floor;
+        if (serial_over > 0) {
+            printf("   %4.0f%% / %4.0f%%",
+                   100.0 * (t[GEMM_PIPE_SERIAL] - t[GEMM_PIPE_INTERLEAVED]) / serial_over,
+                   100.0 * (t[GEMM_PIPE_SERIAL] - t[GEMM_PIPE_THREAD]) / serial_over);
+        }
+        printf("%s\n", bad ? "  MISMATCH" : "");
+
+        free(A); free(B); free(ref); free(C);
+        free(Ap); free(Bp);
+    }
+
+    if (failures) {
+        printf("%d size(s) disagree with serial packing\n", failures);
+    }
+    return failures ? 1 : 0;
+}
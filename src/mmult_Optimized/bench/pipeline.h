@@ -0,0 +1,14 @@
+#ifndef __BENCH_PIPELINE_H_
+#define __BENCH_PIPELINE_H_
+
+#include <stddef.h>
+
+/* Serial packing (the plain packed engine) against the interleaved and
+ * the helper-thread pipelines on square sizes (just `size` if it is
+ * nonzero), single-threaded multiply. The compute floor is the same
+ * sequence of macro-kernels on operands packed beforehand; everything
+ * above it is non-compute time, whose reduction against serial packing
+ * is reported. All results are checked against the serial one.       */
+int bench_pipeline(size_t size);
+
+#endif //__BENCH_PIPELINE_H_
@@ -0,0 +1,130 @@
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+
+/* Include common headers */
+#include "common/macros.h"
+#include "common/types.h"
+
+/* Include application-specific headers */
+#include "impl/gemm.h"
+#include "impl/qgemm.h"
+#include "bench/bench.h"
+#include "bench/qgemm.h"
+
+static const size_t qgemm_sizes[] = { 256, 512, 1024, 2048 };
+#define NUM_QGEMM_SIZES (sizeof(qgemm_sizes) / sizeof(qgemm_sizes[0]))
+#define QGEMM_RUNS 3
+
+/* The scalar kernel is only timed up to this many MACs */
+#define QGEMM_SCALAR_MAX_MACS (512.0 * 512.0 * 512.0)
+
+/* Plain triple loop, independent of the packed kernels */
+static void qgemm_reference(size_t M, size_t N, size_t K,
+                            const int8_t* A, const int8_t* B, int32_t* C) {
+    for (size_t i = 0; i < M; i++) {
+        int32_t* c = &C[i * N];
+        memset(c, 0, N * sizeof(int32_t));
+        for (size_t p = 0; p < K; p++) {
+            int32_t a = A[i * K + p];
+            for (size_t j = 0; j < N; j++) c[j] += a * B[p * N + j];
+        }
+    }
+}
+
+static int bench_qgemm_shape(size_t M, size_t K, size_t N) {
+    int failures = 0;
+
+    int8_t*  A   = __ALLOC_DATA(int8_t, M * K);
+    int8_t*  B   = __ALLOC_DATA(int8_t, K * N);
+    int32_t* ref = __ALLOC_DATA(int32_t, M * N);
+    int32_t* C   = __ALLOC_DATA(int32_t, M * N);
+    float*   Af  = __ALLOC_DATA(float, M * K);
+    float*   Bf  = __ALLOC_DATA(float, K * N);
+    float*   Rf  = __ALLOC_DATA(float, M * N);
+    float*   Rq  = __ALLOC_DATA(float, M * N);
+
+    for (size_t i = 0; i < M * K; i++) Af[i] = A[i] = (int8_t)(rand() % (2 * QGEMM_QMAX + 1) - QGEMM_QMAX);
+    for (size_t i = 0; i < K * N; i++) Bf[i] = B[i] = (int8_t)(rand() % (2 * QGEMM_QMAX + 1) - QGEMM_QMAX);
+
+    qgemm_reference(M, N, K, A, B, ref);
+
+    printf("%5zu x %5zu x %5zu\n", M, K, N);
+
+    /* Float packed kernel on the same values */
+    double best = 0.0;
+    for (int r = 0; r < QGEMM_RUNS; r++) {
+        double t0 = bench_now();
+        gemm_packed(M, N, K, Af, K, Bf, N, Rf, N, gemm_select_blocking(M, N, K));
+        double t = bench_now() - t0;
+        if (r == 0 || t < best) best = t;
+    }
+    printf("  %-22s %10.2f GOP/s\n", "float (packed)", bench_gflops(M, N, K, best));
+
+    /* Every int8 path this host can run */
+    qgemm_isa_t host = qgemm_detect_isa();
+    for (qgemm_isa_t isa = QGEMM_ISA_SCALAR; isa <= host; isa++) {
+        if (isa == QGEMM_ISA_SCALAR && (double)M * N * K > QGEMM_SCALAR_MAX_MACS) continue;
+
+        for (int r = 0; r < QGEMM_RUNS; r++) {
+            memset(C, 0, M * N * sizeof(int32_t));
+            double t0 = bench_now();
+            qgemm_s8s8s32(M, N, K, A, K, B, N, C, N, isa);
+            double t = bench_now() - t0;
+            if (r == 0 || t < best) best = t;
+        }
+
+        bool exact = memcmp(C, ref, M * N * sizeof(int32_t)) == 0;
+        failures += !exact;
+        printf("  %-22s %10.2f GOP/s  %s\n", qgemm_isa_name(isa), bench_gflops(M, N, K, best),
+               exact ? "exact" : "MISMATCH");
+    }
+
+    /* Quantized float path: per-row scales for A, per-column for B */
+    float* sa = __ALLOC_DATA(float, M);
+    float* sb = __ALLOC_DATA(float, N);
+    for (size_t i = 0; i < M * K; i++) Af[i] = (float)(rand() % 10);
+    for (size_t i = 0; i < K * N; i++) Bf[i] = (float)(rand() % 10);
+    gemm_packed(M, N, K, Af, K, Bf, N, Rf, N, NULL);
+
+    double t0 = bench_now();
+    qgemm_quantize_rows(M, K, Af, K, A, K, sa);
+    qgemm_quantize_cols(K, N, Bf, N, B, N, sb);
+    qgemm_s8s8s32(M, N, K, A, K, B, N, C, N, QGEMM_ISA_AUTO);
+    qgemm_dequantize(M, N, C, N, sa, sb, 1.0f, Rq, N);
+    double t = bench_now() - t0;
+
+    float err = 0.0f;
+    for (size_t i = 0; i < M * N; i++) {
+        err = fmaxf(err, fabsf(Rq[i] - Rf[i]) / fmaxf(1.0f, fabsf(Rf[i])));
+    }
+    printf("  %-22s %10.2f GOP/s  max rel. error %.2e\n", "quantized float", bench_gflops(M, N, K, t), err);
+
+    free(A); free(B); free(ref); free(C);
+    free(Af); free(Bf); free(Rf); free(Rq);
+    free(sa); free(sb);
+    return failures;
+}
+
+int bench_qgemm(size_t M, size_t K, size_t N) {
+    int failures = 0;
+
+    printf("int8 GEMM (int32 accumulation), host ISA: %s\n", qgemm_isa_name(qgemm_detect_isa()));
+    if (M && K && N) {
+        failures += bench_qgemm_shape(M, K, N);
+    } else {
+        for (size_t s = 0; s < NUM_QGEMM_SIZES; s++) {
+            size_t n = qgemm_sizes[s];
+            failures += bench_qgemm_shape(n, n, n);
+        }
+    }
+
+    if (failures > 0) {
+        printf("%d int8 result(s) differ from the integer reference.\n", failures);
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,13 @@
+#ifndef __BENCH_QGEMM_H_
+#define __BENCH_QGEMM_H_
+
+#include <stddef.h>
+
+/* int8 GEMM benchmark. For each square size (or the single M x K x N
+ * shape if all are non-zero) the int8 kernels are checked bit for bit
+ * against an integer reference and timed against the float packed
+ * kernel on the same values. The quantize -> int8 GEMM -> dequantize
+ * path is also timed, with its error against the float result.      */
+int bench_qgemm(size_t M, size_t K, size_t N);
+
+#endif //__BENCH_QGEMM_H_
@@ -0,0 +1,60 @@
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/* Include all implementations declarations */
+#include "impl/mimd.h"
+
+/* Include application-specific headers */
+#include "include/types.h"
+#include "bench/bench.h"
+#include "bench/scaling.h"
+
+/* Best of a few runs per thread count */
+#define SCALING_RUNS 3
+
+int bench_strong_scaling(size_t M, size_t K, size_t N, int max_threads, int cpu) {
+    if (max_threads <= 0) {
+        long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+        max_threads = ncpus > 0 ? (int)ncpus : 1;
+    }
+
+    args_t args;
+    bench_setup_args(&args, M, K, N, MMULT_ROW_MAJOR, 0, NULL, NULL, NULL);
+    args.cpu = cpu;
+
+    float* A = bench_alloc_matrix(M, K, args.lda, MMULT_ROW_MAJOR);
+    float* B = bench_alloc_matrix(K, N, args.ldb, MMULT_ROW_MAJOR);
+    float* R = bench_alloc_matrix(M, N, args.ldr, MMULT_ROW_MAJOR);
+    args.input0 = A;
+    args.input1 = B;
+    args.output = R;
+
+    printf("Strong scaling of impl_mimd on %zu x %zu x %zu\n", M, K, N);
+    printf("%8s %12s %10s %9s %11s\n", "threads", "time (s)", "GFLOP/s", "speedup", "efficiency");
+
+    double t1 = 0.0;
+    for (int t = 1; t <= max_threads; t = (t == max_threads) ? t + 1 :
+                                          (t * 2 < max_threads ? t * 2 : max_threads)) {
+        args.nthreads = t;
+
+        double best = 0.0;
+        for (int r = 0; r < SCALING_RUNS; r++) {
+            double t0 = bench_now();
+            impl_mimd(&args);
+            double elapsed = bench_now() - t0;
+            if (r == 0 || elapsed < best) best = elapsed;
+        }
+        if (t == 1) t1 = best;
+
+        double speedup = t1 / best;
+        printf("%8d %12.6f %10.2f %8.2fx %10.1f%%\n", t, best,
+               bench_gflops(M, N, K, best), speedup, 100.0 * speedup / t);
+    }
+
+    free(A);
+    free(B);
+    free(R);
+    return 0;
+}
@@ -0,0 +1,13 @@
+#ifndef __BENCH_SCALING_H_
+#define __BENCH_SCALING_H_
+
+#include <stddef.h>
+
+#include "include/types.h"
+
+/* Strong scaling of impl_mimd on a fixed M x K x N problem: runs with
+ * 1, 2, 4, ... threads up to max_threads (all online CPUs if <= 0) and
+ * reports GFLOP/s, speedup and parallel efficiency against 1 thread. */
+int bench_strong_scaling(size_t M, size_t K, size_t N, int max_threads, int cpu);
+
+#endif //__BENCH_SCALING_H_
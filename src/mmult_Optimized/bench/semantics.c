@@ -0,0 +1,128 @@
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+
+/* Include application-specific headers */
+#include "include/types.h"
+#include "include/layout.h"
+#include "bench/bench.h"
+#include "bench/semantics.h"
+
+static const struct {
+    float alpha, beta;
+    unsigned epilogue;
+} semantics_cases[] = {
+    {  1.0f, 0.0f, 0 },               // plain product
+    {  2.5f, 0.0f, 0 },               // scaled product
+    {  1.0f, 1.0f, 0 },               // accumulate
+    { -0.5f, 1.5f, 0 },               // general
+    {  0.0f, 2.0f, 0 },               // scale R only
+    {  1.0f, 0.0f, MMULT_EPI_ROW_BIAS | MMULT_EPI_RELU },
+    { -0.5f, 1.5f, MMULT_EPI_ALL },   // every fused operation
+    {  0.0f, 1.0f, MMULT_EPI_COL_BIAS | MMULT_EPI_CLAMP | MMULT_EPI_SCALE },
+};
+#define NUM_SEMANTICS_CASES (sizeof(semantics_cases) / sizeof(semantics_cases[0]))
+
+#define SEMANTICS_PAD 3
+
+/* Relative to the magnitude of the reference */
+#define SEMANTICS_TOLERANCE 1e-5f
+
+static float semantics_error(const float* X, const float* ref, size_t M, size_t N,
+                             size_t ld, mmult_layout_t layout) {
+    float err = 0.0f;
+    for (size_t i = 0; i < M; i++) {
+        for (size_t j = 0; j < N; j++) {
+            size_t idx = mmult_index(layout, i, j, ld);
+            float e = fabsf(X[idx] - ref[idx]) / fmaxf(1.0f, fabsf(ref[idx]));
+            if (!(e <= err)) err = e;   /* Keeps NaN */
+        }
+    }
+    return err;
+}
+
+int bench_gemm_semantics(size_t M, size_t K, size_t N, int nthreads) {
+    int failures = 0, checks = 0;
+
+    printf("GEMM semantics check, %zu x %zu x %zu, leading dimension padding = %d\n",
+           M, K, N, SEMANTICS_PAD);
+
+    for (int l = 0; l < 2; l++) {
+        mmult_layout_t layout = l ? MMULT_COL_MAJOR : MMULT_ROW_MAJOR;
+        for (int ta = 0; ta < 2; ta++) {
+            for (int tb = 0; tb < 2; tb++) {
+                args_t args;
+                bench_setup_args(&args, M, K, N, layout, SEMANTICS_PAD, NULL, NULL, NULL);
+                bench_set_transpose(&args, ta ? MMULT_TRANS : MMULT_NO_TRANS,
+                                    tb ? MMULT_TRANS : MMULT_NO_TRANS, SEMANTICS_PAD);
+                args.nthreads = nthreads;
+
+                /* Stored shapes of the operands */
+                float* A  = ta ? bench_alloc_matrix(K, M, args.lda, layout)
+                               : bench_alloc_matrix(M, K, args.lda, layout);
+                float* B  = tb ? bench_alloc_matrix(N, K, args.ldb, layout)
+                               : bench_alloc_matrix(K, N, args.ldb, layout);
+                float* R0 = bench_alloc_matrix(M, N, args.ldr, layout);
+                float* ref = bench_alloc_matrix(M, N, args.ldr, layout);
+                float* R  = bench_alloc_matrix(M, N, args.ldr, layout);
+                float* Rn = bench_alloc_matrix(M, N, args.ldr, layout);
+                size_t relems = bench_matrix_elems(M, N, args.ldr, layout);
+                size_t rbytes = relems * sizeof(float);
+
+                /* R must not be read at all when beta is zero */
+                for (size_t i = 0; i < relems; i++) Rn[i] = NAN;
+                args.input0 = A;
+                args.input1 = B;
+
+                /* Biases with both signs so ReLU and the clamp bite */
+                float* row_bias = bench_alloc_matrix(M, 1, 1, MMULT_ROW_MAJOR);
+                float* col_bias = bench_alloc_matrix(1, N, N, MMULT_ROW_MAJOR);
+                for (size_t i = 0; i < M; i++) row_bias[i] = -40.0f * row_bias[i];
+                for (size_t j = 0; j < N; j++) col_bias[j] = 3.0f * col_bias[j] - 10.0f;
+
+                for (size_t s = 0; s < NUM_SEMANTICS_CASES; s++) {
+                    mmult_epilogue_t epi = {
+                        .ops = semantics_cases[s].epilogue,
+                        .row_bias = row_bias, .col_bias = col_bias,
+                        .lo = -50.0f, .hi = 1500.0f, .scale = 0.25f,
+                    };
+                    args.alpha = semantics_cases[s].alpha;
+                    args.beta  = semantics_cases[s].beta;
+                    args.epilogue = epi.ops ? &epi : NULL;
+
+                    const float* init = args.beta == 0.0f ? Rn : R0;
+
+                    memcpy(ref, init, rbytes);
+                    args.output = ref;
+                    bench_impls[0].fn(&args);
+
+                    printf("%s-major op(A)=%s op(B)=%s alpha=%5.2f beta=%5.2f epilogue=0x%02x:",
+                           layout == MMULT_COL_MAJOR ? "col" : "row", ta ? "A^T" : "A  ",
+                           tb ? "B^T" : "B  ", args.alpha, args.beta, epi.ops);
+
+                    for (int i = 1; i < bench_num_impls; i++) {
+                        memcpy(R, init, rbytes);
+                        args.output = R;
+                        bench_impls[i].fn(&args);
+
+                        float err = semantics_error(R, ref, M, N, args.ldr, layout);
+                        bool ok = err <= SEMANTICS_TOLERANCE;
+                        printf(" %s %s", bench_impls[i].name, ok ? "ok" : "FAIL");
+                        failures += !ok;
+                        checks++;
+                    }
+                    printf("\n");
+                }
+
+                free(A); free(B); free(R0); free(ref); free(R); free(Rn);
+                free(row_bias); free(col_bias);
+            }
+        }
+    }
+
+    printf("%d of %d checks passed\n", checks - failures, checks);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,14 @@
+#ifndef __BENCH_SEMANTICS_H_
+#define __BENCH_SEMANTICS_H_
+
+#include <stddef.h>
+
+/* Check every implementation against the naive kernel for all
+ * combinations of layout, transA, transB and a set of alpha/beta
+ * pairs and fused epilogues on an M x K x N product with padded
+ * leading dimensions.
+ * With beta == 0 the incoming R is filled with NaN to make sure it
+ * is never read. Returns 0 when everything matches.                 */
+int bench_gemm_semantics(size_t M, size_t K, size_t N, int nthreads);
+
+#endif //__BENCH_SEMANTICS_H_
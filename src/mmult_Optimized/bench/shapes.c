@@ -0,0 +1,83 @@
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Include application-specific headers */
+#include "include/types.h"
+#include "impl/gemm.h"
+#include "bench/bench.h"
+#include "bench/shapes.h"
+
+/* Shapes we actually run, M x K x N */
+static const size_t sweep_shapes[][3] = {
+    {  512,  512,  512 },   // square
+    { 1000,  999, 1001 },   // square, ragged edges
+    { 8192,  256,   64 },   // tall-skinny
+    {   64,  256, 8192 },   // short-wide
+    { 2048,   32, 2048 },   // small K
+    {   96, 4096,   96 },   // deep K
+};
+#define NUM_SWEEP_SHAPES (sizeof(sweep_shapes) / sizeof(sweep_shapes[0]))
+
+/* Best of a few runs, to keep the sweep short but stable */
+#define SWEEP_RUNS 3
+
+int bench_shape_sweep(mmult_layout_t layout, size_t pad, int nthreads) {
+    int failures = 0;
+
+    printf("Shape sweep (%s-major, leading dimension padding = %zu)\n",
+           layout == MMULT_COL_MAJOR ? "column" : "row", pad);
+    printf("%6s %6s %6s  %-12s", "M", "K", "N", "class");
+    for (int i = 0; i < bench_num_impls; i++) {
+        printf(" %12s", bench_impls[i].label);
+    }
+    printf("   (GFLOP/s)\n");
+
+    for (size_t s = 0; s < NUM_SWEEP_SHAPES; s++) {
+        size_t M = sweep_shapes[s][0], K = sweep_shapes[s][1], N = sweep_shapes[s][2];
+
+        args_t args;
+        bench_setup_args(&args, M, K, N, layout, pad, NULL, NULL, NULL);
+        args.nthreads = nthreads;
+
+        float* A   = bench_alloc_matrix(M, K, args.lda, layout);
+        float* B   = bench_alloc_matrix(K, N, args.ldb, layout);
+        float* ref = bench_alloc_matrix(M, N, args.ldr, layout);
+        float* R   = bench_alloc_matrix(M, N, args.ldr, layout);
+        args.input0 = A;
+        args.input1 = B;
+
+        /* The first entry is the naive kernel, our reference */
+        args.output = ref;
+        bench_impls[0].fn(&args);
+
+        printf("%6zu %6zu %6zu  %-12s", M, K, N,
+               gemm_shape_name(gemm_classify_shape(M, N, K)));
+
+        args.output = R;
+        for (int i = 0; i < bench_num_impls; i++) {
+            double best = 0.0;
+            for (int r = 0; r < SWEEP_RUNS; r++) {
+                double t0 = bench_now();
+                bench_impls[i].fn(&args);
+                double t = bench_now() - t0;
+                if (r == 0 || t < best) best = t;
+            }
+
+            float diff = bench_max_abs_diff(ref, R, M, N, args.ldr, layout);
+            printf(" %11.2f%c", bench_gflops(M, N, K, best), diff == 0.0f ? ' ' : '!');
+            failures += diff != 0.0f;
+        }
+        printf("\n");
+
+        free(A);
+        free(B);
+        free(ref);
+        free(R);
+    }
+
+    if (failures > 0) {
+        printf("%d result(s) marked with '!' do not match the naive kernel.\n", failures);
+    }
+    return failures == 0 ? 0 : 1;
+}
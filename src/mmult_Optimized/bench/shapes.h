@@ -0,0 +1,13 @@
+#ifndef __BENCH_SHAPES_H_
+#define __BENCH_SHAPES_H_
+
+#include <stddef.h>
+
+#include "include/types.h"
+
+/* Run every implementation over a fixed set of square, tall-skinny,
+ * short-wide and small-K shapes, checking each result against the
+ * naive kernel and reporting GFLOP/s. Returns 0 if all results match. */
+int bench_shape_sweep(mmult_layout_t layout, size_t pad, int nthreads);
+
+#endif //__BENCH_SHAPES_H_
@@ -0,0 +1,145 @@
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+
+/* Include common headers */
+#include "common/macros.h"
+#include "common/types.h"
+
+/* Include application-specific headers */
+#include "include/types.h"
+#include "impl/mimd.h"
+#include "impl/sparse.h"
+#include "bench/bench.h"
+#include "bench/sparse.h"
+
+#define SPARSE_RUNS 3
+
+/* Random M x K matrix with about `density * M * K` non-zeros in 1..9 */
+static float* sparse_alloc_matrix(size_t M, size_t K, double density) {
+    float* X = __ALLOC_DATA(float, M * K);
+    for (size_t i = 0; i < M * K; i++) {
+        X[i] = ((double)rand() / RAND_MAX < density) ? (float)(rand() % 9 + 1) : 0.0f;
+    }
+    return X;
+}
+
+/* Bytes a CSR product has to touch: the matrix once, every B row it
+ * references (at most all of B), and the output                      */
+static double sparse_bytes(const csr_t* A, size_t N) {
+    double matrix = A->nnz * (sizeof(float) + sizeof(uint32_t)) + (A->rows + 1) * sizeof(size_t);
+    double b = fmin((double)A->nnz, (double)A->cols) * N * sizeof(float);
+    return matrix + b + (double)A->rows * N * sizeof(float);
+}
+
+static double dense_bytes(size_t M, size_t K, size_t N) {
+    return ((double)M * K + (double)K * N + (double)M * N) * sizeof(float);
+}
+
+/* Best of SPARSE_RUNS dense products through impl_mimd */
+static double time_dense(size_t M, size_t K, size_t N, float* A, float* B, float* R, int nthreads) {
+    args_t args;
+    bench_setup_args(&args, M, K, N, MMULT_ROW_MAJOR, 0, A, B, R);
+    args.nthreads = nthreads;
+
+    double best = 0.0;
+    for (int r = 0; r < SPARSE_RUNS; r++) {
+        double t0 = bench_now();
+        impl_mimd(&args);
+        double t = bench_now() - t0;
+        if (r == 0 || t < best) best = t;
+    }
+    return best;
+}
+
+static void print_row(const char* op, const char* path, double flops, double bytes, double t) {
+    printf("  %-5s %-6s %10.3f ms %10.2f GFLOP/s %8.2f GB/s\n",
+           op, path, t * 1e3, flops / t / 1e9, bytes / t / 1e9);
+}
+
+int bench_sparse(size_t M, size_t K, size_t N, const double* densities,
+                 int ndensities, int nthreads) {
+    int failures = 0;
+    if (nthreads <= 0) nthreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+
+    float* B  = bench_alloc_matrix(K, N, N, MMULT_ROW_MAJOR);
+    float* x  = bench_alloc_matrix(K, 1, 1, MMULT_ROW_MAJOR);
+    float* R  = __ALLOC_DATA(float, M * N);
+    float* Rs = __ALLOC_DATA(float, M * N);
+    float* y  = __ALLOC_DATA(float, M);
+    float* ys = __ALLOC_DATA(float, M);
+
+    printf("Sparse (CSR) vs dense, %zu x %zu x %zu, %d thread(s)\n", M, K, N, nthreads);
+
+    double mm_crossover = -1.0, mv_crossover = -1.0;
+    for (int d = 0; d < ndensities; d++) {
+        double density = densities[d];
+        float* A = sparse_alloc_matrix(M, K, density);
+
+        csr_t csr;
+        double t0 = bench_now();
+        if (csr_from_dense(&csr, M, K, A, K) != 0) {
+            fprintf(stderr, "Failed to allocate the CSR matrix\n");
+            free(A);
+            failures++;
+            break;
+        }
+        double convert = bench_now() - t0;
+
+        printf("density %.4f: %zu non-zeros, conversion %.3f ms\n", density, csr.nnz, convert * 1e3);
+
+        /* SpMM: useful flops only for the sparse side */
+        double t_dense = time_dense(M, K, N, A, B, R, nthreads);
+        double t_sparse = 0.0;
+        for (int r = 0; r < SPARSE_RUNS; r++) {
+            t0 = bench_now();
+            csr_spmm(&csr, N, B, N, Rs, N, nthreads);
+            double t = bench_now() - t0;
+            if (r == 0 || t < t_sparse) t_sparse = t;
+        }
+        print_row("SpMM", "dense", 2.0 * M * N * K, dense_bytes(M, K, N), t_dense);
+        print_row("SpMM", "CSR", 2.0 * csr.nnz * N, sparse_bytes(&csr, N), t_sparse);
+        if (memcmp(R, Rs, M * N * sizeof(float)) != 0) {
+            printf("  SpMM result differs from the dense product!\n");
+            failures++;
+        }
+        if (t_sparse < t_dense && density > mm_crossover) mm_crossover = density;
+
+        /* SpMV */
+        t_dense = time_dense(M, K, 1, A, x, y, nthreads);
+        for (int r = 0; r < SPARSE_RUNS; r++) {
+            t0 = bench_now();
+            csr_spmv(&csr, x, ys, nthreads);
+            double t = bench_now() - t0;
+            if (r == 0 || t < t_sparse) t_sparse = t;
+        }
+        print_row("SpMV", "dense", 2.0 * M * K, dense_bytes(M, K, 1), t_dense);
+        print_row("SpMV", "CSR", 2.0 * csr.nnz, sparse_bytes(&csr, 1), t_sparse);
+        if (memcmp(y, ys, M * sizeof(float)) != 0) {
+            printf("  SpMV result differs from the dense product!\n");
+            failures++;
+        }
+        if (t_sparse < t_dense && density > mv_crossover) mv_crossover = density;
+
+        csr_free(&csr);
+        free(A);
+    }
+
+    if (mm_crossover >= 0.0) {
+        printf("SpMM: CSR is faster up to density %.4f\n", mm_crossover);
+    } else {
+        printf("SpMM: dense is faster at every density tried\n");
+    }
+    if (mv_crossover >= 0.0) {
+        printf("SpMV: CSR is faster up to density %.4f\n", mv_crossover);
+    } else {
+        printf("SpMV: dense is faster at every density tried\n");
+    }
+
+    free(B); free(x); free(R); free(Rs); free(y); free(ys);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,14 @@
+#ifndef __BENCH_SPARSE_H_
+#define __BENCH_SPARSE_H_
+
+#include <stddef.h>
+
+/* Sparse vs dense benchmark. For every density (fraction of non-zeros
+ * in A) a random M x K matrix is multiplied by a dense K x N matrix and
+ * by a K-vector, once through CSR SpMM/SpMV and once through the dense
+ * multithreaded path. Prints useful GFLOP/s, effective GB/s and which
+ * side wins, so the density crossover can be read off the table.     */
+int bench_sparse(size_t M, size_t K, size_t N, const double* densities,
+                 int ndensities, int nthreads);
+
+#endif //__BENCH_SPARSE_H_
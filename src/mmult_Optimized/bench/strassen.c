@@ -0,0 +1,110 @@
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+/* Include common headers */
+#include "common/macros.h"
+#include "common/types.h"
+
+/* Include application-specific headers */
+#include "impl/gemm.h"
+#include "impl/strassen.h"
+#include "bench/bench.h"
+#include "bench/strassen.h"
+
+/* Entries of C checked against the double-precision reference */
+#define STRASSEN_ERROR_SAMPLES 256
+#define STRASSEN_RUNS 3
+
+static float uniform(void) {
+    return 2.0f * ((float)rand() / RAND_MAX) - 1.0f;
+}
+
+/* Largest |C - ref| / (|A| |B|)_ij over sampled entries, where the
+ * denominator is the sum of |a_ik b_kj| (the scale of the dot product) */
+static double sampled_error(size_t n, const float* A, const float* B, const float* C,
+                            const size_t* rows, const size_t* cols) {
+    double worst = 0.0;
+    for (int s = 0; s < STRASSEN_ERROR_SAMPLES; s++) {
+        size_t i = rows[s], j = cols[s];
+        double ref = 0.0, scale = 0.0;
+        for (size_t k = 0; k < n; k++) {
+            ref   += (double)A[i * n + k] * B[k * n + j];
+            scale += fabs((double)A[i * n + k] * B[k * n + j]);
+        }
+        double err = fabs(C[i * n + j] - ref) / (scale > 0 ? scale : 1.0);
+        if (err > worst) worst = err;
+    }
+    return worst;
+}
+
+int bench_strassen(size_t max_size, size_t cutoff) {
+    if (cutoff == 0) cutoff = STRASSEN_DEFAULT_CUTOFF;
+
+    printf("Strassen-Winograd vs classical packed GEMM (cutoff = %zu)\n", cutoff);
+    printf("%6s %6s %12s %12s %9s %12s %12s\n", "n", "levels", "classical(s)", "strassen(s)",
+           "speedup", "err(class.)", "err(strass.)");
+
+    size_t crossover = 0;
+    size_t rows[STRASSEN_ERROR_SAMPLES], cols[STRASSEN_ERROR_SAMPLES];
+
+    for (size_t base = 256; base <= max_size; base *= 2) {
+        for (size_t n = base; n <= base + 1; n++) {
+            float* A  = __ALLOC_DATA(float, n * n);
+            float* B  = __ALLOC_DATA(float, n * n);
+            float* Cc = __ALLOC_DATA(float, n * n);
+            float* Cs = __ALLOC_DATA(float, n * n);
+            for (size_t i = 0; i < n * n; i++) {
+                A[i] = uniform();
+                B[i] = uniform();
+            }
+
+            size_t ws_size = strassen_workspace_size(n, n, n, cutoff);
+            float* ws = ws_size ? __ALLOC_DATA(float, ws_size) : NULL;
+
+            int levels = 0;
+            for (size_t m = n; m > cutoff && m >= 2; m /= 2) levels++;
+
+            double tc = 0.0, ts = 0.0;
+            for (int r = 0; r < STRASSEN_RUNS; r++) {
+                double t0 = bench_now();
+                gemm_packed(n, n, n, A, n, B, n, Cc, n, NULL);
+                double t1 = bench_now();
+                strassen_gemm(n, n, n, A, n, B, n, Cs, n, cutoff, ws);
+                double t2 = bench_now();
+                if (r == 0 || t1 - t0 < tc) tc = t1 - t0;
+                if (r == 0 || t2 - t1 < ts) ts = t2 - t1;
+            }
+
+            for (int s = 0; s < STRASSEN_ERROR_SAMPLES; s++) {
+                rows[s] = rand() % n;
+                cols[s] = rand() % n;
+            }
+
+            printf("%6zu %6d %12.6f %12.6f %8.2fx %12.3e %12.3e\n", n, levels, tc, ts, tc / ts,
+                   sampled_error(n, A, B, Cc, rows, cols),
+                   sampled_error(n, A, B, Cs, rows, cols));
+
+            /* Smallest size from which Strassen stays ahead */
+            if (levels > 0 && ts < tc) {
+                if (crossover == 0) crossover = n;
+            } else {
+                crossover = 0;
+            }
+
+            free(A);
+            free(B);
+            free(Cc);
+            free(Cs);
+            free(ws);
+        }
+    }
+
+    if (crossover) {
+        printf("Crossover: Strassen is faster from n = %zu\n", crossover);
+    } else {
+        printf("Crossover: Strassen was not faster up to n = %zu\n", max_size + 1);
+    }
+    return 0;
+}
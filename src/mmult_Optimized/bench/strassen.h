@@ -0,0 +1,13 @@
+#ifndef __BENCH_STRASSEN_H_
+#define __BENCH_STRASSEN_H_
+
+#include <stddef.h>
+
+/* Compare Strassen-Winograd against the classical packed kernel on
+ * square sizes from 256 up to max_size (doubling, plus an odd size per
+ * step). Reports runtimes, the crossover size, and the largest
+ * relative error of both against a double-precision reference on
+ * sampled entries of a product of uniform [-1, 1) inputs.            */
+int bench_strassen(size_t max_size, size_t cutoff);
+
+#endif //__BENCH_STRASSEN_H_
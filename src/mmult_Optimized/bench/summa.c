@@ -0,0 +1,101 @@
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/* Include common headers */
+#include "common/macros.h"
+
+/* Include application-specific headers */
+#include "impl/gemm.h"
+#include "dist/summa.h"
+#include "bench/bench.h"
+#include "bench/summa.h"
+
+/* Best of a few runs per process count */
+#define SUMMA_RUNS 3
+
+static const char* const transport_names[] = { "shm", "unix", "tcp" };
+
+/* Squarest pr x pc grid with pr <= pc */
+static int summa_grid_rows(int P) {
+    int pr = 1;
+    for (int d = 1; d * d <= P; d++) {
+        if (P % d == 0) pr = d;
+    }
+    return pr;
+}
+
+int bench_summa(const int* procs, int nprocs, size_t M, size_t K, size_t N,
+                dist_transport_kind_t transport, int cpu) {
+    int failures = 0;
+    long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (ncpus <= 0) ncpus = 1;
+
+    /* Reference: the same operands through the packed GEMM in one process */
+    float* A   = __ALLOC_DATA(float, M * K);
+    float* B   = __ALLOC_DATA(float, K * N);
+    float* ref = __ALLOC_DATA(float, M * N);
+    float* C   = __ALLOC_DATA(float, M * N);
+    for (size_t i = 0; i < M; i++) {
+        for (size_t k = 0; k < K; k++) A[i * K + k] = summa_a(i, k);
+    }
+    for (size_t k = 0; k < K; k++) {
+        for (size_t j = 0; j < N; j++) B[k * N + j] = summa_b(k, j);
+    }
+
+    double t1 = 0.0;
+    for (int r = 0; r < SUMMA_RUNS; r++) {
+        double t0 = bench_now();
+        gemm_sgemm(0, 0, M, N, K, 1.0f, A, K, B, N, 0.0f, ref, N, NULL, NULL);
+        double t = bench_now() - t0;
+        if (r == 0 || t < t1) t1 = t;
+    }
+    free(A);
+    free(B);
+
+    printf("SUMMA on %zu x %zu x %zu over %s, K panels of %d, %ld CPU(s)\n", M, K, N,
+           transport_names[transport], SUMMA_KB, ncpus);
+    printf("Baseline: packed GEMM in one process, %.6f s, %.2f GFLOP/s\n", t1, bench_gflops(M, N, K, t1));
+    printf("%6s %7s %7s %12s %10s %9s %11s %7s\n", "procs", "grid", "panels", "time (s)", "GFLOP/s",
+           "speedup", "efficiency", "wait");
+
+    for (int p = 0; p < nprocs; p++) {
+        int P = procs[p];
+        summa_config_t cfg = { .M = M, .K = K, .N = N, .pr = summa_grid_rows(P),
+                               .transport = transport, .cpu = cpu };
+        cfg.pc = P / cfg.pr;
+
+        summa_result_t best = { 0 };
+        int ok = 1;
+        for (int r = 0; r < SUMMA_RUNS && ok; r++) {
+            summa_result_t res;
+            if (summa_run(&cfg, C, &res) != 0) {
+                ok = 0;
+            } else if (bench_max_abs_diff(ref, C, M, N, N, MMULT_ROW_MAJOR) != 0.0f) {
+                ok = 0;
+            } else if (r == 0 || res.seconds < best.seconds) {
+                best = res;
+            }
+        }
+
+        char grid[32];
+        snprintf(grid, sizeof(grid), "%dx%d", cfg.pr, cfg.pc);
+        if (!ok) {
+            printf("%6d %7s  FAILED\n", P, grid);
+            failures++;
+            continue;
+        }
+        double speedup = t1 / best.seconds;
+        printf("%6d %7s %7zu %12.6f %10.2f %8.2fx %10.1f%% %6.1f%%%s\n", P, grid, best.steps,
+               best.seconds, bench_gflops(M, N, K, best.seconds), speedup, 100.0 * speedup / P,
+               100.0 * best.wait, P > ncpus ? "  (oversubscribed)" : "");
+    }
+
+    free(ref);
+    free(C);
+    if (failures) {
+        printf("%d process count(s) failed or disagree with the packed GEMM\n", failures);
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,16 @@
+#ifndef __BENCH_SUMMA_H_
+#define __BENCH_SUMMA_H_
+
+#include <stddef.h>
+
+#include "dist/transport.h"
+
+/* SUMMA on an M x K x N product for every process count in procs,
+ * each on the squarest grid it allows, over the given transport. The
+ * single-process packed GEMM is the baseline of the speedup and the
+ * scaling efficiency, and its result checks every run exactly. Also
+ * reports the share of the run the multiply spent waiting for panels. */
+int bench_summa(const int* procs, int nprocs, size_t M, size_t K, size_t N,
+                dist_transport_kind_t transport, int cpu);
+
+#endif //__BENCH_SUMMA_H_
@@ -0,0 +1,187 @@
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+/* Include common headers */
+#include "common/macros.h"
+#include "common/types.h"
+
+/* Include application-specific headers */
+#include "include/types.h"
+#include "bench/bench.h"
+#include "bench/sweep.h"
+
+int bench_parse_sizes(const char* spec, size_t* sizes, int max) {
+    char op = 0;
+    unsigned long long lo, hi, step;
+    int n = 0;
+
+    /* Range: lo:hi:xF or lo:hi:+S */
+    if (sscanf(spec, "%llu:%llu:%c%llu", &lo, &hi, &op, &step) == 4) {
+        if (lo == 0 || lo > hi || step == 0 || (op != 'x' && op != '+') ||
+            (op == 'x' && step < 2)) {
+            return -1;
+        }
+        for (unsigned long long s = lo; s <= hi && n < max; s = (op == 'x') ? s * step : s + step) {
+            sizes[n++] = (size_t)s;
+        }
+        return n;
+    }
+
+    /* List: a,b,c */
+    const char* p = spec;
+    while (*p && n < max) {
+        char* end;
+        unsigned long long s = strtoull(p, &end, 10);
+        if (end == p || s == 0 || (*end != ',' && *end != '\0')) return -1;
+        sizes[n++] = (size_t)s;
+        p = (*end == ',') ? end + 1 : end;
+    }
+    return n > 0 ? n : -1;
+}
+
+int bench_parse_impls(const char* list, bool* mask) {
+    for (int i = 0; i < bench_num_impls; i++) mask[i] = false;
+
+    char buf[256];
+    snprintf(buf, sizeof(buf), "%s", list);
+    for (char* tok = strtok(buf, ","); tok != NULL; tok = strtok(NULL, ",")) {
+        if (strcmp(tok, "all") == 0) {
+            for (int i = 0; i < bench_num_impls; i++) mask[i] = true;
+            continue;
+        }
+        const bench_impl_t* impl = bench_find_impl(tok);
+        if (impl == NULL) {
+            fprintf(stderr, "Unknown implementation: %s\n", tok);
+            return -1;
+        }
+        mask[impl - bench_impls] = true;
+    }
+    return 0;
+}
+
+void bench_runtime_stats(const double* runtimes, int n, int nstdevs, sweep_stats_t* st) {
+    bool mask[n];
+    for (int i = 0; i < n; i++) mask[i] = true;
+
+    st->min = INFINITY;
+    st->max = 0.0;
+    for (int i = 0; i < n; i++) {
+        st->min = fmin(st->min, runtimes[i]);
+        st->max = fmax(st->max, runtimes[i]);
+    }
+
+    int n_msked;
+    do {
+        double avg = 0.0, std = 0.0;
+        int kept = 0;
+        for (int i = 0; i < n; i++) {
+            if (mask[i]) { avg += runtimes[i]; kept++; }
+        }
+        avg /= kept;
+        for (int i = 0; i < n; i++) {
+            if (mask[i]) std += (runtimes[i] - avg) * (runtimes[i] - avg);
+        }
+        std = sqrt(std / kept);
+
+        /* Mask off everything beyond nstdevs deviations, unless that
+         * would leave nothing (e.g. nstdevs = 0 with distinct runs)  */
+        n_msked = 0;
+        for (int i = 0; i < n; i++) {
+            if (mask[i] && fabs(runtimes[i] - avg) > nstdevs * std) n_msked++;
+        }
+        if (n_msked == kept) n_msked = 0;
+        for (int i = 0; i < n && n_msked > 0; i++) {
+            if (mask[i] && fabs(runtimes[i] - avg) > nstdevs * std) mask[i] = false;
+        }
+
+        st->mean = avg;
+        st->stddev = std;
+        st->kept = kept;
+    } while (n_msked > 0);
+}
+
+int bench_sweep(const sweep_config_t* cfg) {
+    /* Time keeping, as in vvadd */
+    struct timespec ts;
+    struct timespec te;
+    int num_runs = cfg->nruns > 0 ? cfg->nruns : 1;
+    double* runtimes = calloc(num_runs, sizeof(double));
+
+    FILE* csv = NULL;
+    if (cfg->csv != NULL) {
+        csv = fopen(cfg->csv, "w");
+        if (csv == NULL) {
+            fprintf(stderr, "Error opening file %s for writing.\n", cfg->csv);
+            free(runtimes);
+            return 1;
+        }
+        fprintf(csv, "impl,M,K,N,layout,nthreads,nruns,kept,mean_ns,stddev_ns,min_ns,max_ns,"
+                     "gflops_mean,gflops_best\n");
+    }
+
+    printf("Sweep: %d run(s) + %d warmup per point, outliers beyond %d stdev(s)\n",
+           num_runs, cfg->nwarmup, cfg->nstdevs);
+    printf("%6s  %-10s %12s %10s %12s %10s %10s\n", "size", "impl", "mean ms", "stdev %",
+           "min ms", "GFLOP/s", "best");
+
+    for (int s = 0; s < cfg->nsizes; s++) {
+        size_t n = cfg->sizes[s];
+
+        args_t args;
+        bench_setup_args(&args, n, n, n, cfg->layout, cfg->pad, NULL, NULL, NULL);
+        args.nthreads = cfg->nthreads;
+        args.cpu = cfg->cpu;
+
+        float* A = bench_alloc_matrix(n, n, args.lda, cfg->layout);
+        float* B = bench_alloc_matrix(n, n, args.ldb, cfg->layout);
+        float* R = bench_alloc_matrix(n, n, args.ldr, cfg->layout);
+        args.input0 = A;
+        args.input1 = B;
+        args.output = R;
+
+        for (int i = 0; i < bench_num_impls; i++) {
+            if (!cfg->impls[i]) continue;
+
+            for (int w = 0; w < cfg->nwarmup; w++) {
+                bench_impls[i].fn(&args);
+            }
+            for (int r = 0; r < num_runs; r++) {
+                __SET_START_TIME();
+                bench_impls[i].fn(&args);
+                __SET_END_TIME();
+                runtimes[r] = __CALC_RUNTIME();
+            }
+
+            sweep_stats_t st;
+            bench_runtime_stats(runtimes, num_runs, cfg->nstdevs, &st);
+            double gflops = bench_gflops(n, n, n, st.mean * 1e-9);
+            double best = bench_gflops(n, n, n, st.min * 1e-9);
+
+            printf("%6zu  %-10s %12.3f %9.1f%% %12.3f %10.2f %10.2f\n", n, bench_impls[i].name,
+                   st.mean * 1e-6, st.mean > 0 ? 100.0 * st.stddev / st.mean : 0.0,
+                   st.min * 1e-6, gflops, best);
+            if (csv != NULL) {
+                fprintf(csv, "%s,%zu,%zu,%zu,%s,%d,%d,%d,%.0f,%.0f,%.0f,%.0f,%.3f,%.3f\n",
+                        bench_impls[i].name, n, n, n,
+                        cfg->layout == MMULT_COL_MAJOR ? "col" : "row", cfg->nthreads,
+                        num_runs, st.kept, st.mean, st.stddev, st.min, st.max, gflops, best);
+                fflush(csv);
+            }
+        }
+
+        free(A);
+        free(B);
+        free(R);
+    }
+
+    if (csv != NULL) {
+        fclose(csv);
+        printf("Results written to %s\n", cfg->csv);
+    }
+    free(runtimes);
+    return 0;
+}
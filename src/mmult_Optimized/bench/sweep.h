@@ -0,0 +1,49 @@
+#ifndef __BENCH_SWEEP_H_
+#define __BENCH_SWEEP_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "include/types.h"
+#include "bench/bench.h"
+
+#define SWEEP_MAX_SIZES 64
+
+/* Settings of a non-interactive size sweep */
+typedef struct {
+    size_t sizes[SWEEP_MAX_SIZES];   /* Square sizes, in order          */
+    int nsizes;
+    bool impls[16];                  /* Indexed like bench_impls[]      */
+    int nruns;                       /* Timed runs per point            */
+    int nwarmup;                     /* Untimed runs before those       */
+    int nstdevs;                     /* Outlier threshold               */
+    mmult_layout_t layout;
+    size_t pad;
+    int nthreads;
+    int cpu;
+    const char* csv;                 /* Output file, NULL for none      */
+} sweep_config_t;
+
+/* Parse "lo:hi:xF" (geometric), "lo:hi:+S" (arithmetic) or "a,b,c".
+ * Returns the number of sizes, or -1 if the spec is malformed.      */
+int bench_parse_sizes(const char* spec, size_t* sizes, int max);
+
+/* Parse a comma-separated list of -i names (or "all") into a mask.
+ * Returns -1 and names the culprit on stderr for an unknown entry.  */
+int bench_parse_impls(const char* list, bool* mask);
+
+/* Outlier-free statistics of a set of runtimes (ns), as in vvadd: the
+ * mean and standard deviation are recomputed, dropping runs further
+ * than nstdevs deviations from the mean, until nothing is dropped.  */
+typedef struct {
+    double mean, stddev, min, max;
+    int kept;
+} sweep_stats_t;
+
+void bench_runtime_stats(const double* runtimes, int n, int nstdevs, sweep_stats_t* st);
+
+/* Time every selected implementation at every size with wall-clock
+ * timing, print GFLOP/s and append the points to the CSV file.      */
+int bench_sweep(const sweep_config_t* cfg);
+
+#endif //__BENCH_SWEEP_H_
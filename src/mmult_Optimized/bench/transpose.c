@@ -0,0 +1,99 @@
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* Include common headers */
+#include "common/macros.h"
+#include "common/types.h"
+
+/* Include application-specific headers */
+#include "include/types.h"
+#include "impl/transpose.h"
+#include "bench/bench.h"
+#include "bench/transpose.h"
+
+/* Cache-resident, power of two (worst case for naive strides), ragged */
+static const size_t transpose_sizes[] = { 512, 1024, 2047, 4096, 8192 };
+#define NUM_TRANSPOSE_SIZES (sizeof(transpose_sizes) / sizeof(transpose_sizes[0]))
+
+#define TRANSPOSE_RUNS 3
+
+/* What the glue code did: one element at a time, dst walked by column */
+static void transpose_naive(size_t n, const float* src, float* dst) {
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            dst[j * n + i] = src[i * n + j];
+        }
+    }
+}
+
+static double gbs(size_t n, double seconds) {
+    return 2.0 * n * n * sizeof(float) / seconds * 1e-9;
+}
+
+int bench_transpose(size_t size, int nthreads) {
+    int failures = 0;
+    const size_t* sizes = transpose_sizes;
+    size_t nsizes = NUM_TRANSPOSE_SIZES;
+
+    if (nthreads <= 0) nthreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (nthreads <= 0) nthreads = 1;
+    if (size > 0) {
+        sizes = &size;
+        nsizes = 1;
+    }
+
+    printf("Matrix transpose throughput (GB/s, read + write), %d thread%s for the parallel runs\n",
+           nthreads, nthreads > 1 ? "s" : "");
+    printf("%6s %10s %10s %10s %10s %10s\n", "n", "naive", "avx", "avx(n)", "inplace", "inplace(n)");
+
+    for (size_t s = 0; s < nsizes; s++) {
+        size_t n = sizes[s];
+        float* X   = bench_alloc_matrix(n, n, n, MMULT_ROW_MAJOR);
+        float* ref = bench_alloc_matrix(n, n, n, MMULT_ROW_MAJOR);
+        float* Y   = bench_alloc_matrix(n, n, n, MMULT_ROW_MAJOR);
+        float* Yi  = bench_alloc_matrix(n, n, n, MMULT_ROW_MAJOR);
+
+        double t[5] = {0};
+        int bad = 0;
+        for (int r = 0; r < TRANSPOSE_RUNS; r++) {
+            double t0, dt;
+
+            t0 = bench_now();
+            transpose_naive(n, X, ref);
+            dt = bench_now() - t0;
+            if (r == 0 || dt < t[0]) t[0] = dt;
+
+            for (int v = 0; v < 2; v++) {
+                t0 = bench_now();
+                transpose_out(n, n, X, n, Y, n, v == 0 ? 1 : nthreads);
+                dt = bench_now() - t0;
+                if (r == 0 || dt < t[1 + v]) t[1 + v] = dt;
+                if (r == TRANSPOSE_RUNS - 1) bad |= memcmp(Y, ref, n * n * sizeof(float)) != 0;
+            }
+
+            for (int v = 0; v < 2; v++) {
+                memcpy(Yi, X, n * n * sizeof(float));
+                t0 = bench_now();
+                transpose_inplace(n, Yi, n, v == 0 ? 1 : nthreads);
+                dt = bench_now() - t0;
+                if (r == 0 || dt < t[3 + v]) t[3 + v] = dt;
+                bad |= memcmp(Yi, ref, n * n * sizeof(float)) != 0;
+            }
+        }
+        failures += bad;
+
+        printf("%6zu %10.2f %10.2f %10.2f %10.2f %10.2f%s\n", n,
+               gbs(n, t[0]), gbs(n, t[1]), gbs(n, t[2]), gbs(n, t[3]), gbs(n, t[4]),
+               bad ? "  MISMATCH" : "");
+
+        free(X); free(ref); free(Y); free(Yi);
+    }
+
+    if (failures) {
+        printf("%d size(s) disagree with the naive transpose\n", failures);
+    }
+    return failures ? 1 : 0;
+}
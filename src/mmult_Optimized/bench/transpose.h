@@ -0,0 +1,13 @@
+#ifndef __BENCH_TRANSPOSE_H_
+#define __BENCH_TRANSPOSE_H_
+
+#include <stddef.h>
+
+/* Transpose throughput on square sizes (just `size` if it is nonzero):
+ * the naive double loop against the blocked AVX kernel on one and on
+ * nthreads threads (0 = all CPUs), out of place and in place. Reports
+ * GB/s counting one read and one write of every element, and checks
+ * all results against the naive one.                                */
+int bench_transpose(size_t size, int nthreads);
+
+#endif //__BENCH_TRANSPOSE_H_
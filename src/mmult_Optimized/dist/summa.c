@@ -0,0 +1,330 @@
+#define _GNU_SOURCE
+
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <signal.h>
+#include <sched.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+/* Include common headers */
+#include "common/macros.h"
+
+/* Include application-specific headers */
+#include "impl/gemm.h"
+#include "dist/transport.h"
+#include "dist/summa.h"
+
+#define SUMMA_SLOTS 2
+
+#define SUMMA_MIN(a, b) ((a) < (b) ? (a) : (b))
+
+/* Statistics every rank leaves behind, in memory shared with the parent */
+typedef struct {
+    double seconds;
+    double wait;
+} summa_stat_t;
+
+typedef struct {
+    pthread_barrier_t start;  /* Process-shared: all ranks start together */
+    size_t steps;
+} summa_ctl_t;
+
+typedef struct {
+    const float* A;           /* Panel of A: mloc x kw, leading dimension lda */
+    size_t lda;
+    const float* B;           /* Panel of B: kw x nloc, leading dimension nloc */
+} summa_slot_t;
+
+typedef struct {
+    const summa_config_t* cfg;
+    dist_transport_t* t;
+    int row, col;
+
+    size_t m0, mloc;          /* Rows of A and C owned by this rank     */
+    size_t n0, nloc;          /* Columns of B and C owned by this rank  */
+    size_t ka0, kaloc;        /* Columns of A owned (split over pc)     */
+    size_t kb0;               /* Rows of B owned (split over pr)        */
+    float* A;                 /* mloc x kaloc                           */
+    float* B;                 /* kbloc x nloc                           */
+    int* row_group;           /* Ranks of this grid row, by column      */
+    int* col_group;           /* Ranks of this grid column, by row      */
+
+    size_t nsteps;
+    size_t* kstep;            /* Step s covers K range [kstep[s], kstep[s + 1]) */
+
+    float* Abuf[SUMMA_SLOTS];
+    float* Bbuf[SUMMA_SLOTS];
+    summa_slot_t slot[SUMMA_SLOTS];
+
+    pthread_mutex_t lock;
+    pthread_cond_t  cond;
+    size_t loaded;            /* Steps whose panels are in their slot   */
+    size_t consumed;          /* Steps the multiply is done with        */
+} summa_rank_t;
+
+static double summa_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* First index of part i when n items are split into p parts */
+static size_t part_lo(size_t n, int p, int i) {
+    return n * (size_t)i / (size_t)p;
+}
+
+/* Part holding item x */
+static int part_owner(size_t n, int p, size_t x) {
+    int i = 0;
+    while (i + 1 < p && part_lo(n, p, i + 1) <= x) i++;
+    return i;
+}
+
+/* Steps are at most kb wide and never cross the K boundary of an A or
+ * a B block, so every panel has a single owner                     */
+static void summa_plan(summa_rank_t* r, size_t kb) {
+    const summa_config_t* cfg = r->cfg;
+    size_t K = cfg->K;
+
+    r->kstep = malloc((K / kb + cfg->pr + cfg->pc + 2) * sizeof(size_t));
+    r->nsteps = 0;
+    for (size_t k = 0; k < K;) {
+        size_t end = SUMMA_MIN(k + kb, K);
+        end = SUMMA_MIN(end, part_lo(K, cfg->pc, part_owner(K, cfg->pc, k) + 1));
+        end = SUMMA_MIN(end, part_lo(K, cfg->pr, part_owner(K, cfg->pr, k) + 1));
+        r->kstep[r->nsteps++] = k;
+        k = end;
+    }
+    r->kstep[r->nsteps] = K;
+}
+
+/* Broadcast the panels of every step, one slot ahead of the multiply */
+static void* summa_comm(void* arg) {
+    summa_rank_t* r = (summa_rank_t*)arg;
+    const summa_config_t* cfg = r->cfg;
+
+    for (size_t s = 0; s < r->nsteps; s++) {
+        pthread_mutex_lock(&r->lock);
+        while (s >= r->consumed + SUMMA_SLOTS) {
+            pthread_cond_wait(&r->cond, &r->lock);
+        }
+        pthread_mutex_unlock(&r->lock);
+
+        size_t k0 = r->kstep[s], kw = r->kstep[s + 1] - k0;
+        int ja = part_owner(cfg->K, cfg->pc, k0);
+        int ib = part_owner(cfg->K, cfg->pr, k0);
+        summa_slot_t* slot = &r->slot[s % SUMMA_SLOTS];
+
+        /* A: the owner's columns are strided, so they are gathered
+         * first, unless nobody else needs them                       */
+        if (cfg->pc == 1) {
+            slot->A = &r->A[k0 - r->ka0];
+            slot->lda = r->kaloc;
+        } else {
+            float* buf = r->Abuf[s % SUMMA_SLOTS];
+            if (r->col == ja) {
+                for (size_t i = 0; i < r->mloc; i++) {
+                    memcpy(&buf[i * kw], &r->A[i * r->kaloc + (k0 - r->ka0)], kw * sizeof(float));
+                }
+            }
+            if (dist_bcast(r->t, r->row_group, cfg->pc, ja, buf, r->mloc * kw * sizeof(float)) != 0) {
+                fprintf(stderr, "SUMMA rank %d: row broadcast failed\n", r->t->rank);
+                exit(1);
+            }
+            slot->A = buf;
+            slot->lda = kw;
+        }
+
+        /* B: the owner's rows are contiguous and sent in place */
+        float* Bp = (r->row == ib) ? &r->B[(k0 - r->kb0) * r->nloc] : r->Bbuf[s % SUMMA_SLOTS];
+        if (dist_bcast(r->t, r->col_group, cfg->pr, ib, Bp, kw * r->nloc * sizeof(float)) != 0) {
+            fprintf(stderr, "SUMMA rank %d: column broadcast failed\n", r->t->rank);
+            exit(1);
+        }
+        slot->B = Bp;
+
+        pthread_mutex_lock(&r->lock);
+        r->loaded = s + 1;
+        pthread_cond_broadcast(&r->cond);
+        pthread_mutex_unlock(&r->lock);
+    }
+    return NULL;
+}
+
+static int summa_rank(const summa_config_t* cfg, dist_transport_t* t, int rank, summa_ctl_t* ctl,
+                      summa_stat_t* stat, float* C) {
+    summa_rank_t r = { .cfg = cfg, .t = t, .row = rank / cfg->pc, .col = rank % cfg->pc };
+    size_t kb = cfg->kb ? cfg->kb : SUMMA_KB;
+
+    /* Pin the rank; its communication thread inherits the mask */
+    long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (ncpus <= 0) ncpus = 1;
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET((cfg->cpu + rank) % ncpus, &cpuset);
+    sched_setaffinity(0, sizeof(cpuset), &cpuset);
+
+    t->attach(t, rank);
+
+    r.m0 = part_lo(cfg->M, cfg->pr, r.row);
+    r.mloc = part_lo(cfg->M, cfg->pr, r.row + 1) - r.m0;
+    r.n0 = part_lo(cfg->N, cfg->pc, r.col);
+    r.nloc = part_lo(cfg->N, cfg->pc, r.col + 1) - r.n0;
+    r.ka0 = part_lo(cfg->K, cfg->pc, r.col);
+    r.kaloc = part_lo(cfg->K, cfg->pc, r.col + 1) - r.ka0;
+    r.kb0 = part_lo(cfg->K, cfg->pr, r.row);
+    size_t kbloc = part_lo(cfg->K, cfg->pr, r.row + 1) - r.kb0;
+
+    r.row_group = malloc(cfg->pc * sizeof(int));
+    r.col_group = malloc(cfg->pr * sizeof(int));
+    for (int j = 0; j < cfg->pc; j++) r.row_group[j] = r.row * cfg->pc + j;
+    for (int i = 0; i < cfg->pr; i++) r.col_group[i] = i * cfg->pc + r.col;
+
+    /* Generate the local blocks of the operands */
+    r.A = __ALLOC_DATA(float, r.mloc * r.kaloc + 1);
+    r.B = __ALLOC_DATA(float, kbloc * r.nloc + 1);
+    float* Cl = __ALLOC_DATA(float, r.mloc * r.nloc + 1);
+    for (size_t i = 0; i < r.mloc; i++) {
+        for (size_t k = 0; k < r.kaloc; k++) r.A[i * r.kaloc + k] = summa_a(r.m0 + i, r.ka0 + k);
+    }
+    for (size_t k = 0; k < kbloc; k++) {
+        for (size_t j = 0; j < r.nloc; j++) r.B[k * r.nloc + j] = summa_b(r.kb0 + k, r.n0 + j);
+    }
+    memset(Cl, 0, r.mloc * r.nloc * sizeof(float));
+
+    summa_plan(&r, kb);
+    for (int s = 0; s < SUMMA_SLOTS; s++) {
+        r.Abuf[s] = __ALLOC_DATA(float, r.mloc * kb + 1);
+        r.Bbuf[s] = __ALLOC_DATA(float, kb * r.nloc + 1);
+    }
+    pthread_mutex_init(&r.lock, NULL);
+    pthread_cond_init(&r.cond, NULL);
+
+    pthread_barrier_wait(&ctl->start);
+    double t0 = summa_now(), wait = 0.0;
+
+    pthread_t comm;
+    pthread_create(&comm, NULL, summa_comm, &r);
+
+    for (size_t s = 0; s < r.nsteps; s++) {
+        double w0 = summa_now();
+        pthread_mutex_lock(&r.lock);
+        while (r.loaded <= s) {
+            pthread_cond_wait(&r.cond, &r.lock);
+        }
+        pthread_mutex_unlock(&r.lock);
+        wait += summa_now() - w0;
+
+        const summa_slot_t* slot = &r.slot[s % SUMMA_SLOTS];
+        size_t kw = r.kstep[s + 1] - r.kstep[s];
+        if (r.mloc > 0 && r.nloc > 0) {
+            gemm_sgemm(0, 0, r.mloc, r.nloc, kw, 1.0f, slot->A, slot->lda, slot->B, r.nloc,
+                       1.0f, Cl, r.nloc, NULL, NULL);
+        }
+
+        pthread_mutex_lock(&r.lock);
+        r.consumed = s + 1;
+        pthread_cond_broadcast(&r.cond);
+        pthread_mutex_unlock(&r.lock);
+    }
+
+    pthread_join(comm, NULL);
+    stat->seconds = summa_now() - t0;
+    stat->wait = wait;
+    if (rank == 0) ctl->steps = r.nsteps;
+
+    /* Gather: the block goes straight into the shared result */
+    for (size_t i = 0; i < r.mloc; i++) {
+        memcpy(&C[(r.m0 + i) * cfg->N + r.n0], &Cl[i * r.nloc], r.nloc * sizeof(float));
+    }
+    return 0;
+}
+
+int summa_run(const summa_config_t* cfg, float* C, summa_result_t* res) {
+    int P = cfg->pr * cfg->pc;
+    if (P <= 0 || (size_t)cfg->pr > cfg->M || (size_t)cfg->pc > cfg->N ||
+        (size_t)cfg->pr > cfg->K || (size_t)cfg->pc > cfg->K) {
+        fprintf(stderr, "SUMMA: a %d x %d grid does not fit a %zu x %zu x %zu product\n",
+                cfg->pr, cfg->pc, cfg->M, cfg->K, cfg->N);
+        return -1;
+    }
+
+    /* Control block, per-rank statistics and the gathered C, shared by all ranks */
+    size_t ctl_bytes = GEMM_ROUND_UP(sizeof(summa_ctl_t) + P * sizeof(summa_stat_t), 64);
+    size_t bytes = ctl_bytes + cfg->M * cfg->N * sizeof(float);
+    char* shared = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (shared == MAP_FAILED) {
+        perror("SUMMA: mmap");
+        return -1;
+    }
+    summa_ctl_t* ctl = (summa_ctl_t*)shared;
+    summa_stat_t* stats = (summa_stat_t*)(ctl + 1);
+    float* Cg = (float*)(shared + ctl_bytes);
+
+    pthread_barrierattr_t attr;
+    pthread_barrierattr_init(&attr);
+    pthread_barrierattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    pthread_barrier_init(&ctl->start, &attr, P);
+    pthread_barrierattr_destroy(&attr);
+
+    dist_transport_t* t = dist_transport_create(cfg->transport, P);
+    if (t == NULL) {
+        munmap(shared, bytes);
+        return -1;
+    }
+
+    /* Flush so buffered output is not written once per rank */
+    fflush(stdout);
+    pid_t pids[P];
+    for (int r = 0; r < P; r++) {
+        pids[r] = fork();
+        if (pids[r] == 0) {
+            _exit(summa_rank(cfg, t, r, ctl, &stats[r], Cg) == 0 ? 0 : 1);
+        }
+        if (pids[r] < 0) {
+            perror("SUMMA: fork");
+            /* The ranks already started wait at the barrier for good */
+            for (int q = 0; q < r; q++) kill(pids[q], SIGKILL);
+            for (int q = 0; q < r; q++) waitpid(pids[q], NULL, 0);
+            t->destroy(t);
+            munmap(shared, bytes);
+            return -1;
+        }
+    }
+    t->destroy(t);
+
+    /* A failed rank leaves its peers blocked on it: stop them all */
+    int failed = 0;
+    for (int n = 0; n < P; n++) {
+        int status;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0) break;
+        if (!failed && (!WIFEXITED(status) || WEXITSTATUS(status) != 0)) {
+            failed = 1;
+            for (int r = 0; r < P; r++) {
+                if (pids[r] != pid) kill(pids[r], SIGKILL);
+            }
+        }
+    }
+
+    if (!failed) {
+        res->seconds = 0.0;
+        res->wait = 0.0;
+        for (int r = 0; r < P; r++) {
+            if (stats[r].seconds > res->seconds) res->seconds = stats[r].seconds;
+            if (stats[r].seconds > 0.0) res->wait += stats[r].wait / stats[r].seconds / P;
+        }
+        res->steps = ctl->steps;
+        memcpy(C, Cg, cfg->M * cfg->N * sizeof(float));
+    }
+
+    pthread_barrier_destroy(&ctl->start);
+    munmap(shared, bytes);
+    return failed ? -1 : 0;
+}
@@ -0,0 +1,55 @@
+/* summa.h
+ *
+ * SUMMA (Scalable Universal Matrix Multiplication Algorithm) over a
+ * pr x pc grid of processes. Rank (i, j) owns block (i, j) of A, B and
+ * C: rows of A and C and columns of B and C are split over the grid
+ * rows and columns, K over the grid columns for A and the grid rows
+ * for B. At every step the owners of the current K panel broadcast
+ * their slice of A along their grid row and of B along their grid
+ * column, and every rank adds the panel product to its C block with
+ * the packed GEMM.
+ *
+ * Each rank broadcasts from a communication thread into one of two
+ * panel buffers while the main thread multiplies the other one, so the
+ * transfer of panel s + 1 overlaps the multiply of panel s.
+ *
+ * Ranks are forked processes; A and B are generated in place by the
+ * ranks that own them (summa_a / summa_b) and the C blocks are gathered
+ * through a shared mapping.
+ */
+
+#ifndef __DIST_SUMMA_H_
+#define __DIST_SUMMA_H_
+
+#include <stddef.h>
+
+#include "dist/transport.h"
+
+/* Default K panel width */
+#define SUMMA_KB 256
+
+typedef struct {
+    size_t M, K, N;
+    int pr, pc;                        /* Process grid                   */
+    size_t kb;                         /* K panel width, 0 for SUMMA_KB  */
+    dist_transport_kind_t transport;
+    int cpu;                           /* Rank r runs on CPU cpu + r     */
+} summa_config_t;
+
+typedef struct {
+    double seconds;      /* Slowest rank, from a common start       */
+    double wait;         /* Mean fraction of it spent waiting for panels */
+    size_t steps;        /* Panels broadcast                         */
+} summa_result_t;
+
+/* Elements of the generated operands: small integers, so any order of
+ * summation gives the exact product for K up to 2^24 / 81           */
+static inline float summa_a(size_t i, size_t k) { return (float)((i * 7 + k * 3) % 10); }
+static inline float summa_b(size_t k, size_t j) { return (float)((k * 5 + j * 11 + 1) % 10); }
+
+/* Run SUMMA on summa_a x summa_b with pr * pc processes and copy the
+ * M x N product to C (row-major, leading dimension N). Returns 0, or
+ * -1 if the transport could not be set up or a rank failed.       */
+int summa_run(const summa_config_t* cfg, float* C, summa_result_t* res);
+
+#endif //__DIST_SUMMA_H_
@@ -0,0 +1,370 @@
+#define _GNU_SOURCE
+
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+/* Include application-specific headers */
+#include "dist/transport.h"
+
+/* Broadcasts are split so the levels of the tree overlap */
+#define DIST_BCAST_CHUNK (256 << 10)
+
+/* Busy-wait iterations before a waiting rank yields its CPU */
+#define DIST_SPINS 256
+
+int dist_transport_parse(const char* name, dist_transport_kind_t* kind) {
+    if (strcmp(name, "shm") == 0) {
+        *kind = DIST_TRANSPORT_SHM;
+    } else if (strcmp(name, "unix") == 0) {
+        *kind = DIST_TRANSPORT_UNIX;
+    } else if (strcmp(name, "tcp") == 0) {
+        *kind = DIST_TRANSPORT_TCP;
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------ */
+/* Shared memory: ring (src, dst) is written by src and read by dst    */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+    size_t head;              /* Bytes written so far, owned by the sender  */
+    char pad0[64 - sizeof(size_t)];
+    size_t tail;              /* Bytes read so far, owned by the receiver   */
+    char pad1[64 - sizeof(size_t)];
+} dist_ring_t;
+
+#define DIST_RING_STRIDE (sizeof(dist_ring_t) + DIST_SHM_RING_BYTES)
+
+typedef struct {
+    char* base;
+    size_t size;
+} dist_shm_t;
+
+static dist_ring_t* shm_ring(dist_transport_t* t, int src, int dst) {
+    dist_shm_t* shm = (dist_shm_t*)t->impl;
+    return (dist_ring_t*)(shm->base + ((size_t)src * t->nranks + dst) * DIST_RING_STRIDE);
+}
+
+static void dist_wait(int* spins) {
+    if (++*spins < DIST_SPINS) {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    } else {
+        sched_yield();
+    }
+}
+
+static void shm_attach(dist_transport_t* t, int rank) {
+    t->rank = rank;
+}
+
+static int shm_send(dist_transport_t* t, int dst, const void* buf, size_t bytes) {
+    dist_ring_t* ring = shm_ring(t, t->rank, dst);
+    char* data = (char*)(ring + 1);
+    const char* p = (const char*)buf;
+    size_t head = ring->head;
+    int spins = 0;
+
+    while (bytes > 0) {
+        size_t used = head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+        if (used == DIST_SHM_RING_BYTES) {
+            dist_wait(&spins);
+            continue;
+        }
+        size_t off = head % DIST_SHM_RING_BYTES;
+        size_t n = DIST_SHM_RING_BYTES - used;
+        if (n > DIST_SHM_RING_BYTES - off) n = DIST_SHM_RING_BYTES - off;
+        if (n > bytes) n = bytes;
+
+        memcpy(&data[off], p, n);
+        head += n;
+        __atomic_store_n(&ring->head, head, __ATOMIC_RELEASE);
+        p += n;
+        bytes -= n;
+        spins = 0;
+    }
+    return 0;
+}
+
+static int shm_recv(dist_transport_t* t, int src, void* buf, size_t bytes) {
+    dist_ring_t* ring = shm_ring(t, src, t->rank);
+    const char* data = (const char*)(ring + 1);
+    char* p = (char*)buf;
+    size_t tail = ring->tail;
+    int spins = 0;
+
+    while (bytes > 0) {
+        size_t avail = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) - tail;
+        if (avail == 0) {
+            dist_wait(&spins);
+            continue;
+        }
+        size_t off = tail % DIST_SHM_RING_BYTES;
+        size_t n = avail;
+        if (n > DIST_SHM_RING_BYTES - off) n = DIST_SHM_RING_BYTES - off;
+        if (n > bytes) n = bytes;
+
+        memcpy(p, &data[off], n);
+        tail += n;
+        __atomic_store_n(&ring->tail, tail, __ATOMIC_RELEASE);
+        p += n;
+        bytes -= n;
+        spins = 0;
+    }
+    return 0;
+}
+
+static void shm_destroy(dist_transport_t* t) {
+    dist_shm_t* shm = (dist_shm_t*)t->impl;
+    munmap(shm->base, shm->size);
+    free(shm);
+    free(t);
+}
+
+/* ------------------------------------------------------------------ */
+/* Sockets: fds[i * nranks + j] is the end rank i uses to talk to j     */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+    int* fds;
+    int* listeners;           /* TCP only: one per rank           */
+    struct sockaddr_in* addrs;
+} dist_sock_t;
+
+static void sock_tune(int fd, int tcp) {
+    int size = DIST_SHM_RING_BYTES, one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+    if (tcp) setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+static int sock_write_all(int fd, const void* buf, size_t bytes) {
+    const char* p = (const char*)buf;
+    while (bytes > 0) {
+        ssize_t n = send(fd, p, bytes, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        p += n;
+        bytes -= (size_t)n;
+    }
+    return 0;
+}
+
+static int sock_read_all(int fd, void* buf, size_t bytes) {
+    char* p = (char*)buf;
+    while (bytes > 0) {
+        ssize_t n = recv(fd, p, bytes, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+        p += n;
+        bytes -= (size_t)n;
+    }
+    return 0;
+}
+
+/* Close every endpoint except the ones rank `keep` owns (-1: all) */
+static void sock_close_others(dist_transport_t* t, int keep) {
+    dist_sock_t* s = (dist_sock_t*)t->impl;
+    for (int i = 0; i < t->nranks; i++) {
+        for (int j = 0; j < t->nranks; j++) {
+            int* fd = &s->fds[i * t->nranks + j];
+            if (i != keep && *fd >= 0) {
+                close(*fd);
+                *fd = -1;
+            }
+        }
+        if (s->listeners != NULL && s->listeners[i] >= 0 && i != keep) {
+            close(s->listeners[i]);
+            s->listeners[i] = -1;
+        }
+    }
+}
+
+static void unix_attach(dist_transport_t* t, int rank) {
+    t->rank = rank;
+    sock_close_others(t, rank);
+}
+
+/* Connect to every lower rank, then accept every higher one; each new
+ * connection starts with the connecting rank's number               */
+static void tcp_attach(dist_transport_t* t, int rank) {
+    dist_sock_t* s = (dist_sock_t*)t->impl;
+    t->rank = rank;
+
+    for (int j = 0; j < rank; j++) {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0 || connect(fd, (struct sockaddr*)&s->addrs[j], sizeof(s->addrs[j])) != 0 ||
+            sock_write_all(fd, &rank, sizeof(rank)) != 0) {
+            perror("tcp transport: connect");
+            exit(1);
+        }
+        sock_tune(fd, 1);
+        s->fds[rank * t->nranks + j] = fd;
+    }
+    for (int n = rank + 1; n < t->nranks; n++) {
+        int peer = -1;
+        int fd = accept(s->listeners[rank], NULL, NULL);
+        if (fd < 0 || sock_read_all(fd, &peer, sizeof(peer)) != 0 || peer <= rank || peer >= t->nranks) {
+            perror("tcp transport: accept");
+            exit(1);
+        }
+        sock_tune(fd, 1);
+        s->fds[rank * t->nranks + peer] = fd;
+    }
+
+    sock_close_others(t, rank);
+    close(s->listeners[rank]);
+    s->listeners[rank] = -1;
+}
+
+static int sock_send(dist_transport_t* t, int dst, const void* buf, size_t bytes) {
+    dist_sock_t* s = (dist_sock_t*)t->impl;
+    return sock_write_all(s->fds[t->rank * t->nranks + dst], buf, bytes);
+}
+
+static int sock_recv(dist_transport_t* t, int src, void* buf, size_t bytes) {
+    dist_sock_t* s = (dist_sock_t*)t->impl;
+    return sock_read_all(s->fds[t->rank * t->nranks + src], buf, bytes);
+}
+
+static void sock_destroy(dist_transport_t* t) {
+    dist_sock_t* s = (dist_sock_t*)t->impl;
+    sock_close_others(t, -1);
+    free(s->fds);
+    free(s->listeners);
+    free(s->addrs);
+    free(s);
+    free(t);
+}
+
+dist_transport_t* dist_transport_create(dist_transport_kind_t kind, int nranks) {
+    dist_transport_t* t = calloc(1, sizeof(*t));
+    t->nranks = nranks;
+    t->rank = -1;
+
+    if (kind == DIST_TRANSPORT_SHM) {
+        dist_shm_t* shm = calloc(1, sizeof(*shm));
+        /* Pages of rings that are never used are never touched */
+        shm->size = (size_t)nranks * nranks * DIST_RING_STRIDE;
+        shm->base = mmap(NULL, shm->size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (shm->base == MAP_FAILED) {
+            perror("shm transport: mmap");
+            free(shm);
+            free(t);
+            return NULL;
+        }
+        t->name = "shm";
+        t->impl = shm;
+        t->attach = shm_attach;
+        t->send = shm_send;
+        t->recv = shm_recv;
+        t->destroy = shm_destroy;
+        return t;
+    }
+
+    dist_sock_t* s = calloc(1, sizeof(*s));
+    s->fds = malloc((size_t)nranks * nranks * sizeof(int));
+    for (int i = 0; i < nranks * nranks; i++) s->fds[i] = -1;
+    t->impl = s;
+    t->send = sock_send;
+    t->recv = sock_recv;
+    t->destroy = sock_destroy;
+
+    if (kind == DIST_TRANSPORT_UNIX) {
+        t->name = "unix";
+        t->attach = unix_attach;
+        for (int i = 0; i < nranks; i++) {
+            for (int j = i + 1; j < nranks; j++) {
+                int sv[2];
+                if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0) {
+                    perror("unix transport: socketpair");
+                    sock_destroy(t);
+                    return NULL;
+                }
+                sock_tune(sv[0], 0);
+                sock_tune(sv[1], 0);
+                s->fds[i * nranks + j] = sv[0];
+                s->fds[j * nranks + i] = sv[1];
+            }
+        }
+        return t;
+    }
+
+    /* TCP: one loopback listener per rank on a port picked by the kernel */
+    t->name = "tcp";
+    t->attach = tcp_attach;
+    s->listeners = malloc(nranks * sizeof(int));
+    s->addrs = calloc(nranks, sizeof(struct sockaddr_in));
+    for (int i = 0; i < nranks; i++) s->listeners[i] = -1;
+    for (int i = 0; i < nranks; i++) {
+        socklen_t len = sizeof(s->addrs[i]);
+        s->addrs[i].sin_family = AF_INET;
+        s->addrs[i].sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        s->addrs[i].sin_port = 0;
+        s->listeners[i] = socket(AF_INET, SOCK_STREAM, 0);
+        if (s->listeners[i] < 0 ||
+            bind(s->listeners[i], (struct sockaddr*)&s->addrs[i], sizeof(s->addrs[i])) != 0 ||
+            listen(s->listeners[i], nranks) != 0 ||
+            getsockname(s->listeners[i], (struct sockaddr*)&s->addrs[i], &len) != 0) {
+            perror("tcp transport: listen");
+            sock_destroy(t);
+            return NULL;
+        }
+    }
+    return t;
+}
+
+/* One chunk through the tree: receive from the parent, then forward
+ * to the children from the farthest subtree in                      */
+static int bcast_tree(dist_transport_t* t, const int* group, int n, int root, int me,
+                      void* buf, size_t bytes) {
+    int rel = (me - root + n) % n;
+    int mask = 1;
+
+    while (mask < n) {
+        if (rel & mask) {
+            if (t->recv(t, group[(rel - mask + root) % n], buf, bytes) != 0) return -1;
+            break;
+        }
+        mask <<= 1;
+    }
+    mask >>= 1;
+    while (mask > 0) {
+        if (rel + mask < n) {
+            if (t->send(t, group[(rel + mask + root) % n], buf, bytes) != 0) return -1;
+        }
+        mask >>= 1;
+    }
+    return 0;
+}
+
+int dist_bcast(dist_transport_t* t, const int* group, int n, int root, void* buf, size_t bytes) {
+    int me = -1;
+    for (int i = 0; i < n; i++) {
+        if (group[i] == t->rank) me = i;
+    }
+    if (me < 0 || n == 1) return 0;
+
+    for (size_t off = 0; off < bytes; off += DIST_BCAST_CHUNK) {
+        size_t len = (bytes - off < DIST_BCAST_CHUNK) ? bytes - off : DIST_BCAST_CHUNK;
+        if (bcast_tree(t, group, n, root, me, (char*)buf + off, len) != 0) return -1;
+    }
+    return 0;
+}
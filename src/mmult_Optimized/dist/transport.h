@@ -0,0 +1,58 @@
+/* transport.h
+ *
+ * Point-to-point byte transport between the ranks of a distributed
+ * run, plus a broadcast built on it. A transport is created by the
+ * parent before it forks the ranks; every child then attaches to its
+ * own rank, which drops the endpoints it does not own.
+ *
+ *  - shm:  one single-producer/single-consumer ring per ordered pair of
+ *          ranks, in a shared anonymous mapping
+ *  - unix: one AF_UNIX stream socketpair per pair of ranks
+ *  - tcp:  one loopback TCP connection per pair of ranks, set up from a
+ *          listening socket per rank
+ *
+ * send and recv block until all bytes have moved. A transport is used
+ * by one thread per process at a time.
+ */
+
+#ifndef __DIST_TRANSPORT_H_
+#define __DIST_TRANSPORT_H_
+
+#include <stddef.h>
+
+typedef enum {
+    DIST_TRANSPORT_SHM,
+    DIST_TRANSPORT_UNIX,
+    DIST_TRANSPORT_TCP
+} dist_transport_kind_t;
+
+/* Bytes of every shared-memory ring; a send larger than this streams */
+#define DIST_SHM_RING_BYTES (1 << 20)
+
+typedef struct dist_transport dist_transport_t;
+
+struct dist_transport {
+    const char* name;
+    int nranks;
+    int rank;            /* -1 until attached */
+
+    void (*attach)(dist_transport_t* t, int rank);
+    int  (*send)(dist_transport_t* t, int dst, const void* buf, size_t bytes);
+    int  (*recv)(dist_transport_t* t, int src, void* buf, size_t bytes);
+    void (*destroy)(dist_transport_t* t);
+
+    void* impl;
+};
+
+/* Parse "shm", "unix" or "tcp"; returns -1 for anything else */
+int dist_transport_parse(const char* name, dist_transport_kind_t* kind);
+
+/* Create the endpoints of all nranks ranks (before forking), NULL on error */
+dist_transport_t* dist_transport_create(dist_transport_kind_t kind, int nranks);
+
+/* Binomial-tree broadcast of `bytes` from group[root] to the n ranks of
+ * group, which every member calls with the same arguments. Returns 0,
+ * or -1 if the transport failed.                                      */
+int dist_bcast(dist_transport_t* t, const int* group, int n, int root, void* buf, size_t bytes);
+
+#endif //__DIST_TRANSPORT_H_
@@ -0,0 +1,279 @@
+/* batched.c
+ *
+ * Batched small-matrix GEMM. For the common square sizes the kernel is
+ * stamped out by __DEFINE_SMALL_GEMM with the size as a compile-time
+ * constant: a few rows of C live in ymm accumulators (an xmm per row
+ * for S = 4) and all loops are fully unrolled, so there is no loop
+ * overhead and no scalar remainder.
+ */
+
+/* Standard C includes */
+#include <stdlib.h>
+#include <pthread.h>
+/*  -> SIMD header file  */
+#if defined(__amd64__) || defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+/* Include common headers */
+#include "common/macros.h"
+#include "common/types.h"
+
+/* Include application-specific headers */
+#include "impl/batched.h"
+
+typedef void (*small_gemm_fn)(const float* A, size_t lda, const float* B, size_t ldb,
+                              float* C, size_t ldc);
+
+#if defined(__AVX2__) && defined(__FMA__)
+/* RB rows of C are computed together so every B vector loaded is
+ * reused RB times; RB * NV = 8 accumulators for every S.             */
+#define __DEFINE_SMALL_GEMM(S)                                              \
+static void small_gemm_##S(const float* A, size_t lda, const float* B,      \
+                           size_t ldb, float* C, size_t ldc) {              \
+    enum { NV = (S) / 8, RB = 8 / NV };                                     \
+    _Pragma("GCC unroll 8")                                                 \
+    for (int i = 0; i < (S); i += RB) {                                     \
+        __m256 acc[RB][NV];                                                 \
+        _Pragma("GCC unroll 8")                                             \
+        for (int r = 0; r < RB; r++)                                        \
+            _Pragma("GCC unroll 4")                                         \
+            for (int v = 0; v < NV; v++) acc[r][v] = _mm256_setzero_ps();   \
+        _Pragma("GCC unroll 32")                                            \
+        for (int p = 0; p < (S); p++) {                                     \
+            __m256 b[NV];                                                   \
+            _Pragma("GCC unroll 4")                                         \
+            for (int v = 0; v < NV; v++)                                    \
+                b[v] = _mm256_loadu_ps(&B[p * ldb + 8 * v]);                \
+            _Pragma("GCC unroll 8")                                         \
+            for (int r = 0; r < RB; r++) {                                  \
+                __m256 a = _mm256_broadcast_ss(&A[(i + r) * lda + p]);      \
+                _Pragma("GCC unroll 4")                                     \
+                for (int v = 0; v < NV; v++)                                \
+                    acc[r][v] = _mm256_fmadd_ps(a, b[v], acc[r][v]);        \
+            }                                                               \
+        }                                                                   \
+        _Pragma("GCC unroll 8")                                             \
+        for (int r = 0; r < RB; r++)                                        \
+            _Pragma("GCC unroll 4")                                         \
+            for (int v = 0; v < NV; v++)                                    \
+                _mm256_storeu_ps(&C[(i + r) * ldc + 8 * v], acc[r][v]);     \
+    }                                                                       \
+}
+
+static void small_gemm_4(const float* A, size_t lda, const float* B,
+                         size_t ldb, float* C, size_t ldc) {
+    __m128 b0 = _mm_loadu_ps(&B[0 * ldb]);
+    __m128 b1 = _mm_loadu_ps(&B[1 * ldb]);
+    __m128 b2 = _mm_loadu_ps(&B[2 * ldb]);
+    __m128 b3 = _mm_loadu_ps(&B[3 * ldb]);
+
+    _Pragma("GCC unroll 4")
+    for (int i = 0; i < 4; i++) {
+        __m128 acc = _mm_mul_ps(_mm_set1_ps(A[i * lda + 0]), b0);
+        acc = _mm_fmadd_ps(_mm_set1_ps(A[i * lda + 1]), b1, acc);
+        acc = _mm_fmadd_ps(_mm_set1_ps(A[i * lda + 2]), b2, acc);
+        acc = _mm_fmadd_ps(_mm_set1_ps(A[i * lda + 3]), b3, acc);
+        _mm_storeu_ps(&C[i * ldc], acc);
+    }
+}
+#else
+/* Portable version: constant trip counts still let the compiler unroll */
+#define __DEFINE_SMALL_GEMM(S)                                              \
+static void small_gemm_##S(const float* A, size_t lda, const float* B,      \
+                           size_t ldb, float* C, size_t ldc) {              \
+    for (int i = 0; i < (S); i++) {                                         \
+        float acc[(S)] = { 0.0f };                                          \
+        for (int p = 0; p < (S); p++) {                                     \
+            float a = A[i * lda + p];                                       \
+            for (int j = 0; j < (S); j++) acc[j] += a * B[p * ldb + j];     \
+        }                                                                   \
+        for (int j = 0; j < (S); j++) C[i * ldc + j] = acc[j];              \
+    }                                                                       \
+}
+__DEFINE_SMALL_GEMM(4)
+#endif
+
+__DEFINE_SMALL_GEMM(8)
+__DEFINE_SMALL_GEMM(16)
+__DEFINE_SMALL_GEMM(32)
+
+/* Generic kernel: 4 rows x 16 columns of C at a time, then 8-column
+ * strips with masked loads and stores for the ragged right edge.     */
+static void small_gemm_generic(size_t m, size_t n, size_t k,
+                               const float* A, size_t lda,
+                               const float* B, size_t ldb,
+                               float* C, size_t ldc) {
+#if defined(__AVX2__) && defined(__FMA__)
+    size_t j = 0;
+
+    for (; j + 16 <= n; j += 16) {
+        size_t i = 0;
+
+        for (; i + 4 <= m; i += 4) {
+            __m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps();
+            __m256 c10 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+            __m256 c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps();
+            __m256 c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps();
+            for (size_t p = 0; p < k; p++) {
+                __m256 b0 = _mm256_loadu_ps(&B[p * ldb + j]);
+                __m256 b1 = _mm256_loadu_ps(&B[p * ldb + j + 8]);
+                __m256 a;
+                a = _mm256_broadcast_ss(&A[(i + 0) * lda + p]);
+                c00 = _mm256_fmadd_ps(a, b0, c00); c01 = _mm256_fmadd_ps(a, b1, c01);
+                a = _mm256_broadcast_ss(&A[(i + 1) * lda + p]);
+                c10 = _mm256_fmadd_ps(a, b0, c10); c11 = _mm256_fmadd_ps(a, b1, c11);
+                a = _mm256_broadcast_ss(&A[(i + 2) * lda + p]);
+                c20 = _mm256_fmadd_ps(a, b0, c20); c21 = _mm256_fmadd_ps(a, b1, c21);
+                a = _mm256_broadcast_ss(&A[(i + 3) * lda + p]);
+                c30 = _mm256_fmadd_ps(a, b0, c30); c31 = _mm256_fmadd_ps(a, b1, c31);
+            }
+            _mm256_storeu_ps(&C[(i + 0) * ldc + j], c00); _mm256_storeu_ps(&C[(i + 0) * ldc + j + 8], c01);
+            _mm256_storeu_ps(&C[(i + 1) * ldc + j], c10); _mm256_storeu_ps(&C[(i + 1) * ldc + j + 8], c11);
+            _mm256_storeu_ps(&C[(i + 2) * ldc + j], c20); _mm256_storeu_ps(&C[(i + 2) * ldc + j + 8], c21);
+            _mm256_storeu_ps(&C[(i + 3) * ldc + j], c30); _mm256_storeu_ps(&C[(i + 3) * ldc + j + 8], c31);
+        }
+
+        for (; i < m; i++) {
+            __m256 c0 = _mm256_setzero_ps(), c1 = _mm256_setzero_ps();
+            for (size_t p = 0; p < k; p++) {
+                __m256 a = _mm256_broadcast_ss(&A[i * lda + p]);
+                c0 = _mm256_fmadd_ps(a, _mm256_loadu_ps(&B[p * ldb + j]), c0);
+                c1 = _mm256_fmadd_ps(a, _mm256_loadu_ps(&B[p * ldb + j + 8]), c1);
+            }
+            _mm256_storeu_ps(&C[i * ldc + j], c0);
+            _mm256_storeu_ps(&C[i * ldc + j + 8], c1);
+        }
+    }
+
+    for (; j < n; j += 8) {
+        int jn = (n - j < 8) ? (int)(n - j) : 8;
+        __m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(jn),
+                                          _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        size_t i = 0;
+
+        for (; i + 4 <= m; i += 4) {
+            __m256 c0 = _mm256_setzero_ps(), c1 = _mm256_setzero_ps();
+            __m256 c2 = _mm256_setzero_ps(), c3 = _mm256_setzero_ps();
+            for (size_t p = 0; p < k; p++) {
+                __m256 b = _mm256_maskload_ps(&B[p * ldb + j], mask);
+                c0 = _mm256_fmadd_ps(_mm256_broadcast_ss(&A[(i + 0) * lda + p]), b, c0);
+                c1 = _mm256_fmadd_ps(_mm256_broadcast_ss(&A[(i + 1) * lda + p]), b, c1);
+                c2 = _mm256_fmadd_ps(_mm256_broadcast_ss(&A[(i + 2) * lda + p]), b, c2);
+                c3 = _mm256_fmadd_ps(_mm256_broadcast_ss(&A[(i + 3) * lda + p]), b, c3);
+            }
+            _mm256_maskstore_ps(&C[(i + 0) * ldc + j], mask, c0);
+            _mm256_maskstore_ps(&C[(i + 1) * ldc + j], mask, c1);
+            _mm256_maskstore_ps(&C[(i + 2) * ldc + j], mask, c2);
+            _mm256_maskstore_ps(&C[(i + 3) * ldc + j], mask, c3);
+        }
+
+        for (; i < m; i++) {
+            __m256 c0 = _mm256_setzero_ps();
+            for (size_t p = 0; p < k; p++) {
+                __m256 b = _mm256_maskload_ps(&B[p * ldb + j], mask);
+                c0 = _mm256_fmadd_ps(_mm256_broadcast_ss(&A[i * lda + p]), b, c0);
+            }
+            _mm256_maskstore_ps(&C[i * ldc + j], mask, c0);
+        }
+    }
+#else
+    /* i-p-j order keeps the inner loop unit-stride */
+    for (size_t i = 0; i < m; i++) {
+        float* c = &C[i * ldc];
+        for (size_t j = 0; j < n; j++) c[j] = 0.0f;
+        for (size_t p = 0; p < k; p++) {
+            float a = A[i * lda + p];
+            const float* b = &B[p * ldb];
+            for (size_t j = 0; j < n; j++) c[j] += a * b[j];
+        }
+    }
+#endif
+}
+
+static small_gemm_fn small_gemm_select(size_t m, size_t n, size_t k) {
+    if (m != n || n != k) return NULL;
+    switch (m) {
+        case 4:  return small_gemm_4;
+        case 8:  return small_gemm_8;
+        case 16: return small_gemm_16;
+        case 32: return small_gemm_32;
+        default: return NULL;
+    }
+}
+
+/* One thread's share of the batch; pointer-array or strided */
+typedef struct {
+    size_t m, n, k;
+    const float* const* Ap; const float* const* Bp; float* const* Cp;
+    const float* A; const float* B; float* C;
+    size_t lda, ldb, ldc;
+    size_t stride_a, stride_b, stride_c;
+    size_t begin, end;
+} batch_range_t;
+
+static void* batch_worker(void* arg) {
+    batch_range_t* r = (batch_range_t*)arg;
+    small_gemm_fn fn = small_gemm_select(r->m, r->n, r->k);
+
+    for (size_t b = r->begin; b < r->end; b++) {
+        const float* A = r->Ap ? r->Ap[b] : r->A + b * r->stride_a;
+        const float* B = r->Bp ? r->Bp[b] : r->B + b * r->stride_b;
+        float*       C = r->Cp ? r->Cp[b] : r->C + b * r->stride_c;
+
+        if (fn != NULL) {
+            fn(A, r->lda, B, r->ldb, C, r->ldc);
+        } else {
+            small_gemm_generic(r->m, r->n, r->k, A, r->lda, B, r->ldb, C, r->ldc);
+        }
+    }
+    return NULL;
+}
+
+static void batch_run(const batch_range_t* proto, size_t batch, int nthreads) {
+    if (nthreads <= 0) nthreads = 1;
+    if ((size_t)nthreads > batch) nthreads = batch ? (int)batch : 1;
+
+    pthread_t tid[nthreads];
+    batch_range_t ranges[nthreads];
+
+    for (int t = 0; t < nthreads; t++) {
+        ranges[t] = *proto;
+        ranges[t].begin = batch * t / nthreads;
+        ranges[t].end   = batch * (t + 1) / nthreads;
+        if (t > 0) pthread_create(&tid[t], NULL, batch_worker, &ranges[t]);
+    }
+
+    batch_worker(&ranges[0]);
+
+    for (int t = 1; t < nthreads; t++) {
+        pthread_join(tid[t], NULL);
+    }
+}
+
+void gemm_batched(size_t m, size_t n, size_t k,
+                  const float* const* A, size_t lda,
+                  const float* const* B, size_t ldb,
+                  float* const* C, size_t ldc,
+                  size_t batch, int nthreads) {
+    batch_range_t proto = {
+        .m = m, .n = n, .k = k,
+        .Ap = A, .Bp = B, .Cp = C,
+        .lda = lda, .ldb = ldb, .ldc = ldc,
+    };
+    batch_run(&proto, batch, nthreads);
+}
+
+void gemm_batched_strided(size_t m, size_t n, size_t k,
+                          const float* A, size_t lda, size_t stride_a,
+                          const float* B, size_t ldb, size_t stride_b,
+                          float* C, size_t ldc, size_t stride_c,
+                          size_t batch, int nthreads) {
+    batch_range_t proto = {
+        .m = m, .n = n, .k = k,
+        .A = A, .B = B, .C = C,
+        .lda = lda, .ldb = ldb, .ldc = ldc,
+        .stride_a = stride_a, .stride_b = stride_b, .stride_c = stride_c,
+    };
+    batch_run(&proto, batch, nthreads);
+}
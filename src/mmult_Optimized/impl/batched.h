@@ -0,0 +1,26 @@
+#ifndef __IMPL_BATCHED_H_
+#define __IMPL_BATCHED_H_
+
+#include <stddef.h>
+
+/* Batched small-matrix GEMM: C[b] = A[b] * B[b] for b < batch, every
+ * product m x k times k x n in row-major order. Square sizes 4, 8, 16
+ * and 32 use kernels fully unrolled at compile time; any other shape
+ * goes through a generic kernel. The batch is split evenly across
+ * nthreads threads (1 if <= 0).                                       */
+
+/* Pointer-array batch */
+void gemm_batched(size_t m, size_t n, size_t k,
+                  const float* const* A, size_t lda,
+                  const float* const* B, size_t ldb,
+                  float* const* C, size_t ldc,
+                  size_t batch, int nthreads);
+
+/* Strided batch: matrix b starts at A + b * stride_a, and so on */
+void gemm_batched_strided(size_t m, size_t n, size_t k,
+                          const float* A, size_t lda, size_t stride_a,
+                          const float* B, size_t ldb, size_t stride_b,
+                          float* C, size_t ldc, size_t stride_c,
+                          size_t batch, int nthreads);
+
+#endif //__IMPL_BATCHED_H_
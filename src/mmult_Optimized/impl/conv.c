@@ -0,0 +1,344 @@
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+
+/* Include common headers */
+#include "common/macros.h"
+
+/* Include application-specific headers */
+#include "include/types.h"
+#include "impl/gemm.h"
+#include "impl/mimd.h"
+#include "impl/conv.h"
+
+#define CONV_MIN(a, b) ((a) < (b) ? (a) : (b))
+#define CONV_CEIL(a, b) (((a) + (b) - 1) / (b))
+
+size_t conv_out_h(const conv_shape_t* s) {
+    return (s->H + 2 * s->pad_h - s->R) / s->stride_h + 1;
+}
+
+size_t conv_out_w(const conv_shape_t* s) {
+    return (s->W + 2 * s->pad_w - s->S) / s->stride_w + 1;
+}
+
+size_t conv_input_elems(const conv_shape_t* s) {
+    return s->N * s->C * s->H * s->W;
+}
+
+size_t conv_filter_elems(const conv_shape_t* s) {
+    return s->K * s->C * s->R * s->S;
+}
+
+size_t conv_output_elems(const conv_shape_t* s) {
+    return s->N * s->K * conv_out_h(s) * conv_out_w(s);
+}
+
+size_t conv_col_elems(const conv_shape_t* s) {
+    size_t per_image = s->C * s->R * s->S * conv_out_h(s) * conv_out_w(s);
+    return s->layout == CONV_NCHW ? per_image : s->N * per_image;
+}
+
+/* GEMM dimensions of the lowering: out (M x N) = A (M x Kd) * B (Kd x N) */
+static void conv_gemm_dims(const conv_shape_t* s, size_t* M, size_t* N, size_t* Kd) {
+    size_t PQ = conv_out_h(s) * conv_out_w(s);
+    *M = s->layout == CONV_NCHW ? s->K : s->N * PQ;
+    *N = s->layout == CONV_NCHW ? PQ : s->K;
+    *Kd = s->C * s->R * s->S;
+}
+
+/* Packing buffer sizes, no larger than the blocks the problem has */
+static void conv_pack_dims(const gemm_blocking_t* blk, size_t M, size_t N, size_t Kd,
+                           size_t* a_elems, size_t* b_elems) {
+    size_t kc = CONV_MIN(blk->kc, Kd);
+    *a_elems = GEMM_ROUND_UP(CONV_MIN(blk->mc, M), GEMM_MR) * kc;
+    *b_elems = GEMM_ROUND_UP(CONV_MIN(blk->nc, N), GEMM_NR) * kc;
+}
+
+size_t conv_implicit_elems(const conv_shape_t* s) {
+    size_t M, N, Kd, a, b;
+    conv_gemm_dims(s, &M, &N, &Kd);
+    conv_pack_dims(gemm_select_blocking(M, N, Kd), M, N, Kd, &a, &b);
+    return a + b;
+}
+
+static double conv_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Input pixel (h, w) of output pixel (p, q) and filter tap (r, t):
+ * signed, as padding puts it before the first row or column        */
+#define CONV_IN_H(s, p, r) ((long)((p) * (s)->stride_h + (r)) - (long)(s)->pad_h)
+#define CONV_IN_W(s, q, t) ((long)((q) * (s)->stride_w + (t)) - (long)(s)->pad_w)
+#define CONV_INSIDE(s, h, w) ((h) >= 0 && (h) < (long)(s)->H && (w) >= 0 && (w) < (long)(s)->W)
+
+void conv_im2col(const conv_shape_t* s, const float* in, size_t n, float* col) {
+    size_t P = conv_out_h(s), Q = conv_out_w(s);
+
+    if (s->layout == CONV_NHWC) {
+        /* Row (n, p, q): for every tap, the C channels of one pixel */
+        for (size_t m = 0; m < s->N * P * Q; m++) {
+            size_t img = m / (P * Q), p = m % (P * Q) / Q, q = m % Q;
+            for (size_t r = 0; r < s->R; r++) {
+                for (size_t t = 0; t < s->S; t++) {
+                    long h = CONV_IN_H(s, p, r), w = CONV_IN_W(s, q, t);
+                    if (CONV_INSIDE(s, h, w)) {
+                        memcpy(col, &in[((img * s->H + h) * s->W + w) * s->C], s->C * sizeof(float));
+                    } else {
+                        memset(col, 0, s->C * sizeof(float));
+                    }
+                    col += s->C;
+                }
+            }
+        }
+        return;
+    }
+
+    /* Row (c, r, t) of image n: the input plane c sampled at every output pixel */
+    const float* img = &in[n * s->C * s->H * s->W];
+    for (size_t c = 0; c < s->C; c++) {
+        const float* plane = &img[c * s->H * s->W];
+        for (size_t r = 0; r < s->R; r++) {
+            for (size_t t = 0; t < s->S; t++) {
+                for (size_t p = 0; p < P; p++) {
+                    long h = CONV_IN_H(s, p, r);
+                    for (size_t q = 0; q < Q; q++) {
+                        long w = CONV_IN_W(s, q, t);
+                        *col++ = CONV_INSIDE(s, h, w) ? plane[h * s->W + w] : 0.0f;
+                    }
+                }
+            }
+        }
+    }
+}
+
+/* R (M x N, ldr) = A (M x K, lda) * B (K x N, ldb) on all threads */
+static void conv_gemm(size_t M, size_t N, size_t K, const float* A, size_t lda,
+                      const float* B, size_t ldb, float* R, size_t ldr, int nthreads) {
+    args_t args;
+    memset(&args, 0, sizeof(args));
+    args.input0 = (void*)A;
+    args.input1 = (void*)B;
+    args.output = R;
+    args.M = M;
+    args.K = K;
+    args.N = N;
+    args.lda = lda;
+    args.ldb = ldb;
+    args.ldr = ldr;
+    args.layout = MMULT_ROW_MAJOR;
+    args.alpha = 1.0f;
+    args.beta = 0.0f;
+    args.nthreads = nthreads;
+    impl_mimd(&args);
+}
+
+void conv_explicit(const conv_shape_t* s, const float* in, const float* filters,
+                   float* out, float* col, int nthreads, double* t_lower) {
+    size_t PQ = conv_out_h(s) * conv_out_w(s), CRS = s->C * s->R * s->S;
+    double lower = 0.0, t0;
+
+    if (s->layout == CONV_NHWC) {
+        t0 = conv_now();
+        conv_im2col(s, in, 0, col);
+        lower += conv_now() - t0;
+        conv_gemm(s->N * PQ, s->K, CRS, col, CRS, filters, s->K, out, s->K, nthreads);
+    } else {
+        for (size_t n = 0; n < s->N; n++) {
+            t0 = conv_now();
+            conv_im2col(s, in, n, col);
+            lower += conv_now() - t0;
+            conv_gemm(s->K, PQ, CRS, filters, CRS, col, PQ, &out[n * s->K * PQ], PQ, nthreads);
+        }
+    }
+    if (t_lower != NULL) *t_lower = lower;
+}
+
+/* ------------------------------------------------------------------ */
+/* Implicit lowering                                                   */
+/* ------------------------------------------------------------------ */
+
+/* NHWC: pack rows [m0, m0 + mc) x reduction [k0, k0 + kc) of col into
+ * MR-row micro-panels. Reduction index k is (r, t, c), c fastest, so
+ * every tap of a row is a contiguous run of input channels.        */
+static void conv_pack_a_nhwc(const conv_shape_t* s, const float* in, size_t P, size_t Q,
+                             size_t m0, size_t mc, size_t k0, size_t kc, float* Ap) {
+    for (size_t i0 = 0; i0 < mc; i0 += GEMM_MR) {
+        float* panel = &Ap[i0 * kc];
+
+        for (size_t i = 0; i < GEMM_MR; i++) {
+            if (i0 + i >= mc) {
+                for (size_t k = 0; k < kc; k++) panel[k * GEMM_MR + i] = 0.0f;
+                continue;
+            }
+            size_t m = m0 + i0 + i;
+            size_t img = m / (P * Q), p = m % (P * Q) / Q, q = m % Q;
+
+            for (size_t k = k0; k < k0 + kc;) {
+                size_t tap = k / s->C, c = k % s->C;
+                size_t len = CONV_MIN(s->C - c, k0 + kc - k);
+                long h = CONV_IN_H(s, p, tap / s->S), w = CONV_IN_W(s, q, tap % s->S);
+                float* dst = &panel[(k - k0) * GEMM_MR + i];
+
+                if (CONV_INSIDE(s, h, w)) {
+                    const float* src = &in[((img * s->H + h) * s->W + w) * s->C + c];
+                    for (size_t x = 0; x < len; x++) dst[x * GEMM_MR] = src[x];
+                } else {
+                    for (size_t x = 0; x < len; x++) dst[x * GEMM_MR] = 0.0f;
+                }
+                k += len;
+            }
+        }
+    }
+}
+
+/* NCHW: pack reduction [k0, k0 + kc) x pixels [j0, j0 + nc) of col for
+ * one image into NR-column micro-panels; k is (c, r, t), t fastest  */
+static void conv_pack_b_nchw(const conv_shape_t* s, const float* img, size_t Q,
+                             size_t j0, size_t nc, size_t k0, size_t kc, float* Bp) {
+    size_t RS = s->R * s->S;
+
+    for (size_t jp = 0; jp < nc; jp += GEMM_NR) {
+        size_t nr = CONV_MIN(GEMM_NR, nc - jp);
+        float* panel = &Bp[jp * kc];
+        long h0[GEMM_NR], w0[GEMM_NR];
+        for (size_t c = 0; c < nr; c++) {
+            size_t j = j0 + jp + c;
+            h0[c] = CONV_IN_H(s, j / Q, 0);
+            w0[c] = CONV_IN_W(s, j % Q, 0);
+        }
+
+        for (size_t k = k0; k < k0 + kc; k++) {
+            const float* plane = &img[k / RS * s->H * s->W];
+            long r = (long)(k % RS / s->S), t = (long)(k % s->S);
+            float* dst = &panel[(k - k0) * GEMM_NR];
+
+            for (size_t c = 0; c < nr; c++) {
+                long h = h0[c] + r, w = w0[c] + t;
+                dst[c] = CONV_INSIDE(s, h, w) ? plane[h * s->W + w] : 0.0f;
+            }
+            for (size_t c = nr; c < GEMM_NR; c++) dst[c] = 0.0f;
+        }
+    }
+}
+
+typedef struct {
+    const conv_shape_t* s;
+    const float* in;
+    const float* filters;
+    float* out;
+    size_t P, Q;
+    const gemm_blocking_t* blk;
+
+    /* NHWC: rows of out split in contiguous ranges */
+    int nthreads;
+    /* NCHW: (image, pixel chunk) items handed out in order */
+    size_t chunk, nchunks;
+    size_t next_item;
+} conv_shared_t;
+
+typedef struct {
+    conv_shared_t* shared;
+    int tid;
+    pthread_t thread;
+} conv_thread_t;
+
+static void* conv_worker(void* arg) {
+    conv_thread_t* self = (conv_thread_t*)arg;
+    conv_shared_t* sh = self->shared;
+    const conv_shape_t* s = sh->s;
+    size_t MC = sh->blk->mc, KC = sh->blk->kc, NC = sh->blk->nc;
+    size_t PQ = sh->P * sh->Q, M, N, CRS, a_elems, b_elems;
+    conv_gemm_dims(s, &M, &N, &CRS);
+    conv_pack_dims(sh->blk, M, s->layout == CONV_NCHW ? sh->chunk : N, CRS, &a_elems, &b_elems);
+    float* Ap = __ALLOC_DATA(float, a_elems);
+    float* Bp = __ALLOC_DATA(float, b_elems);
+
+    if (s->layout == CONV_NHWC) {
+        /* out (NPQ x K) = col (NPQ x CRS) * filters (CRS x K), this thread's rows */
+        size_t panels = CONV_CEIL(M, GEMM_MR);
+        size_t m0 = CONV_MIN(panels * self->tid / sh->nthreads * GEMM_MR, M);
+        size_t m1 = CONV_MIN(panels * (self->tid + 1) / sh->nthreads * GEMM_MR, M);
+
+        for (size_t jc = 0; jc < s->K; jc += NC) {
+            size_t nc = CONV_MIN(NC, s->K - jc);
+            for (size_t pc = 0; pc < CRS; pc += KC) {
+                size_t kc = CONV_MIN(KC, CRS - pc);
+                gemm_pack_b(kc, nc, &sh->filters[pc * s->K + jc], s->K, 0, Bp);
+
+                for (size_t ic = m0; ic < m1; ic += MC) {
+                    size_t mc = CONV_MIN(MC, m1 - ic);
+                    conv_pack_a_nhwc(s, sh->in, sh->P, sh->Q, ic, mc, pc, kc, Ap);
+                    gemm_macro_kernel(mc, nc, kc, Ap, Bp, &sh->out[ic * s->K + jc], s->K,
+                                      1.0f, pc > 0 ? 1.0f : 0.0f, NULL);
+                }
+            }
+        }
+    } else {
+        /* out_n (K x PQ) = filters (K x CRS) * col_n (CRS x PQ), one chunk of pixels at a time */
+        size_t item;
+        while ((item = __atomic_fetch_add(&sh->next_item, 1, __ATOMIC_RELAXED)) < s->N * sh->nchunks) {
+            size_t n = item / sh->nchunks;
+            size_t j0 = item % sh->nchunks * sh->chunk, nc = CONV_MIN(sh->chunk, PQ - j0);
+            const float* img = &sh->in[n * s->C * s->H * s->W];
+            float* out = &sh->out[n * s->K * PQ];
+
+            for (size_t pc = 0; pc < CRS; pc += KC) {
+                size_t kc = CONV_MIN(KC, CRS - pc);
+                conv_pack_b_nchw(s, img, sh->Q, j0, nc, pc, kc, Bp);
+
+                for (size_t ic = 0; ic < s->K; ic += MC) {
+                    size_t mc = CONV_MIN(MC, s->K - ic);
+                    gemm_pack_a(mc, kc, &sh->filters[ic * CRS + pc], CRS, 0, Ap);
+                    gemm_macro_kernel(mc, nc, kc, Ap, Bp, &out[ic * PQ + j0], PQ,
+                                      1.0f, pc > 0 ? 1.0f : 0.0f, NULL);
+                }
+            }
+        }
+    }
+
+    free(Ap);
+    free(Bp);
+    return NULL;
+}
+
+void conv_implicit(const conv_shape_t* s, const float* in, const float* filters,
+                   float* out, int nthreads) {
+    if (nthreads <= 0) {
+        long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+        nthreads = ncpus > 0 ? (int)ncpus : 1;
+    }
+
+    conv_shared_t sh = { .s = s, .in = in, .filters = filters, .out = out,
+                         .P = conv_out_h(s), .Q = conv_out_w(s), .nthreads = nthreads };
+    size_t M, N, Kd, PQ = sh.P * sh.Q;
+    conv_gemm_dims(s, &M, &N, &Kd);
+    sh.blk = gemm_select_blocking(M, N, Kd);
+
+    if (s->layout == CONV_NCHW) {
+        /* Chunks narrow enough that every thread gets one */
+        sh.chunk = GEMM_ROUND_UP(CONV_CEIL(s->N * PQ, (size_t)nthreads), GEMM_NR);
+        sh.chunk = CONV_MIN(CONV_MIN(sh.chunk, sh.blk->nc), GEMM_ROUND_UP(PQ, GEMM_NR));
+        sh.nchunks = CONV_CEIL(PQ, sh.chunk);
+        sh.next_item = 0;
+    }
+
+    conv_thread_t threads[nthreads];
+    for (int t = 0; t < nthreads; t++) {
+        threads[t].shared = &sh;
+        threads[t].tid = t;
+        if (t > 0) pthread_create(&threads[t].thread, NULL, conv_worker, &threads[t]);
+    }
+
+    conv_worker(&threads[0]);
+
+    for (int t = 1; t < nthreads; t++) {
+        pthread_join(threads[t].thread, NULL);
+    }
+}
@@ -0,0 +1,66 @@
+/* conv.h
+ *
+ * 2D convolution (cross-correlation, as in CNN layers) lowered to GEMM.
+ * For an input of N images of C x H x W and K filters of C x R x S, the
+ * output has P x Q pixels per channel, P = (H + 2 pad_h - R) / stride_h
+ * + 1 and Q alike. With the layouts
+ *
+ *  - NCHW: input N x C x H x W, filters K x C x R x S, output N x K x P x Q
+ *          out_n (K x PQ) = filters (K x CRS) * col_n (CRS x PQ)
+ *  - NHWC: input N x H x W x C, filters R x S x C x K, output N x P x Q x K
+ *          out (NPQ x K)  = col (NPQ x RSC) * filters (RSC x K)
+ *
+ * the explicit lowering materializes col with im2col (one image at a
+ * time for NCHW) and calls the multithreaded packed GEMM. The implicit
+ * lowering runs the blocked GEMM loop itself and gathers the micro-
+ * panels of col straight from the input while packing, so col never
+ * exists beyond one MC x KC (NHWC) or KC x NC (NCHW) block per thread.
+ */
+
+#ifndef __IMPL_CONV_H_
+#define __IMPL_CONV_H_
+
+#include <stddef.h>
+
+typedef enum {
+    CONV_NCHW = 0,
+    CONV_NHWC = 1
+} conv_layout_t;
+
+typedef struct {
+    size_t N, C, H, W;            /* Input                          */
+    size_t K, R, S;               /* K filters of C x R x S         */
+    size_t stride_h, stride_w;    /* >= 1                           */
+    size_t pad_h, pad_w;          /* Zero padding on every side     */
+    conv_layout_t layout;
+} conv_shape_t;
+
+/* Output height and width */
+size_t conv_out_h(const conv_shape_t* s);
+size_t conv_out_w(const conv_shape_t* s);
+
+/* Floats of the input, filters and output */
+size_t conv_input_elems(const conv_shape_t* s);
+size_t conv_filter_elems(const conv_shape_t* s);
+size_t conv_output_elems(const conv_shape_t* s);
+
+/* Floats of the im2col buffer of the explicit lowering */
+size_t conv_col_elems(const conv_shape_t* s);
+
+/* Floats of packing space the implicit lowering takes per thread */
+size_t conv_implicit_elems(const conv_shape_t* s);
+
+/* col for image n (NCHW) or for all images (NHWC, n ignored) */
+void conv_im2col(const conv_shape_t* s, const float* in, size_t n, float* col);
+
+/* out = conv(in, filters); col holds conv_col_elems floats. The GEMM
+ * runs on nthreads threads (<= 0: all CPUs). t_lower, if not NULL,
+ * receives the seconds spent in im2col.                             */
+void conv_explicit(const conv_shape_t* s, const float* in, const float* filters,
+                   float* out, float* col, int nthreads, double* t_lower);
+
+/* out = conv(in, filters) without an im2col buffer */
+void conv_implicit(const conv_shape_t* s, const float* in, const float* filters,
+                   float* out, int nthreads);
+
+#endif //__IMPL_CONV_H_
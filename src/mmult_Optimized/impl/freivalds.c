@@ -0,0 +1,261 @@
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+/*  -> SIMD header file  */
+#if defined(__amd64__) || defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+/* Include common headers */
+#include "common/macros.h"
+#include "common/types.h"
+
+/* Include application-specific headers */
+#include "include/types.h"
+#include "include/layout.h"
+#include "impl/freivalds.h"
+
+int freivalds_rounds(double fp_prob) {
+    if (!(fp_prob > 0.0) || fp_prob >= 1.0) return 1;
+    int k = (int)ceil(-log2(fp_prob));
+    return k > 0 ? k : 1;
+}
+
+float freivalds_default_tol(size_t K) {
+    return 2.0f * (float)(K > 0 ? K : 1) * FLT_EPSILON;
+}
+
+/* Widen a float row to double, by absolute value if asked */
+static void fv_widen(double* dst, const float* a, size_t n, int absval) {
+    size_t j = 0;
+#if defined(__AVX2__)
+    __m256 sign = _mm256_set1_ps(absval ? -0.0f : 0.0f);
+    for (; j + 8 <= n; j += 8) {
+        __m256 v = _mm256_andnot_ps(sign, _mm256_loadu_ps(a + j));
+        _mm256_storeu_pd(dst + j, _mm256_cvtps_pd(_mm256_castps256_ps128(v)));
+        _mm256_storeu_pd(dst + j + 4, _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1)));
+    }
+#endif
+    for (; j < n; j++) dst[j] = absval ? fabs((double)a[j]) : (double)a[j];
+}
+
+static double fv_dot(const double* a, const double* x, size_t n) {
+    size_t j = 0;
+    double sum = 0.0;
+#if defined(__AVX2__) && defined(__FMA__)
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    for (; j + 8 <= n; j += 8) {
+        acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + j), _mm256_loadu_pd(x + j), acc0);
+        acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(a + j + 4), _mm256_loadu_pd(x + j + 4), acc1);
+    }
+    __m256d acc = _mm256_add_pd(acc0, acc1);
+    __m128d s = _mm_add_pd(_mm256_castpd256_pd128(acc), _mm256_extractf128_pd(acc, 1));
+    sum = _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+#endif
+    for (; j < n; j++) sum += a[j] * x[j];
+    return sum;
+}
+
+/* y[0..n) += s * a[0..n) */
+static void fv_axpy(double* y, const double* a, double s, size_t n) {
+    size_t j = 0;
+#if defined(__AVX2__) && defined(__FMA__)
+    __m256d vs = _mm256_set1_pd(s);
+    for (; j + 4 <= n; j += 4) {
+        _mm256_storeu_pd(y + j, _mm256_fmadd_pd(vs, _mm256_loadu_pd(a + j), _mm256_loadu_pd(y + j)));
+    }
+#endif
+    for (; j < n; j++) y[j] += s * a[j];
+}
+
+/* Matrix-vector products Y = op(X) (rows x cols) * Xv for nvec vectors
+ * at once, so X is streamed from memory a single time. X is row-major;
+ * `trans` means it is stored cols x rows. Vector v of the input starts
+ * at x[v * cols] and of the output at y[v * rows].                   */
+typedef struct {
+    const float* X; size_t ld;
+    int trans, absval;
+    size_t rows, cols;
+    int nvec;
+    const double* x;
+    double* y;
+} fv_gemv_t;
+
+typedef struct {
+    const fv_gemv_t* op;
+    size_t r0, r1;
+    int failed;               /* Set when the worker ran out of memory */
+} fv_task_t;
+
+static void* fv_gemv_worker(void* arg) {
+    fv_task_t* t = (fv_task_t*)arg;
+    const fv_gemv_t* op = t->op;
+    size_t len = op->trans ? t->r1 - t->r0 : op->cols;
+    double* buf = malloc((len ? len : 1) * sizeof(double));
+    if (buf == NULL) {
+        t->failed = 1;
+        return NULL;
+    }
+
+    if (!op->trans) {
+        /* Rows of X are contiguous: widen once, one dot per vector */
+        for (size_t i = t->r0; i < t->r1; i++) {
+            fv_widen(buf, &op->X[i * op->ld], op->cols, op->absval);
+            for (int v = 0; v < op->nvec; v++) {
+                op->y[v * op->rows + i] = fv_dot(buf, &op->x[v * op->cols], op->cols);
+            }
+        }
+    } else {
+        /* Outputs are contiguous in every stored row: accumulate the
+         * slice [r0, r1) of each stored row scaled by its x entries  */
+        for (int v = 0; v < op->nvec; v++) {
+            memset(&op->y[v * op->rows + t->r0], 0, len * sizeof(double));
+        }
+        for (size_t j = 0; j < op->cols; j++) {
+            fv_widen(buf, &op->X[j * op->ld + t->r0], len, op->absval);
+            for (int v = 0; v < op->nvec; v++) {
+                fv_axpy(&op->y[v * op->rows + t->r0], buf, op->x[v * op->cols + j], len);
+            }
+        }
+    }
+
+    free(buf);
+    return NULL;
+}
+
+/* 0, or -1 if a worker could not allocate its buffer */
+static int fv_gemv(const fv_gemv_t* op, int nthreads) {
+    if ((size_t)nthreads > op->rows) nthreads = op->rows > 0 ? (int)op->rows : 1;
+
+    pthread_t tid[nthreads];
+    fv_task_t tasks[nthreads];
+    for (int t = 0; t < nthreads; t++) {
+        tasks[t].op = op;
+        tasks[t].r0 = op->rows * t / nthreads;
+        tasks[t].r1 = op->rows * (t + 1) / nthreads;
+        tasks[t].failed = 0;
+        if (t > 0) pthread_create(&tid[t], NULL, fv_gemv_worker, &tasks[t]);
+    }
+
+    fv_gemv_worker(&tasks[0]);
+
+    int failed = tasks[0].failed;
+    for (int t = 1; t < nthreads; t++) {
+        pthread_join(tid[t], NULL);
+        failed |= tasks[t].failed;
+    }
+    return failed ? -1 : 0;
+}
+
+static double fv_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* xorshift64*, so the vectors only depend on the seed */
+static uint64_t fv_next(uint64_t* s) {
+    *s ^= *s >> 12;
+    *s ^= *s << 25;
+    *s ^= *s >> 27;
+    return *s * 0x2545F4914F6CDD1DULL;
+}
+
+/* Work vectors of one verification */
+typedef struct {
+    double *x, *y, *z, *w, *w0, *bound;
+} fv_work_t;
+
+/* The checks proper on allocated work vectors; 0, 1 or -1 as below */
+static int fv_check(const mmult_view_t* v, const float* R0, int rounds, float tol, int nthreads,
+                    unsigned int seed, const fv_work_t* b, freivalds_result_t* res) {
+    int use_r0 = v->beta != 0.0f;
+    size_t M = v->M, N = v->N, K = v->K;
+    size_t k = (size_t)rounds;
+    double *x = b->x, *y = b->y, *z = b->z, *w = b->w, *w0 = b->w0, *bound = b->bound;
+
+    /* Error scale per row: |alpha| |op(A)| |op(B)| 1 + |beta| |R0| 1 */
+    for (size_t j = 0; j < N; j++) x[j] = 1.0;
+    fv_gemv_t opB  = { v->B, v->ldb, v->transb, 1, K, N, 1, x, y };
+    fv_gemv_t opA  = { v->A, v->lda, v->transa, 1, M, K, 1, y, z };
+    fv_gemv_t opR  = { v->R, v->ldr, 0, 0, M, N, rounds, x, w };
+    fv_gemv_t opR0 = { R0,   v->ldr, 0, 1, M, N, 1, x, w0 };
+    if (fv_gemv(&opB, nthreads) != 0 || fv_gemv(&opA, nthreads) != 0 ||
+        (use_r0 && fv_gemv(&opR0, nthreads) != 0)) {
+        return -1;
+    }
+    for (size_t i = 0; i < M; i++) {
+        bound[i] = fabs((double)v->alpha) * z[i] + (use_r0 ? fabs((double)v->beta) * w0[i] : 0.0);
+    }
+
+    /* All random vectors go through each matrix in one pass */
+    uint64_t state = 0x9E3779B97F4A7C15ULL ^ seed;
+    for (size_t j = 0; j < N * k; j++) x[j] = (fv_next(&state) >> 63) ? 1.0 : -1.0;
+
+    opB.absval = opA.absval = opR0.absval = 0;
+    opB.nvec = opA.nvec = opR0.nvec = rounds;
+    if (fv_gemv(&opB, nthreads) != 0 || fv_gemv(&opA, nthreads) != 0 ||
+        fv_gemv(&opR, nthreads) != 0 || (use_r0 && fv_gemv(&opR0, nthreads) != 0)) {
+        return -1;
+    }
+
+    int failed = 0;
+    for (size_t r = 0; r < k; r++) {
+        for (size_t i = 0; i < M; i++) {
+            double expect = (double)v->alpha * z[r * M + i] + (use_r0 ? (double)v->beta * w0[r * M + i] : 0.0);
+            double diff = fabs(w[r * M + i] - expect);
+            /* A zero bound still allows for denormal noise; NaN fails */
+            double err = diff / fmax(tol * bound[i], DBL_MIN);
+            if (!(err <= 1.0)) {
+                if (!failed || i < res->bad_row) res->bad_row = i;
+                failed = 1;
+            }
+            if (!(err <= res->max_error)) res->max_error = err;
+        }
+    }
+    return failed;
+}
+
+int freivalds_verify(const args_t* args, const float* R0, int rounds, float tol,
+                     int nthreads, unsigned int seed, freivalds_result_t* res) {
+    mmult_view_t v = mmult_row_major_view(args);
+    double start = fv_now();
+
+    memset(res, 0, sizeof(*res));
+    res->bad_row = (size_t)-1;
+    if (v.epi.ops || (v.beta != 0.0f && R0 == NULL)) return -1;
+
+    if (nthreads <= 0) nthreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (nthreads <= 0) nthreads = 1;
+    if (rounds <= 0) rounds = 1;
+    if (tol <= 0.0f) tol = freivalds_default_tol(v.K);
+    res->rounds = rounds;
+    res->tol = tol;
+
+    size_t k = (size_t)rounds;
+    size_t nx = v.N * k, ny = v.K * k, nz = v.M * k;
+
+    fv_work_t b;
+    b.x     = malloc((nx > 0 ? nx : 1) * sizeof(double));
+    b.y     = malloc((ny > 0 ? ny : 1) * sizeof(double));
+    b.z     = malloc((nz > 0 ? nz : 1) * sizeof(double));
+    b.w     = malloc((nz > 0 ? nz : 1) * sizeof(double));
+    b.w0    = malloc((nz > 0 ? nz : 1) * sizeof(double));
+    b.bound = malloc((v.M > 0 ? v.M : 1) * sizeof(double));
+
+    int failed = -1;
+    if (b.x && b.y && b.z && b.w && b.w0 && b.bound) {
+        failed = fv_check(&v, R0, rounds, tol, nthreads, seed, &b, res);
+    }
+
+    free(b.x); free(b.y); free(b.z); free(b.w); free(b.w0); free(b.bound);
+    res->seconds = fv_now() - start;
+    return failed;
+}
@@ -0,0 +1,45 @@
+/* freivalds.h
+ *
+ * Randomized verification of a product (Freivalds' algorithm). For a
+ * random vector x of +/-1 entries, R = alpha * op(A) * op(B) + beta * R0
+ * implies R x = alpha * op(A) (op(B) x) + beta * R0 x, which costs three
+ * or four matrix-vector products instead of a multiplication. A wrong R
+ * survives one vector with probability at most 1/2, so k vectors bound
+ * the false-positive probability by 2^-k. Rows are compared against
+ * tol times the same products taken on absolute values, i.e. the scale
+ * rounding errors of the original product can reach.
+ */
+
+#ifndef __IMPL_FREIVALDS_H_
+#define __IMPL_FREIVALDS_H_
+
+#include <stddef.h>
+
+#include "include/types.h"
+
+/* Outcome of a verification */
+typedef struct {
+    int rounds;             /* Random vectors used                       */
+    float tol;              /* Relative tolerance actually applied       */
+    double max_error;       /* Largest |difference| / bound over all rows */
+    size_t bad_row;         /* First failing row of the row-major view   */
+    double seconds;
+} freivalds_result_t;
+
+/* Vectors needed to push the false-positive probability below p */
+int freivalds_rounds(double fp_prob);
+
+/* Default tolerance for a product of depth K: the worst-case relative
+ * rounding error of a float dot product of that length, doubled.    */
+float freivalds_default_tol(size_t K);
+
+/* Check args->output against the product described by args. R0 is the
+ * incoming R (same layout and ldr) and is only used when beta != 0.
+ * tol <= 0 selects freivalds_default_tol. nthreads <= 0 uses all CPUs.
+ * Returns 0 if R passes, 1 if it is wrong, -1 if it cannot be checked
+ * (an epilogue makes the result non-linear, R0 is missing, or the
+ * work buffers cannot be allocated).                                 */
+int freivalds_verify(const args_t* args, const float* R0, int rounds, float tol,
+                     int nthreads, unsigned int seed, freivalds_result_t* res);
+
+#endif //__IMPL_FREIVALDS_H_
@@ -0,0 +1,435 @@
+/* gemm.c
+ *
+ * Packing routines, micro-kernel and the three-level blocked driver of
+ * the packed GEMM engine. See gemm.h for the blocking scheme.
+ */
+
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+/*  -> SIMD header file  */
+#if defined(__amd64__) || defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+/* Include common headers */
+#include "common/macros.h"
+#include "common/types.h"
+
+/* Include application-specific headers */
+#include "include/layout.h"
+#include "impl/gemm.h"
+#include "impl/gemv.h"
+#include "impl/transpose.h"
+
+const gemm_blocking_t gemm_default_blocking = {
+    .mc = 144,    /* 144 x 256 floats = 144KB of packed A  */
+    .kc = 256,    /* 256 x  16 floats =  16KB per B panel   */
+    .nc = 4080,   /* 256 x 4080 floats = ~4MB of packed B  */
+};
+
+const gemm_blocking_t gemm_shape_blocking[GEMM_NUM_SHAPES] = {
+    [GEMM_SHAPE_SQUARE]      = { .mc = 144, .kc = 256, .nc = 4080 },
+    /* Narrow B: deeper slices amortize C updates, A blocks stay in L2 */
+    [GEMM_SHAPE_TALL_SKINNY] = { .mc =  96, .kc = 512, .nc = 4080 },
+    /* Few rows: one deep A block is reused across all of B          */
+    [GEMM_SHAPE_SHORT_WIDE]  = { .mc =  72, .kc = 512, .nc = 2040 },
+    /* Shallow K: taller A blocks and wider B panels for the same bytes */
+    [GEMM_SHAPE_SMALL_K]     = { .mc = 288, .kc = 128, .nc = 8160 },
+};
+
+/* Aspect ratio beyond which a product is treated as skinny */
+#define GEMM_SKINNY_RATIO 4
+#define GEMM_SMALL_K      128
+
+gemm_shape_t gemm_classify_shape(size_t M, size_t N, size_t K) {
+    if (K <= GEMM_SMALL_K) return GEMM_SHAPE_SMALL_K;
+    if (M >= GEMM_SKINNY_RATIO * N) return GEMM_SHAPE_TALL_SKINNY;
+    if (N >= GEMM_SKINNY_RATIO * M) return GEMM_SHAPE_SHORT_WIDE;
+    return GEMM_SHAPE_SQUARE;
+}
+
+const char* gemm_shape_name(gemm_shape_t shape) {
+    switch (shape) {
+        case GEMM_SHAPE_SQUARE:      return "square";
+        case GEMM_SHAPE_TALL_SKINNY: return "tall-skinny";
+        case GEMM_SHAPE_SHORT_WIDE:  return "short-wide";
+        case GEMM_SHAPE_SMALL_K:     return "small-k";
+        default:                     return "unknown";
+    }
+}
+
+const gemm_blocking_t* gemm_select_blocking(size_t M, size_t N, size_t K) {
+    return &gemm_shape_blocking[gemm_classify_shape(M, N, K)];
+}
+
+void gemm_pack_a(size_t mc, size_t kc, const float* A, size_t lda, int trans, float* Ap) {
+    for (size_t i = 0; i < mc; i += GEMM_MR) {
+        size_t mr = (mc - i < GEMM_MR) ? mc - i : GEMM_MR;
+
+        size_t p = 0;
+#if defined(__AVX__)
+        /* A full panel of plain A is an MR x kc block stored row by row:
+         * 8 columns at a time go through a register transpose, with two
+         * zero rows to fill the 8 x 8 and only MR lanes stored back     */
+        if (!trans && mr == GEMM_MR) {
+            const __m256i mask = _mm256_setr_epi32(-1, -1, -1, -1, -1, -1, 0, 0);
+            for (; p + 8 <= kc; p += 8) {
+                __m256 r[8];
+                for (size_t q = 0; q < GEMM_MR; q++) r[q] = _mm256_loadu_ps(&A[(i + q) * lda + p]);
+                r[6] = r[7] = _mm256_setzero_ps();
+                transpose_8x8_regs(r);
+                for (size_t q = 0; q < 8; q++) _mm256_maskstore_ps(&Ap[q * GEMM_MR], mask, r[q]);
+                Ap += 8 * GEMM_MR;
+            }
+        }
+#endif
+        for (; p < kc; p++) {
+            /* Transposed A holds the MR rows of a panel contiguously */
+            if (trans) {
+                for (size_t r = 0; r < mr; r++) {
+                    Ap[r] = A[p * lda + i + r];
+                }
+            } else {
+                for (size_t r = 0; r < mr; r++) {
+                    Ap[r] = A[(i + r) * lda + p];
+                }
+            }
+            for (size_t r = mr; r < GEMM_MR; r++) {
+                Ap[r] = 0.0f;
+            }
+            Ap += GEMM_MR;
+        }
+    }
+}
+
+void gemm_pack_b(size_t kc, size_t nc, const float* B, size_t ldb, int trans, float* Bp) {
+    for (size_t j = 0; j < nc; j += GEMM_NR) {
+        size_t nr = (nc - j < GEMM_NR) ? nc - j : GEMM_NR;
+
+        if (trans) {
+            /* Column c of the panel is row j + c of the stored B */
+            size_t p0 = 0;
+#if defined(__AVX__)
+            /* A full panel is two 8-row strips, transposed 8 x 8 at a time */
+            if (nr == GEMM_NR) {
+                for (; p0 + 8 <= kc; p0 += 8) {
+                    transpose_8x8(&B[j * ldb + p0], ldb, &Bp[p0 * GEMM_NR], GEMM_NR);
+                    transpose_8x8(&B[(j + 8) * ldb + p0], ldb, &Bp[p0 * GEMM_NR + 8], GEMM_NR);
+                }
+            }
+#endif
+            for (size_t c = 0; c < nr; c++) {
+                const float* b = &B[(j + c) * ldb];
+                for (size_t p = p0; p < kc; p++) {
+                    Bp[p * GEMM_NR + c] = b[p];
+                }
+            }
+            for (size_t c = nr; c < GEMM_NR; c++) {
+                for (size_t p = 0; p < kc; p++) {
+                    Bp[p * GEMM_NR + c] = 0.0f;
+                }
+            }
+            Bp += kc * GEMM_NR;
+            continue;
+        }
+
+        for (size_t p = 0; p < kc; p++) {
+            const float* b = &B[p * ldb + j];
+            if (nr == GEMM_NR) {
+                memcpy(Bp, b, GEMM_NR * sizeof(float));
+            } else {
+                for (size_t c = 0; c < nr; c++) {
+                    Bp[c] = b[c];
+                }
+                for (size_t c = nr; c < GEMM_NR; c++) {
+                    Bp[c] = 0.0f;
+                }
+            }
+            Bp += GEMM_NR;
+        }
+    }
+}
+
+#if defined(__AVX2__) && defined(__FMA__)
+/* 6 x 16 tile: 12 accumulators, 2 B vectors and 1 A broadcast live in
+ * the 16 ymm registers. `ops` is a compile-time constant in every
+ * instantiation below, so unused epilogue steps compile away.        */
+static inline __attribute__((always_inline))
+void ukernel_6x16(size_t kc, const float* Ap, const float* Bp, float* C, size_t ldc,
+                  float alpha, float beta, const unsigned ops, const mmult_epilogue_t* epi) {
+    __m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps();
+    __m256 c10 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+    __m256 c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps();
+    __m256 c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps();
+    __m256 c40 = _mm256_setzero_ps(), c41 = _mm256_setzero_ps();
+    __m256 c50 = _mm256_setzero_ps(), c51 = _mm256_setzero_ps();
+
+    for (size_t p = 0; p < kc; p++) {
+        __m256 b0 = _mm256_load_ps(Bp);
+        __m256 b1 = _mm256_load_ps(Bp + 8);
+        __m256 a;
+
+        a = _mm256_broadcast_ss(Ap + 0);
+        c00 = _mm256_fmadd_ps(a, b0, c00); c01 = _mm256_fmadd_ps(a, b1, c01);
+        a = _mm256_broadcast_ss(Ap + 1);
+        c10 = _mm256_fmadd_ps(a, b0, c10); c11 = _mm256_fmadd_ps(a, b1, c11);
+        a = _mm256_broadcast_ss(Ap + 2);
+        c20 = _mm256_fmadd_ps(a, b0, c20); c21 = _mm256_fmadd_ps(a, b1, c21);
+        a = _mm256_broadcast_ss(Ap + 3);
+        c30 = _mm256_fmadd_ps(a, b0, c30); c31 = _mm256_fmadd_ps(a, b1, c31);
+        a = _mm256_broadcast_ss(Ap + 4);
+        c40 = _mm256_fmadd_ps(a, b0, c40); c41 = _mm256_fmadd_ps(a, b1, c41);
+        a = _mm256_broadcast_ss(Ap + 5);
+        c50 = _mm256_fmadd_ps(a, b0, c50); c51 = _mm256_fmadd_ps(a, b1, c51);
+
+        Ap += GEMM_MR;
+        Bp += GEMM_NR;
+    }
+
+    /* C = alpha * acc + beta * C; C is not read when beta is zero */
+    __m256 va = _mm256_set1_ps(alpha), vb = _mm256_set1_ps(beta);
+
+    /* Epilogue operands, loaded once per tile */
+    __m256 cb0 = _mm256_setzero_ps(), cb1 = _mm256_setzero_ps();
+    __m256 vlo = _mm256_setzero_ps(), vhi = _mm256_setzero_ps(), vs = _mm256_setzero_ps();
+    if (ops & MMULT_EPI_COL_BIAS) {
+        cb0 = _mm256_loadu_ps(epi->col_bias);
+        cb1 = _mm256_loadu_ps(epi->col_bias + 8);
+    }
+    if (ops & MMULT_EPI_CLAMP) {
+        vlo = _mm256_set1_ps(epi->lo);
+        vhi = _mm256_set1_ps(epi->hi);
+    }
+    if (ops & MMULT_EPI_SCALE) vs = _mm256_set1_ps(epi->scale);
+
+#define __STORE_ROW(r, lo, hi) {                                          \
+    float* c = C + (r) * ldc;                                             \
+    lo = _mm256_mul_ps(lo, va);                                           \
+    hi = _mm256_mul_ps(hi, va);                                           \
+    if (beta != 0.0f) {                                                   \
+        lo = _mm256_fmadd_ps(vb, _mm256_loadu_ps(c), lo);                 \
+        hi = _mm256_fmadd_ps(vb, _mm256_loadu_ps(c + 8), hi);             \
+    }                                                                     \
+    if (ops & MMULT_EPI_ROW_BIAS) {                                       \
+        __m256 rb = _mm256_broadcast_ss(&epi->row_bias[r]);               \
+        lo = _mm256_add_ps(lo, rb);                                       \
+        hi = _mm256_add_ps(hi, rb);                                       \
+    }                                                                     \
+    if (ops & MMULT_EPI_COL_BIAS) {                                       \
+        lo = _mm256_add_ps(lo, cb0);                                      \
+        hi = _mm256_add_ps(hi, cb1);                                      \
+    }                                                                     \
+    if (ops & MMULT_EPI_RELU) {                                           \
+        lo = _mm256_max_ps(lo, _mm256_setzero_ps());                      \
+        hi = _mm256_max_ps(hi, _mm256_setzero_ps());                      \
+    }                                                                     \
+    if (ops & MMULT_EPI_CLAMP) {                                          \
+        lo = _mm256_min_ps(_mm256_max_ps(lo, vlo), vhi);                  \
+        hi = _mm256_min_ps(_mm256_max_ps(hi, vlo), vhi);                  \
+    }                                                                     \
+    if (ops & MMULT_EPI_SCALE) {                                          \
+        lo = _mm256_mul_ps(lo, vs);                                       \
+        hi = _mm256_mul_ps(hi, vs);                                       \
+    }                                                                     \
+    _mm256_storeu_ps(c, lo);                                              \
+    _mm256_storeu_ps(c + 8, hi);                                          \
+}
+    __STORE_ROW(0, c00, c01);
+    __STORE_ROW(1, c10, c11);
+    __STORE_ROW(2, c20, c21);
+    __STORE_ROW(3, c30, c31);
+    __STORE_ROW(4, c40, c41);
+    __STORE_ROW(5, c50, c51);
+#undef __STORE_ROW
+}
+#else
+/* Portable fallback with the same packed layout */
+static inline __attribute__((always_inline))
+void ukernel_6x16(size_t kc, const float* Ap, const float* Bp, float* C, size_t ldc,
+                  float alpha, float beta, const unsigned ops, const mmult_epilogue_t* epi) {
+    float acc[GEMM_MR][GEMM_NR] = {{0.0f}};
+
+    for (size_t p = 0; p < kc; p++) {
+        for (size_t r = 0; r < GEMM_MR; r++) {
+            for (size_t c = 0; c < GEMM_NR; c++) {
+                acc[r][c] += Ap[r] * Bp[c];
+            }
+        }
+        Ap += GEMM_MR;
+        Bp += GEMM_NR;
+    }
+
+    for (size_t r = 0; r < GEMM_MR; r++) {
+        for (size_t c = 0; c < GEMM_NR; c++) {
+            float v = alpha * acc[r][c];
+            if (beta != 0.0f) v += beta * C[r * ldc + c];
+            if (ops) v = mmult_epilogue_apply(epi, r, c, v);
+            C[r * ldc + c] = v;
+        }
+    }
+}
+#endif
+
+/* One micro-kernel per epilogue subset, indexed by the ops mask */
+typedef void (*gemm_ukernel_fn)(size_t kc, const float* Ap, const float* Bp, float* C, size_t ldc,
+                                float alpha, float beta, const mmult_epilogue_t* epi);
+
+#define __DEFINE_UKERNEL(ops)                                                               \
+static void ukernel_6x16_##ops(size_t kc, const float* Ap, const float* Bp, float* C,     \
+                               size_t ldc, float alpha, float beta,                        \
+                               const mmult_epilogue_t* epi) {                              \
+    ukernel_6x16(kc, Ap, Bp, C, ldc, alpha, beta, ops, epi);                               \
+}
+__DEFINE_UKERNEL(0)  __DEFINE_UKERNEL(1)  __DEFINE_UKERNEL(2)  __DEFINE_UKERNEL(3)
+__DEFINE_UKERNEL(4)  __DEFINE_UKERNEL(5)  __DEFINE_UKERNEL(6)  __DEFINE_UKERNEL(7)
+__DEFINE_UKERNEL(8)  __DEFINE_UKERNEL(9)  __DEFINE_UKERNEL(10) __DEFINE_UKERNEL(11)
+__DEFINE_UKERNEL(12) __DEFINE_UKERNEL(13) __DEFINE_UKERNEL(14) __DEFINE_UKERNEL(15)
+__DEFINE_UKERNEL(16) __DEFINE_UKERNEL(17) __DEFINE_UKERNEL(18) __DEFINE_UKERNEL(19)
+__DEFINE_UKERNEL(20) __DEFINE_UKERNEL(21) __DEFINE_UKERNEL(22) __DEFINE_UKERNEL(23)
+__DEFINE_UKERNEL(24) __DEFINE_UKERNEL(25) __DEFINE_UKERNEL(26) __DEFINE_UKERNEL(27)
+__DEFINE_UKERNEL(28) __DEFINE_UKERNEL(29) __DEFINE_UKERNEL(30) __DEFINE_UKERNEL(31)
+#undef __DEFINE_UKERNEL
+
+static const gemm_ukernel_fn gemm_ukernels[MMULT_EPI_COMBOS] = {
+    ukernel_6x16_0,  ukernel_6x16_1,  ukernel_6x16_2,  ukernel_6x16_3,
+    ukernel_6x16_4,  ukernel_6x16_5,  ukernel_6x16_6,  ukernel_6x16_7,
+    ukernel_6x16_8,  ukernel_6x16_9,  ukernel_6x16_10, ukernel_6x16_11,
+    ukernel_6x16_12, ukernel_6x16_13, ukernel_6x16_14, ukernel_6x16_15,
+    ukernel_6x16_16, ukernel_6x16_17, ukernel_6x16_18, ukernel_6x16_19,
+    ukernel_6x16_20, ukernel_6x16_21, ukernel_6x16_22, ukernel_6x16_23,
+    ukernel_6x16_24, ukernel_6x16_25, ukernel_6x16_26, ukernel_6x16_27,
+    ukernel_6x16_28, ukernel_6x16_29, ukernel_6x16_30, ukernel_6x16_31,
+};
+
+void gemm_ukernel(size_t kc, const float* Ap, const float* Bp,
+                  float* C, size_t ldc, size_t mr, size_t nr, float alpha, float beta,
+                  const mmult_epilogue_t* epi) {
+    unsigned ops = epi ? (epi->ops & MMULT_EPI_ALL) : 0;
+
+    if (mr == GEMM_MR && nr == GEMM_NR) {
+        gemm_ukernels[ops](kc, Ap, Bp, C, ldc, alpha, beta, epi);
+        return;
+    }
+
+    /* Edge tile: compute the full tile aside, copy the valid part */
+    float tile[GEMM_MR * GEMM_NR] __attribute__((aligned(64)));
+    gemm_ukernels[0](kc, Ap, Bp, tile, GEMM_NR, alpha, 0.0f, NULL);
+
+    for (size_t r = 0; r < mr; r++) {
+        for (size_t c = 0; c < nr; c++) {
+            float v = tile[r * GEMM_NR + c];
+            if (beta != 0.0f) v += beta * C[r * ldc + c];
+            if (ops) v = mmult_epilogue_apply(epi, r, c, v);
+            C[r * ldc + c] = v;
+        }
+    }
+}
+
+void gemm_macro_kernel(size_t mc, size_t nc, size_t kc,
+                       const float* Ap, const float* Bp,
+                       float* C, size_t ldc, float alpha, float beta,
+                       const mmult_epilogue_t* epi) {
+    mmult_epilogue_t tmp;
+
+    for (size_t jr = 0; jr < nc; jr += GEMM_NR) {
+        size_t nr = (nc - jr < GEMM_NR) ? nc - jr : GEMM_NR;
+
+        for (size_t ir = 0; ir < mc; ir += GEMM_MR) {
+            size_t mr = (mc - ir < GEMM_MR) ? mc - ir : GEMM_MR;
+
+            gemm_ukernel(kc, &Ap[ir * kc], &Bp[jr * kc],
+                         &C[ir * ldc + jr], ldc, mr, nr, alpha, beta,
+                         mmult_epilogue_at(epi, ir, jr, &tmp));
+        }
+    }
+}
+
+void gemm_scale(size_t M, size_t N, float beta, float* C, size_t ldc) {
+    for (size_t i = 0; i < M; i++) {
+        float* c = &C[i * ldc];
+        if (beta == 0.0f) {
+            memset(c, 0, N * sizeof(float));
+        } else if (beta != 1.0f) {
+            for (size_t j = 0; j < N; j++) c[j] *= beta;
+        }
+    }
+}
+
+void gemm_epilogue(size_t M, size_t N, const mmult_epilogue_t* epi, float* C, size_t ldc) {
+    for (size_t i = 0; i < M; i++) {
+        for (size_t j = 0; j < N; j++) {
+            C[i * ldc + j] = mmult_epilogue_apply(epi, i, j, C[i * ldc + j]);
+        }
+    }
+}
+
+void gemm_sgemm_blocked(int transa, int transb, size_t M, size_t N, size_t K,
+                        float alpha, const float* A, size_t lda,
+                        const float* B, size_t ldb,
+                        float beta, float* C, size_t ldc,
+                        const mmult_epilogue_t* epi,
+                        const gemm_blocking_t* blocking) {
+    if (blocking == NULL) blocking = &gemm_default_blocking;
+    if (epi != NULL && epi->ops == 0) epi = NULL;
+
+    /* No product term: only C is scaled, then the epilogue applied */
+    if (K == 0 || alpha == 0.0f) {
+        gemm_scale(M, N, beta, C, ldc);
+        if (epi != NULL) gemm_epilogue(M, N, epi, C, ldc);
+        return;
+    }
+
+    mmult_epilogue_t tmp;
+
+    size_t MC = blocking->mc, KC = blocking->kc, NC = blocking->nc;
+
+    float* Ap = __ALLOC_DATA(float, GEMM_ROUND_UP(MC, GEMM_MR) * KC);
+    float* Bp = __ALLOC_DATA(float, GEMM_ROUND_UP(NC, GEMM_NR) * KC);
+
+    for (size_t jc = 0; jc < N; jc += NC) {
+        size_t nc = (N - jc < NC) ? N - jc : NC;
+
+        for (size_t pc = 0; pc < K; pc += KC) {
+            size_t kc = (K - pc < KC) ? K - pc : KC;
+
+            gemm_pack_b(kc, nc, GEMM_AT(B, ldb, transb, pc, jc), ldb, transb, Bp);
+
+            for (size_t ic = 0; ic < M; ic += MC) {
+                size_t mc = (M - ic < MC) ? M - ic : MC;
+
+                /* beta applies once, later K slices accumulate and
+                 * the last one runs the epilogue before its store      */
+                gemm_pack_a(mc, kc, GEMM_AT(A, lda, transa, ic, pc), lda, transa, Ap);
+                gemm_macro_kernel(mc, nc, kc, Ap, Bp, &C[ic * ldc + jc], ldc,
+                                  alpha, pc > 0 ? 1.0f : beta,
+                                  pc + kc == K ? mmult_epilogue_at(epi, ic, jc, &tmp) : NULL);
+            }
+        }
+    }
+
+    free(Ap);
+    free(Bp);
+}
+
+void gemm_sgemm(int transa, int transb, size_t M, size_t N, size_t K,
+                float alpha, const float* A, size_t lda,
+                const float* B, size_t ldb,
+                float beta, float* C, size_t ldc,
+                const mmult_epilogue_t* epi,
+                const gemm_blocking_t* blocking) {
+    /* Matrix-vector and rank-1 shapes skip the packing entirely */
+    if (gemv_dispatch(transa, transb, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, epi, 1)) {
+        return;
+    }
+    gemm_sgemm_blocked(transa, transb, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, epi, blocking);
+}
+
+void gemm_packed(size_t M, size_t N, size_t K,
+                 const float* A, size_t lda,
+                 const float* B, size_t ldb,
+                 float* C, size_t ldc,
+                 const gemm_blocking_t* blocking) {
+    gemm_sgemm(0, 0, M, N, K, 1.0f, A, lda, B, ldb, 0.0f, C, ldc, NULL, blocking);
+}
@@ -0,0 +1,115 @@
+/* gemm.h
+ *
+ * Packed GEMM engine (BLIS/Goto style). C = A * B is computed by
+ * splitting the problem into NC-wide column panels of B (sized for
+ * L3), KC-deep slices of K (sized so a packed B micro-panel stays in L1)
+ * and MC-tall blocks of A (sized for L2). A and B blocks are copied
+ * into contiguous micro-panels and an MR x NR register-blocked FMA
+ * micro-kernel computes each tile of C.
+ */
+
+#ifndef __IMPL_GEMM_H_
+#define __IMPL_GEMM_H_
+
+#include <stddef.h>
+
+#include "include/types.h"
+
+/* Register blocking of the micro-kernel */
+#define GEMM_MR 6
+#define GEMM_NR 16
+
+/* Cache blocking */
+typedef struct {
+    size_t mc;   /* Rows of A packed per block    (L2) */
+    size_t kc;   /* Depth of every packed panel   (L1) */
+    size_t nc;   /* Columns of B packed per panel (L3) */
+} gemm_blocking_t;
+
+/* Blocking tuned for 32KB L1 / 1MB L2 / multi-MB L3 */
+extern const gemm_blocking_t gemm_default_blocking;
+
+/* Shape classes with their own blocking */
+typedef enum {
+    GEMM_SHAPE_SQUARE = 0,   /* M, N and K of similar magnitude        */
+    GEMM_SHAPE_TALL_SKINNY,  /* M >> N: B fits in few panels, stream A */
+    GEMM_SHAPE_SHORT_WIDE,   /* N >> M: A fits in one block, stream B  */
+    GEMM_SHAPE_SMALL_K,      /* K fits in a single shallow KC slice    */
+    GEMM_NUM_SHAPES
+} gemm_shape_t;
+
+extern const gemm_blocking_t gemm_shape_blocking[GEMM_NUM_SHAPES];
+
+gemm_shape_t gemm_classify_shape(size_t M, size_t N, size_t K);
+const char* gemm_shape_name(gemm_shape_t shape);
+
+/* Blocking for the shape class of an M x K x N product */
+const gemm_blocking_t* gemm_select_blocking(size_t M, size_t N, size_t K);
+
+/* Address of element (r, c) of op(X), where a transposed X is stored
+ * as its transpose (row-major, leading dimension ld)                 */
+#define GEMM_AT(X, ld, trans, r, c) ((trans) ? &(X)[(c) * (ld) + (r)] : &(X)[(r) * (ld) + (c)])
+
+/* Pack an mc x kc block of op(A) (row-major, leading dimension lda)
+ * into MR-row micro-panels; partial panels are zero padded. With
+ * `trans` set, A points at the kc x mc block of the stored matrix.  */
+void gemm_pack_a(size_t mc, size_t kc, const float* A, size_t lda, int trans, float* Ap);
+
+/* Pack a kc x nc block of op(B) (row-major, leading dimension ldb)
+ * into NR-column micro-panels; partial panels are zero padded. With
+ * `trans` set, B points at the nc x kc block of the stored matrix.  */
+void gemm_pack_b(size_t kc, size_t nc, const float* B, size_t ldb, int trans, float* Bp);
+
+/* Multiply one packed A micro-panel by one packed B micro-panel into
+ * the mr x nr tile at C (mr <= MR, nr <= NR):
+ * C = epi(alpha * Ap * Bp + beta * C). C is not read when beta is zero.
+ * The epilogue (NULL for none) is indexed from the tile's origin and
+ * selects one of the micro-kernels specialized per set of operations. */
+void gemm_ukernel(size_t kc, const float* Ap, const float* Bp,
+                  float* C, size_t ldc, size_t mr, size_t nr, float alpha, float beta,
+                  const mmult_epilogue_t* epi);
+
+/* Multiply the packed mc x kc block of A by the packed kc x nc panel
+ * of B into C, one micro-tile at a time, with the same alpha/beta and
+ * an epilogue indexed from the block's origin.                      */
+void gemm_macro_kernel(size_t mc, size_t nc, size_t kc,
+                       const float* Ap, const float* Bp,
+                       float* C, size_t ldc, float alpha, float beta,
+                       const mmult_epilogue_t* epi);
+
+/* C = beta * C (zeroed without being read when beta is zero) */
+void gemm_scale(size_t M, size_t N, float beta, float* C, size_t ldc);
+
+/* Apply an epilogue to every element of C in a separate pass */
+void gemm_epilogue(size_t M, size_t N, const mmult_epilogue_t* epi, float* C, size_t ldc);
+
+/* BLAS-style C (M x N) = epi(alpha * op(A) * op(B) + beta * C), row-major.
+ * op(X) is X, or X^T when the trans flag is set; the transposes and
+ * alpha/beta are applied while packing and in the micro-kernel, the
+ * epilogue (optional) on the accumulators of the last K slice.      */
+void gemm_sgemm(int transa, int transb, size_t M, size_t N, size_t K,
+                float alpha, const float* A, size_t lda,
+                const float* B, size_t ldb,
+                float beta, float* C, size_t ldc,
+                const mmult_epilogue_t* epi,
+                const gemm_blocking_t* blocking);
+
+/* gemm_sgemm without the GEMV / rank-1 fast paths (impl/gemv.h) */
+void gemm_sgemm_blocked(int transa, int transb, size_t M, size_t N, size_t K,
+                        float alpha, const float* A, size_t lda,
+                        const float* B, size_t ldb,
+                        float beta, float* C, size_t ldc,
+                        const mmult_epilogue_t* epi,
+                        const gemm_blocking_t* blocking);
+
+/* C (M x N) = A (M x K) * B (K x N), all row-major */
+void gemm_packed(size_t M, size_t N, size_t K,
+                 const float* A, size_t lda,
+                 const float* B, size_t ldb,
+                 float* C, size_t ldc,
+                 const gemm_blocking_t* blocking);
+
+/* Round a packing dimension up to a whole number of micro-panels */
+#define GEMM_ROUND_UP(x, r) ((((x) + (r) - 1) / (r)) * (r))
+
+#endif //__IMPL_GEMM_H_
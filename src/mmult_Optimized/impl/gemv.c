@@ -0,0 +1,311 @@
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <unistd.h>
+/*  -> SIMD header file  */
+#if defined(__amd64__) || defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+/* Include common headers */
+#include "common/macros.h"
+#include "common/types.h"
+
+/* Include application-specific headers */
+#include "include/types.h"
+#include "include/layout.h"
+#include "impl/gemv.h"
+
+/* Slice of y accumulated at once by the transposed form (8 KiB) */
+#define GEMV_CHUNK 2048
+
+/* Rank-1 outputs from this size on are written around the caches */
+#define GEMV_STREAM_BYTES (32 << 20)
+
+#define GEMV_ROUND_DOWN(x, r) (((x) / (r)) * (r))
+
+/* One thread's share of a GEMV or rank-1 update: outputs [r0, r1) */
+typedef struct {
+    int trans, row;
+    int stream;               /* Rank-1: non-temporal stores of C    */
+    size_t rows, cols;
+    float alpha, beta;
+    const float* X; size_t ldx;
+    const float* x;           /* Contiguous                          */
+    float* y; size_t incy;    /* Rank-1: C and ldc                   */
+    const float* a; size_t inca;
+    const mmult_epilogue_t* epi;
+    size_t r0, r1;
+} gemv_task_t;
+
+static inline float gemv_finish(const gemv_task_t* t, size_t i, float acc, float old) {
+    float v = t->alpha * acc + (t->beta != 0.0f ? t->beta * old : 0.0f);
+    if (t->epi != NULL) {
+        v = t->row ? mmult_epilogue_apply(t->epi, 0, i, v) : mmult_epilogue_apply(t->epi, i, 0, v);
+    }
+    return v;
+}
+
+#if defined(__AVX2__) && defined(__FMA__)
+static inline float hsum256(__m256 v) {
+    __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    return _mm_cvtss_f32(_mm_add_ss(s, _mm_movehdup_ps(s)));
+}
+#endif
+
+/* y_i = dot(X_i, x): four rows per pass, so x is read a quarter as often */
+static void* gemv_dot_worker(void* arg) {
+    const gemv_task_t* t = (const gemv_task_t*)arg;
+    const float* x = t->x;
+    size_t n = t->cols, i = t->r0;
+
+#if defined(__AVX2__) && defined(__FMA__)
+    for (; i + 4 <= t->r1; i += 4) {
+        const float* x0 = &t->X[(i + 0) * t->ldx];
+        const float* x1 = &t->X[(i + 1) * t->ldx];
+        const float* x2 = &t->X[(i + 2) * t->ldx];
+        const float* x3 = &t->X[(i + 3) * t->ldx];
+        __m256 s00 = _mm256_setzero_ps(), s01 = _mm256_setzero_ps();
+        __m256 s10 = _mm256_setzero_ps(), s11 = _mm256_setzero_ps();
+        __m256 s20 = _mm256_setzero_ps(), s21 = _mm256_setzero_ps();
+        __m256 s30 = _mm256_setzero_ps(), s31 = _mm256_setzero_ps();
+        size_t k = 0;
+        for (; k + 16 <= n; k += 16) {
+            __m256 v0 = _mm256_loadu_ps(&x[k]), v1 = _mm256_loadu_ps(&x[k + 8]);
+            s00 = _mm256_fmadd_ps(_mm256_loadu_ps(&x0[k]), v0, s00);
+            s01 = _mm256_fmadd_ps(_mm256_loadu_ps(&x0[k + 8]), v1, s01);
+            s10 = _mm256_fmadd_ps(_mm256_loadu_ps(&x1[k]), v0, s10);
+            s11 = _mm256_fmadd_ps(_mm256_loadu_ps(&x1[k + 8]), v1, s11);
+            s20 = _mm256_fmadd_ps(_mm256_loadu_ps(&x2[k]), v0, s20);
+            s21 = _mm256_fmadd_ps(_mm256_loadu_ps(&x2[k + 8]), v1, s21);
+            s30 = _mm256_fmadd_ps(_mm256_loadu_ps(&x3[k]), v0, s30);
+            s31 = _mm256_fmadd_ps(_mm256_loadu_ps(&x3[k + 8]), v1, s31);
+        }
+        float d0 = hsum256(_mm256_add_ps(s00, s01)), d1 = hsum256(_mm256_add_ps(s10, s11));
+        float d2 = hsum256(_mm256_add_ps(s20, s21)), d3 = hsum256(_mm256_add_ps(s30, s31));
+        for (; k < n; k++) {
+            d0 += x0[k] * x[k];
+            d1 += x1[k] * x[k];
+            d2 += x2[k] * x[k];
+            d3 += x3[k] * x[k];
+        }
+        t->y[(i + 0) * t->incy] = gemv_finish(t, i + 0, d0, t->y[(i + 0) * t->incy]);
+        t->y[(i + 1) * t->incy] = gemv_finish(t, i + 1, d1, t->y[(i + 1) * t->incy]);
+        t->y[(i + 2) * t->incy] = gemv_finish(t, i + 2, d2, t->y[(i + 2) * t->incy]);
+        t->y[(i + 3) * t->incy] = gemv_finish(t, i + 3, d3, t->y[(i + 3) * t->incy]);
+    }
+#endif
+
+    for (; i < t->r1; i++) {
+        const float* xi = &t->X[i * t->ldx];
+        float d = 0.0f;
+        for (size_t k = 0; k < n; k++) d += xi[k] * x[k];
+        t->y[i * t->incy] = gemv_finish(t, i, d, t->y[i * t->incy]);
+    }
+    return NULL;
+}
+
+/* y = X^T x: rows of the stored X are added into a slice of y that
+ * stays in L1, four at a time to cut the loads and stores of y      */
+static void* gemv_axpy_worker(void* arg) {
+    const gemv_task_t* t = (const gemv_task_t*)arg;
+    float acc[GEMV_CHUNK] __attribute__((aligned(32)));
+
+    for (size_t c0 = t->r0; c0 < t->r1; c0 += GEMV_CHUNK) {
+        size_t len = (t->r1 - c0 < GEMV_CHUNK) ? t->r1 - c0 : GEMV_CHUNK;
+        memset(acc, 0, len * sizeof(float));
+
+        size_t k = 0;
+        for (; k + 4 <= t->cols; k += 4) {
+            const float* x0 = &t->X[(k + 0) * t->ldx + c0];
+            const float* x1 = &t->X[(k + 1) * t->ldx + c0];
+            const float* x2 = &t->X[(k + 2) * t->ldx + c0];
+            const float* x3 = &t->X[(k + 3) * t->ldx + c0];
+            float a0 = t->x[k], a1 = t->x[k + 1], a2 = t->x[k + 2], a3 = t->x[k + 3];
+            size_t j = 0;
+#if defined(__AVX2__) && defined(__FMA__)
+            __m256 v0 = _mm256_set1_ps(a0), v1 = _mm256_set1_ps(a1);
+            __m256 v2 = _mm256_set1_ps(a2), v3 = _mm256_set1_ps(a3);
+            for (; j + 8 <= len; j += 8) {
+                __m256 s = _mm256_load_ps(&acc[j]);
+                s = _mm256_fmadd_ps(v0, _mm256_loadu_ps(&x0[j]), s);
+                s = _mm256_fmadd_ps(v1, _mm256_loadu_ps(&x1[j]), s);
+                s = _mm256_fmadd_ps(v2, _mm256_loadu_ps(&x2[j]), s);
+                s = _mm256_fmadd_ps(v3, _mm256_loadu_ps(&x3[j]), s);
+                _mm256_store_ps(&acc[j], s);
+            }
+#endif
+            for (; j < len; j++) {
+                acc[j] += a0 * x0[j] + a1 * x1[j] + a2 * x2[j] + a3 * x3[j];
+            }
+        }
+        for (; k < t->cols; k++) {
+            const float* xk = &t->X[k * t->ldx + c0];
+            for (size_t j = 0; j < len; j++) acc[j] += t->x[k] * xk[j];
+        }
+
+        for (size_t j = 0; j < len; j++) {
+            size_t i = c0 + j;
+            t->y[i * t->incy] = gemv_finish(t, i, acc[j], t->y[i * t->incy]);
+        }
+    }
+    return NULL;
+}
+
+/* C_i = alpha * a_i * b + beta * C_i, row by row */
+static void* gemv_ger_worker(void* arg) {
+    const gemv_task_t* t = (const gemv_task_t*)arg;
+    const float* b = t->x;
+    size_t N = t->cols;
+
+    for (size_t i = t->r0; i < t->r1; i++) {
+        float* c = &t->y[i * t->incy];
+        float s = t->alpha * t->a[i * t->inca];
+        size_t j = 0;
+#if defined(__AVX2__) && defined(__FMA__)
+        __m256 vs = _mm256_set1_ps(s), vb = _mm256_set1_ps(t->beta);
+        if (t->stream) {
+            /* C is only written: skip the read-for-ownership of its lines */
+            for (; j < N && ((uintptr_t)&c[j] & 31); j++) c[j] = s * b[j];
+            for (; j + 8 <= N; j += 8) {
+                _mm256_stream_ps(&c[j], _mm256_mul_ps(vs, _mm256_loadu_ps(&b[j])));
+            }
+        } else if (t->beta == 0.0f) {
+            for (; j + 8 <= N; j += 8) {
+                _mm256_storeu_ps(&c[j], _mm256_mul_ps(vs, _mm256_loadu_ps(&b[j])));
+            }
+        } else {
+            for (; j + 8 <= N; j += 8) {
+                __m256 old = _mm256_mul_ps(vb, _mm256_loadu_ps(&c[j]));
+                _mm256_storeu_ps(&c[j], _mm256_fmadd_ps(vs, _mm256_loadu_ps(&b[j]), old));
+            }
+        }
+#endif
+        for (; j < N; j++) {
+            c[j] = s * b[j] + (t->beta != 0.0f ? t->beta * c[j] : 0.0f);
+        }
+        /* The row is still in L1: the epilogue costs no extra pass */
+        if (t->epi != NULL) {
+            for (j = 0; j < N; j++) c[j] = mmult_epilogue_apply(t->epi, i, j, c[j]);
+        }
+    }
+#if defined(__AVX2__) && defined(__FMA__)
+    if (t->stream) _mm_sfence();
+#endif
+    return NULL;
+}
+
+/* Split [0, n) across up to nthreads copies of `proto`, keeping slice
+ * boundaries on multiples of `align`, and run fn on every slice      */
+static void gemv_parallel(void* (*fn)(void*), const gemv_task_t* proto, size_t n,
+                          size_t work, size_t align, int nthreads) {
+    if (nthreads <= 0) nthreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (nthreads <= 0) nthreads = 1;
+
+    size_t max_threads = work / GEMV_GRAIN;
+    if ((size_t)nthreads > max_threads) nthreads = max_threads > 0 ? (int)max_threads : 1;
+    if ((size_t)nthreads > n) nthreads = n > 0 ? (int)n : 1;
+
+    pthread_t tid[nthreads];
+    gemv_task_t tasks[nthreads];
+    for (int t = 0; t < nthreads; t++) {
+        tasks[t] = *proto;
+        tasks[t].r0 = (t == 0) ? 0 : GEMV_ROUND_DOWN(n * t / nthreads, align);
+        tasks[t].r1 = (t == nthreads - 1) ? n : GEMV_ROUND_DOWN(n * (t + 1) / nthreads, align);
+        if (t > 0) pthread_create(&tid[t], NULL, fn, &tasks[t]);
+    }
+
+    fn(&tasks[0]);
+
+    for (int t = 1; t < nthreads; t++) {
+        pthread_join(tid[t], NULL);
+    }
+}
+
+/* Gather a strided vector, or use it in place if it is contiguous */
+static const float* gemv_contiguous(const float* v, size_t n, size_t inc, float** copy) {
+    *copy = NULL;
+    if (inc == 1) return v;
+    *copy = __ALLOC_DATA(float, n);
+    for (size_t i = 0; i < n; i++) (*copy)[i] = v[i * inc];
+    return *copy;
+}
+
+void gemv_sgemv(int trans, size_t rows, size_t cols, float alpha,
+                const float* X, size_t ldx, const float* x, size_t incx,
+                float beta, float* y, size_t incy,
+                const mmult_epilogue_t* epi, int row, int nthreads) {
+    float* copy;
+    gemv_task_t t = {0};
+
+    t.trans = trans; t.row = row;
+    t.rows = rows;   t.cols = cols;
+    t.alpha = alpha; t.beta = beta;
+    t.X = X;         t.ldx = ldx;
+    t.x = gemv_contiguous(x, cols, incx, &copy);
+    t.y = y;         t.incy = incy;
+    t.epi = (epi != NULL && epi->ops) ? epi : NULL;
+
+    if (trans) {
+        gemv_parallel(gemv_axpy_worker, &t, rows, rows * cols, 16, nthreads);
+    } else {
+        gemv_parallel(gemv_dot_worker, &t, rows, rows * cols, 4, nthreads);
+    }
+
+    free(copy);
+}
+
+void gemv_sger(size_t M, size_t N, float alpha,
+               const float* a, size_t inca, const float* b, size_t incb,
+               float beta, float* C, size_t ldc,
+               const mmult_epilogue_t* epi, int nthreads) {
+    float* copy;
+    gemv_task_t t = {0};
+
+    t.rows = M;      t.cols = N;
+    t.alpha = alpha; t.beta = beta;
+    t.a = a;         t.inca = inca;
+    t.x = gemv_contiguous(b, N, incb, &copy);
+    t.y = C;         t.incy = ldc;
+    t.epi = (epi != NULL && epi->ops) ? epi : NULL;
+    /* A C much larger than the caches is not read back soon */
+    t.stream = beta == 0.0f && t.epi == NULL && M * N * sizeof(float) >= GEMV_STREAM_BYTES;
+
+    gemv_parallel(gemv_ger_worker, &t, M, M * N, 1, nthreads);
+
+    free(copy);
+}
+
+int gemv_dispatch(int transa, int transb, size_t M, size_t N, size_t K,
+                  float alpha, const float* A, size_t lda,
+                  const float* B, size_t ldb,
+                  float beta, float* C, size_t ldc,
+                  const mmult_epilogue_t* epi, int nthreads) {
+    /* Empty products and alpha == 0 only scale C */
+    if (M == 0 || N == 0 || K == 0 || alpha == 0.0f) return 0;
+
+    if (K == 1) {
+        /* a = op(A)(:, 0), b = op(B)(0, :) */
+        gemv_sger(M, N, alpha, A, transa ? 1 : lda, B, transb ? ldb : 1,
+                  beta, C, ldc, epi, nthreads);
+        return 1;
+    }
+    if (N == 1) {
+        /* R(:, 0) = op(A) * op(B)(:, 0) */
+        gemv_sgemv(transa, M, K, alpha, A, lda, B, transb ? 1 : ldb,
+                   beta, C, ldc, epi, 0, nthreads);
+        return 1;
+    }
+    if (M == 1) {
+        /* R(0, :) = op(B)^T * op(A)(0, :)^T; a stored K x N B is the
+         * transposed form, a transposed one the plain form          */
+        gemv_sgemv(!transb, N, K, alpha, B, ldb, A, transa ? lda : 1,
+                   beta, C, 1, epi, 1, nthreads);
+        return 1;
+    }
+    return 0;
+}
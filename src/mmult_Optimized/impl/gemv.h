@@ -0,0 +1,53 @@
+/* gemv.h
+ *
+ * Fast paths for degenerate GEMM shapes. With N == 1 or M == 1 the
+ * product is a matrix-vector product and with K == 1 a rank-1 update;
+ * both do O(1) flops per element of the matrix they read, so they are
+ * bound by memory bandwidth and the packed engine (which copies every
+ * operand into panels first) only adds traffic. These kernels read each
+ * matrix once, straight from its storage.
+ *
+ * Every entry point splits its work over up to nthreads threads (fewer
+ * when the matrix is small, see GEMV_GRAIN); nthreads <= 0 uses all
+ * online CPUs.
+ */
+
+#ifndef __IMPL_GEMV_H_
+#define __IMPL_GEMV_H_
+
+#include <stddef.h>
+
+#include "include/types.h"
+
+/* Elements of the streamed matrix below which extra threads do not pay */
+#define GEMV_GRAIN (1 << 16)
+
+/* y (rows) = epi(alpha * op(X) * x + beta * y). X is row-major with
+ * leading dimension ldx and stored cols x rows when trans is set; x has
+ * cols entries spaced incx apart, y rows entries spaced incy apart.
+ * Element y[i] is R(i, 0) for the epilogue, or R(0, i) when `row` is
+ * set (y is a row of the result). y is not read when beta is zero.
+ * The non-transposed form runs one dot product per row, the transposed
+ * one accumulates rows of X into cache-sized slices of y.            */
+void gemv_sgemv(int trans, size_t rows, size_t cols, float alpha,
+                const float* X, size_t ldx, const float* x, size_t incx,
+                float beta, float* y, size_t incy,
+                const mmult_epilogue_t* epi, int row, int nthreads);
+
+/* C (M x N) = epi(alpha * a * b^T + beta * C) with a (M entries, inca
+ * apart) and b (N entries, incb apart); one broadcast-FMA pass per row. */
+void gemv_sger(size_t M, size_t N, float alpha,
+               const float* a, size_t inca, const float* b, size_t incb,
+               float beta, float* C, size_t ldc,
+               const mmult_epilogue_t* epi, int nthreads);
+
+/* Run C = epi(alpha * op(A) * op(B) + beta * C) (row-major, as in
+ * gemm_sgemm) on a fast path if the shape has one. Returns 1 if it
+ * did, 0 if the product is left to the general engine.             */
+int gemv_dispatch(int transa, int transb, size_t M, size_t N, size_t K,
+                  float alpha, const float* A, size_t lda,
+                  const float* B, size_t ldb,
+                  float beta, float* C, size_t ldc,
+                  const mmult_epilogue_t* epi, int nthreads);
+
+#endif //__IMPL_GEMV_H_
@@ -0,0 +1,308 @@
+/* igemm.c
+ *
+ * Integer GEMM on the blocking of the float engine: KC-deep slices,
+ * MC-row blocks of A and NC-column panels of B packed into MR-row and
+ * NR-column micro-panels, and an MR x NR register-blocked kernel. In a
+ * micro-panel, every group of KG consecutive k values of a row (A) or
+ * column (B) is adjacent, KG being the k values one instruction
+ * reduces: 1 for vpmulld / vpmuldq, 2 for vpmaddwd.
+ *
+ * The kernels write the product of one slice into a tile, which is
+ * stored into C or added to it (unsigned, so int32 sums wrap).
+ */
+
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+/*  -> SIMD header file  */
+#if defined(__amd64__) || defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+/* Include common headers */
+#include "common/macros.h"
+#include "common/types.h"
+
+/* Include application-specific headers */
+#include "impl/igemm.h"
+
+#define IGEMM_MR 6
+#define IGEMM_MC 144
+#define IGEMM_KC 256
+#define IGEMM_NC 2048
+
+#define IGEMM_MIN(a, b) ((a) < (b) ? (a) : (b))
+#define IGEMM_CEIL(a, b) (((a) + (b) - 1) / (b))
+
+/* ------------------------------------------------------------------ */
+/* Micro-kernels: tile (MR x NR) = Ap (kg groups) * Bp (kg groups)     */
+/* ------------------------------------------------------------------ */
+
+#if defined(__AVX2__)
+static void igemm_kernel_s32(size_t kg, const int32_t* Ap, const int32_t* Bp, int32_t* tile) {
+    __m256i c[IGEMM_MR][2];
+    for (int r = 0; r < IGEMM_MR; r++) c[r][0] = c[r][1] = _mm256_setzero_si256();
+
+    for (size_t p = 0; p < kg; p++) {
+        __m256i b0 = _mm256_loadu_si256((const __m256i*)&Bp[p * 16]);
+        __m256i b1 = _mm256_loadu_si256((const __m256i*)&Bp[p * 16 + 8]);
+        for (int r = 0; r < IGEMM_MR; r++) {
+            __m256i a = _mm256_set1_epi32(Ap[p * IGEMM_MR + r]);
+            c[r][0] = _mm256_add_epi32(c[r][0], _mm256_mullo_epi32(a, b0));
+            c[r][1] = _mm256_add_epi32(c[r][1], _mm256_mullo_epi32(a, b1));
+        }
+    }
+    for (int r = 0; r < IGEMM_MR; r++) {
+        _mm256_storeu_si256((__m256i*)&tile[r * 16], c[r][0]);
+        _mm256_storeu_si256((__m256i*)&tile[r * 16 + 8], c[r][1]);
+    }
+}
+
+/* One int32 broadcast carries the (k, k + 1) pair of an A row; vpmaddwd
+ * multiplies it with the interleaved pair of 8 B columns and sums    */
+static void igemm_kernel_s16(size_t kg, const int16_t* Ap, const int16_t* Bp, int32_t* tile) {
+    __m256i c[IGEMM_MR][2];
+    for (int r = 0; r < IGEMM_MR; r++) c[r][0] = c[r][1] = _mm256_setzero_si256();
+
+    for (size_t p = 0; p < kg; p++) {
+        __m256i b0 = _mm256_loadu_si256((const __m256i*)&Bp[p * 32]);
+        __m256i b1 = _mm256_loadu_si256((const __m256i*)&Bp[p * 32 + 16]);
+        for (int r = 0; r < IGEMM_MR; r++) {
+            int32_t pair;
+            memcpy(&pair, &Ap[(p * IGEMM_MR + r) * 2], sizeof(pair));
+            __m256i a = _mm256_set1_epi32(pair);
+            c[r][0] = _mm256_add_epi32(c[r][0], _mm256_madd_epi16(a, b0));
+            c[r][1] = _mm256_add_epi32(c[r][1], _mm256_madd_epi16(a, b1));
+        }
+    }
+    for (int r = 0; r < IGEMM_MR; r++) {
+        _mm256_storeu_si256((__m256i*)&tile[r * 16], c[r][0]);
+        _mm256_storeu_si256((__m256i*)&tile[r * 16 + 8], c[r][1]);
+    }
+}
+
+/* vpmuldq multiplies the low int32 of every int64 lane: B is widened
+ * on load, A is broadcast as int64                                   */
+static void igemm_kernel_s64(size_t kg, const int32_t* Ap, const int32_t* Bp, int64_t* tile) {
+    __m256i c[IGEMM_MR][2];
+    for (int r = 0; r < IGEMM_MR; r++) c[r][0] = c[r][1] = _mm256_setzero_si256();
+
+    for (size_t p = 0; p < kg; p++) {
+        __m256i b0 = _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i*)&Bp[p * 8]));
+        __m256i b1 = _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i*)&Bp[p * 8 + 4]));
+        for (int r = 0; r < IGEMM_MR; r++) {
+            __m256i a = _mm256_set1_epi64x(Ap[p * IGEMM_MR + r]);
+            c[r][0] = _mm256_add_epi64(c[r][0], _mm256_mul_epi32(a, b0));
+            c[r][1] = _mm256_add_epi64(c[r][1], _mm256_mul_epi32(a, b1));
+        }
+    }
+    for (int r = 0; r < IGEMM_MR; r++) {
+        _mm256_storeu_si256((__m256i*)&tile[r * 8], c[r][0]);
+        _mm256_storeu_si256((__m256i*)&tile[r * 8 + 4], c[r][1]);
+    }
+}
+#else
+/* Portable kernels; UT is the unsigned type of the accumulator */
+#define __DEFINE_IGEMM_KERNEL_SCALAR(name, TA, TC, UT, NR, KG)            \
+static void name(size_t kg, const TA* Ap, const TA* Bp, TC* tile) {       \
+    UT acc[IGEMM_MR * NR] = { 0 };                                        \
+    for (size_t p = 0; p < kg; p++) {                                     \
+        for (int r = 0; r < IGEMM_MR; r++) {                              \
+            for (int c = 0; c < NR; c++) {                                \
+                for (int q = 0; q < KG; q++) {                            \
+                    acc[r * NR + c] += (UT)((int64_t)Ap[(p * IGEMM_MR + r) * KG + q] * \
+                                            Bp[(p * NR + c) * KG + q]);   \
+                }                                                         \
+            }                                                             \
+        }                                                                 \
+    }                                                                     \
+    for (int i = 0; i < IGEMM_MR * NR; i++) tile[i] = (TC)acc[i];         \
+}
+
+__DEFINE_IGEMM_KERNEL_SCALAR(igemm_kernel_s32, int32_t, int32_t, uint32_t, 16, 1)
+__DEFINE_IGEMM_KERNEL_SCALAR(igemm_kernel_s16, int16_t, int32_t, uint32_t, 16, 2)
+__DEFINE_IGEMM_KERNEL_SCALAR(igemm_kernel_s64, int32_t, int64_t, uint64_t, 8, 1)
+#endif
+
+/* ------------------------------------------------------------------ */
+/* Blocked driver over rows [0, M) of one thread                       */
+/* ------------------------------------------------------------------ */
+
+/* Everything a thread needs, with untyped operands */
+typedef struct {
+    size_t M, N, K;
+    const void* A;
+    size_t lda;
+    const void* B;
+    size_t ldb;
+    void* C;
+    size_t ldc;
+} igemm_job_t;
+
+/* Pack an mc x kc block of A into MR-row micro-panels and a kc x nc
+ * block of B into NR-column micro-panels, KG k values adjacent; rows,
+ * columns and k values past the block are zero                      */
+#define __DEFINE_IGEMM_PACK(name, TA, NR, KG)                             \
+static void name##_pack_a(size_t mc, size_t kc, const TA* A, size_t lda, TA* Ap) { \
+    size_t kg = IGEMM_CEIL(kc, KG);                                       \
+    for (size_t i0 = 0; i0 < mc; i0 += IGEMM_MR) {                        \
+        for (size_t g = 0; g < kg; g++) {                                 \
+            for (size_t r = 0; r < IGEMM_MR; r++) {                       \
+                for (size_t q = 0; q < KG; q++) {                         \
+                    size_t i = i0 + r, k = g * KG + q;                    \
+                    *Ap++ = (i < mc && k < kc) ? A[i * lda + k] : 0;      \
+                }                                                         \
+            }                                                             \
+        }                                                                 \
+    }                                                                     \
+}                                                                         \
+static void name##_pack_b(size_t kc, size_t nc, const TA* B, size_t ldb, TA* Bp) { \
+    size_t kg = IGEMM_CEIL(kc, KG);                                       \
+    for (size_t j0 = 0; j0 < nc; j0 += NR) {                              \
+        for (size_t g = 0; g < kg; g++) {                                 \
+            for (size_t c = 0; c < NR; c++) {                             \
+                for (size_t q = 0; q < KG; q++) {                         \
+                    size_t j = j0 + c, k = g * KG + q;                    \
+                    *Bp++ = (j < nc && k < kc) ? B[k * ldb + j] : 0;      \
+                }                                                         \
+            }                                                             \
+        }                                                                 \
+    }                                                                     \
+}
+
+/* C += tile (or C = tile for the first slice) over the valid mr x nr */
+#define __DEFINE_IGEMM_UPDATE(name, TC, UT, NR)                           \
+static inline void name##_update(const TC* tile, TC* C, size_t ldc,       \
+                                 size_t mr, size_t nr, int first) {       \
+    for (size_t r = 0; r < mr; r++) {                                     \
+        if (first) {                                                      \
+            memcpy(&C[r * ldc], &tile[r * NR], nr * sizeof(TC));          \
+        } else {                                                          \
+            for (size_t c = 0; c < nr; c++) {                             \
+                C[r * ldc + c] = (TC)((UT)C[r * ldc + c] + (UT)tile[r * NR + c]); \
+            }                                                             \
+        }                                                                 \
+    }                                                                     \
+}
+
+#define __DEFINE_IGEMM_DRIVER(name, TA, TC, UT, NR, KG, KERNEL)           \
+__DEFINE_IGEMM_PACK(name, TA, NR, KG)                                     \
+__DEFINE_IGEMM_UPDATE(name, TC, UT, NR)                                   \
+static void name##_job(const igemm_job_t* j) {                            \
+    const TA* A = (const TA*)j->A;                                        \
+    const TA* B = (const TA*)j->B;                                        \
+    TC* C = (TC*)j->C;                                                    \
+    size_t KCg = IGEMM_CEIL(IGEMM_KC, KG) * KG;                           \
+    TA* Ap = __ALLOC_DATA(TA, IGEMM_MC * KCg);                            \
+    TA* Bp = __ALLOC_DATA(TA, IGEMM_NC * KCg);                            \
+    TC tile[IGEMM_MR * NR] __attribute__((aligned(32)));                  \
+                                                                          \
+    for (size_t jc = 0; jc < j->N; jc += IGEMM_NC) {                      \
+        size_t nc = IGEMM_MIN(IGEMM_NC, j->N - jc);                       \
+        for (size_t pc = 0; pc < j->K; pc += IGEMM_KC) {                  \
+            size_t kc = IGEMM_MIN(IGEMM_KC, j->K - pc);                   \
+            size_t kg = IGEMM_CEIL(kc, KG);                               \
+            name##_pack_b(kc, nc, &B[pc * j->ldb + jc], j->ldb, Bp);      \
+                                                                          \
+            for (size_t ic = 0; ic < j->M; ic += IGEMM_MC) {              \
+                size_t mc = IGEMM_MIN(IGEMM_MC, j->M - ic);               \
+                name##_pack_a(mc, kc, &A[ic * j->lda + pc], j->lda, Ap);  \
+                                                                          \
+                for (size_t jr = 0; jr < nc; jr += NR) {                  \
+                    size_t nr = IGEMM_MIN(NR, nc - jr);                   \
+                    for (size_t ir = 0; ir < mc; ir += IGEMM_MR) {        \
+                        size_t mr = IGEMM_MIN(IGEMM_MR, mc - ir);         \
+                        KERNEL(kg, &Ap[ir * kg * KG], &Bp[jr * kg * KG], tile); \
+                        name##_update(tile, &C[(ic + ir) * j->ldc + jc + jr], j->ldc, \
+                                      mr, nr, pc == 0);                   \
+                    }                                                     \
+                }                                                         \
+            }                                                             \
+        }                                                                 \
+    }                                                                     \
+    free(Ap);                                                             \
+    free(Bp);                                                             \
+}
+
+__DEFINE_IGEMM_DRIVER(igemm_s32, int32_t, int32_t, uint32_t, 16, 1, igemm_kernel_s32)
+__DEFINE_IGEMM_DRIVER(igemm_s16, int16_t, int32_t, uint32_t, 16, 2, igemm_kernel_s16)
+__DEFINE_IGEMM_DRIVER(igemm_s64, int32_t, int64_t, uint64_t, 8, 1, igemm_kernel_s64)
+
+/* ------------------------------------------------------------------ */
+/* Threads: contiguous row ranges, whole micro-panels each             */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+    igemm_job_t job;
+    void (*fn)(const igemm_job_t* job);
+    pthread_t thread;
+} igemm_thread_t;
+
+static void* igemm_worker(void* arg) {
+    igemm_thread_t* t = (igemm_thread_t*)arg;
+    if (t->job.M > 0) t->fn(&t->job);
+    return NULL;
+}
+
+static void igemm_parallel(const igemm_job_t* job, void (*fn)(const igemm_job_t*),
+                           size_t in_size, size_t out_size, int nthreads) {
+    if (job->M == 0 || job->N == 0) return;
+    if (job->K == 0) {
+        for (size_t i = 0; i < job->M; i++) {
+            memset((char*)job->C + i * job->ldc * out_size, 0, job->N * out_size);
+        }
+        return;
+    }
+
+    if (nthreads <= 0) {
+        long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+        nthreads = ncpus > 0 ? (int)ncpus : 1;
+    }
+    size_t panels = IGEMM_CEIL(job->M, IGEMM_MR);
+    if ((size_t)nthreads > panels) nthreads = (int)panels;
+
+    igemm_thread_t threads[nthreads];
+    for (int t = 0; t < nthreads; t++) {
+        size_t r0 = IGEMM_MIN(panels * t / nthreads * IGEMM_MR, job->M);
+        size_t r1 = IGEMM_MIN(panels * (t + 1) / nthreads * IGEMM_MR, job->M);
+        threads[t].fn = fn;
+        threads[t].job = *job;
+        threads[t].job.M = r1 - r0;
+        threads[t].job.A = (const char*)job->A + r0 * job->lda * in_size;
+        threads[t].job.C = (char*)job->C + r0 * job->ldc * out_size;
+        if (t > 0) pthread_create(&threads[t].thread, NULL, igemm_worker, &threads[t]);
+    }
+
+    igemm_worker(&threads[0]);
+
+    for (int t = 1; t < nthreads; t++) {
+        pthread_join(threads[t].thread, NULL);
+    }
+}
+
+void igemm_s32s32s32(size_t M, size_t N, size_t K,
+                     const int32_t* A, size_t lda,
+                     const int32_t* B, size_t ldb,
+                     int32_t* C, size_t ldc, int nthreads) {
+    igemm_job_t job = { M, N, K, A, lda, B, ldb, C, ldc };
+    igemm_parallel(&job, igemm_s32_job, sizeof(int32_t), sizeof(int32_t), nthreads);
+}
+
+void igemm_s16s16s32(size_t M, size_t N, size_t K,
+                     const int16_t* A, size_t lda,
+                     const int16_t* B, size_t ldb,
+                     int32_t* C, size_t ldc, int nthreads) {
+    igemm_job_t job = { M, N, K, A, lda, B, ldb, C, ldc };
+    igemm_parallel(&job, igemm_s16_job, sizeof(int16_t), sizeof(int32_t), nthreads);
+}
+
+void igemm_s32s32s64(size_t M, size_t N, size_t K,
+                     const int32_t* A, size_t lda,
+                     const int32_t* B, size_t ldb,
+                     int64_t* C, size_t ldc, int nthreads) {
+    igemm_job_t job = { M, N, K, A, lda, B, ldb, C, ldc };
+    igemm_parallel(&job, igemm_s64_job, sizeof(int32_t), sizeof(int64_t), nthreads);
+}
@@ -0,0 +1,33 @@
+#ifndef __IMPL_IGEMM_H_
+#define __IMPL_IGEMM_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Exact integer GEMM, C = A * B, all row-major. Sums of float products
+ * stop being exact once they pass 2^24; these paths stay exact:
+ *
+ *  - s32s32s32: int32 inputs, int32 accumulation (vpmulld)
+ *  - s16s16s32: int16 inputs, int32 accumulation (vpmaddwd on k pairs)
+ *  - s32s32s64: int32 inputs, int64 accumulation (vpmuldq)
+ *
+ * int32 accumulation wraps: the result is the exact product modulo
+ * 2^32, hence exact whenever it fits in an int32. int64 accumulation is
+ * exact for K * max|a| * max|b| < 2^63. Rows of C are split over
+ * nthreads threads (<= 0: all CPUs).                                */
+void igemm_s32s32s32(size_t M, size_t N, size_t K,
+                     const int32_t* A, size_t lda,
+                     const int32_t* B, size_t ldb,
+                     int32_t* C, size_t ldc, int nthreads);
+
+void igemm_s16s16s32(size_t M, size_t N, size_t K,
+                     const int16_t* A, size_t lda,
+                     const int16_t* B, size_t ldb,
+                     int32_t* C, size_t ldc, int nthreads);
+
+void igemm_s32s32s64(size_t M, size_t N, size_t K,
+                     const int32_t* A, size_t lda,
+                     const int32_t* B, size_t ldb,
+                     int64_t* C, size_t ldc, int nthreads);
+
+#endif //__IMPL_IGEMM_H_
@@ -0,0 +1,190 @@
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+/*  -> SIMD header file  */
+#if defined(__amd64__) || defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+/* Include application-specific headers */
+#include "include/types.h"
+#include "impl/gemm.h"
+#include "impl/mimd.h"
+#include "impl/lu.h"
+
+/* Panel columns factored one at a time: one cache line of every row */
+#define LU_LEAF 16
+
+#define LU_MIN(a, b) ((a) < (b) ? (a) : (b))
+
+/* Swap columns [c0, c0 + ncols) of rows r0 and r1 */
+static void lu_swap_rows(float* A, size_t lda, size_t r0, size_t r1, size_t c0, size_t ncols) {
+    float* x = &A[r0 * lda + c0];
+    float* y = &A[r1 * lda + c0];
+    for (size_t j = 0; j < ncols; j++) {
+        float t = x[j];
+        x[j] = y[j];
+        y[j] = t;
+    }
+}
+
+/* B (m x ncols) = L^-1 B, L being the unit lower triangle of the
+ * m x m block at L; row i of B takes one axpy per row above it       */
+static void lu_trsm(size_t m, size_t ncols, const float* L, size_t ldl, float* B, size_t ldb) {
+    for (size_t i = 1; i < m; i++) {
+        float* bi = &B[i * ldb];
+        for (size_t p = 0; p < i; p++) {
+            float l = L[i * ldl + p];
+            const float* bp = &B[p * ldb];
+            if (l == 0.0f) continue;
+            for (size_t j = 0; j < ncols; j++) bi[j] -= l * bp[j];
+        }
+    }
+}
+
+/* Factor the m x w panel at P (m >= w). piv[j] is the row, relative to
+ * the top of the panel, interchanged with row j. The left half is
+ * factored first, the right half updated with the GEMM and factored,
+ * and its interchanges applied back to the left half.               */
+static int lu_panel(size_t m, size_t w, float* P, size_t ld, size_t* piv) {
+    int info = 0;
+
+    if (w <= LU_LEAF) {
+        for (size_t j = 0; j < w; j++) {
+            size_t p = j;
+            float best = fabsf(P[j * ld + j]);
+            for (size_t i = j + 1; i < m; i++) {
+                float v = fabsf(P[i * ld + j]);
+                if (v > best) {
+                    best = v;
+                    p = i;
+                }
+            }
+            piv[j] = p;
+            if (p != j) lu_swap_rows(P, ld, j, p, 0, w);
+
+            float d = P[j * ld + j];
+            if (d == 0.0f) {
+                if (info == 0) info = (int)j + 1;
+                continue;
+            }
+            float inv = 1.0f / d;
+            const float* uj = &P[j * ld + j + 1];
+            for (size_t i = j + 1; i < m; i++) {
+                float* ri = &P[i * ld];
+                float l = (ri[j] *= inv);
+                for (size_t c = 0; c < w - j - 1; c++) ri[j + 1 + c] -= l * uj[c];
+            }
+        }
+        return info;
+    }
+
+    size_t w1 = w / 2, w2 = w - w1;
+
+    info = lu_panel(m, w1, P, ld, piv);
+    for (size_t j = 0; j < w1; j++) {
+        if (piv[j] != j) lu_swap_rows(P, ld, j, piv[j], w1, w2);
+    }
+
+    /* A12 = L11^-1 A12, A22 -= A21 * A12 */
+    lu_trsm(w1, w2, P, ld, &P[w1], ld);
+    gemm_sgemm(0, 0, m - w1, w2, w1, -1.0f, &P[w1 * ld], ld, &P[w1], ld,
+               1.0f, &P[w1 * ld + w1], ld, NULL, NULL);
+
+    int info2 = lu_panel(m - w1, w2, &P[w1 * ld + w1], ld, &piv[w1]);
+    if (info == 0 && info2 != 0) info = info2 + (int)w1;
+    for (size_t j = w1; j < w; j++) {
+        piv[j] += w1;
+        if (piv[j] != j) lu_swap_rows(P, ld, j, piv[j], 0, w1);
+    }
+    return info;
+}
+
+/* A22 (m x n) -= L21 (m x k) * U12 (k x n) on all threads */
+static void lu_update(size_t m, size_t n, size_t k, const float* L21, const float* U12,
+                      float* A22, size_t lda, int nthreads) {
+    args_t args;
+    memset(&args, 0, sizeof(args));
+    args.input0 = (void*)L21;
+    args.input1 = (void*)U12;
+    args.output = A22;
+    args.M = m;
+    args.K = k;
+    args.N = n;
+    args.lda = args.ldb = args.ldr = lda;
+    args.layout = MMULT_ROW_MAJOR;
+    args.transa = MMULT_NO_TRANS;
+    args.transb = MMULT_NO_TRANS;
+    args.alpha = -1.0f;
+    args.beta = 1.0f;
+    args.nthreads = nthreads;
+    impl_mimd(&args);
+}
+
+int lu_factor(size_t n, float* A, size_t lda, size_t* ipiv, size_t nb, int nthreads) {
+    int info = 0;
+    if (nb == 0) nb = LU_NB;
+
+    for (size_t k = 0; k < n; k += nb) {
+        size_t w = LU_MIN(nb, n - k);
+        size_t rest = n - k - w;
+
+        int pinfo = lu_panel(n - k, w, &A[k * lda + k], lda, &ipiv[k]);
+        if (info == 0 && pinfo != 0) info = pinfo + (int)k;
+
+        /* The panel's interchanges, on the columns left and right of it */
+        for (size_t j = k; j < k + w; j++) {
+            ipiv[j] += k;
+            if (ipiv[j] != j) {
+                lu_swap_rows(A, lda, j, ipiv[j], 0, k);
+                lu_swap_rows(A, lda, j, ipiv[j], k + w, rest);
+            }
+        }
+
+        if (rest > 0) {
+            lu_trsm(w, rest, &A[k * lda + k], lda, &A[k * lda + k + w], lda);
+            lu_update(rest, rest, w, &A[(k + w) * lda + k], &A[k * lda + k + w],
+                      &A[(k + w) * lda + k + w], lda, nthreads);
+        }
+    }
+    return info;
+}
+
+static float lu_dot(size_t n, const float* x, const float* y) {
+    size_t i = 0;
+    float s = 0.0f;
+#if defined(__AVX__) && defined(__FMA__)
+    __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(&x[i]), _mm256_loadu_ps(&y[i]), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(&x[i + 8]), _mm256_loadu_ps(&y[i + 8]), acc1);
+    }
+    __m256 acc = _mm256_add_ps(acc0, acc1);
+    __m128 h = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    h = _mm_add_ps(h, _mm_movehl_ps(h, h));
+    h = _mm_add_ss(h, _mm_shuffle_ps(h, h, 1));
+    s = _mm_cvtss_f32(h);
+#endif
+    for (; i < n; i++) s += x[i] * y[i];
+    return s;
+}
+
+void lu_solve(size_t n, const float* LU, size_t lda, const size_t* ipiv, float* b) {
+    for (size_t i = 0; i < n; i++) {
+        if (ipiv[i] != i) {
+            float t = b[i];
+            b[i] = b[ipiv[i]];
+            b[ipiv[i]] = t;
+        }
+    }
+
+    /* L y = P b (unit diagonal), then U x = y; rows are contiguous */
+    for (size_t i = 1; i < n; i++) {
+        b[i] -= lu_dot(i, &LU[i * lda], b);
+    }
+    for (size_t i = n; i-- > 0;) {
+        b[i] = (b[i] - lu_dot(n - i - 1, &LU[i * lda + i + 1], &b[i + 1])) / LU[i * lda + i];
+    }
+}
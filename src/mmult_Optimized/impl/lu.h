@@ -0,0 +1,36 @@
+/* lu.h
+ *
+ * LU factorization with partial pivoting, PA = LU, of a row-major
+ * n x n matrix, and the solver built on it. The factorization is
+ * right-looking and blocked: for every NB-column panel,
+ *
+ *  1. the panel is factored (recursively: halves of it are updated
+ *     with the packed GEMM, columns at the leaves),
+ *  2. its row interchanges are applied to the columns left and right,
+ *  3. the block row right of it is solved with the unit lower
+ *     triangle of the panel (L11^-1 A12),
+ *  4. the trailing matrix takes the rank-NB update A22 -= L21 * U12
+ *     through the multithreaded packed GEMM (impl_mimd).
+ *
+ * Step 4 carries all but O(n^2 NB) of the 2/3 n^3 flops.
+ */
+
+#ifndef __IMPL_LU_H_
+#define __IMPL_LU_H_
+
+#include <stddef.h>
+
+/* Default panel width */
+#define LU_NB 128
+
+/* Factor A (n x n, leading dimension lda) in place: L below the
+ * diagonal (unit diagonal implied), U on and above it. Row i was
+ * interchanged with row ipiv[i] >= i at step i. nb = 0 uses LU_NB,
+ * nthreads <= 0 all CPUs for the update. Returns 0, or i + 1 if U(i, i)
+ * is exactly zero (the factorization is completed anyway).          */
+int lu_factor(size_t n, float* A, size_t lda, size_t* ipiv, size_t nb, int nthreads);
+
+/* Solve A x = b with the factors of lu_factor: b is overwritten by x */
+void lu_solve(size_t n, const float* LU, size_t lda, const size_t* ipiv, float* b);
+
+#endif //__IMPL_LU_H_
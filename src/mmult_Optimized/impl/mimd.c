@@ -1,36 +1,124 @@
+#define _GNU_SOURCE
+
 /* Standard C includes */
 #include <stdlib.h>
+#include <stdio.h>
 #include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+/* Include common headers */
+#include "common/macros.h"
+#include "common/types.h"
+
+/* If we are on Darwin, include the compatibility header */
+#if defined(__APPLE__)
+#include "common/mach_pthread_compatibility.h"
+#endif
+
 #include "include/types.h"
+#include "include/layout.h"
+#include "impl/gemm.h"
+#include "impl/gemv.h"
+
+/* Fallback when the L2 size cannot be queried */
+#define MIMD_DEFAULT_L2_BYTES (1024 * 1024)
+
+/* State shared by all threads of one impl_mimd call. The output is cut
+ * into 2D tiles of MC rows by tile_n columns; for every (jc, pc) step
+ * the threads first pack the B panel together, then claim tiles.     */
+typedef struct {
+    mmult_view_t v;
+    const gemm_blocking_t* blocking;
+    size_t tile_n;            /* Columns per tile (multiple of NR)    */
+    int nthreads;
+
+    float* Bp;                /* Packed B panel shared by all threads */
+    pthread_barrier_t barrier;
+    size_t next_tile;         /* Work counter, reset for every step   */
+} mimd_shared_t;
 
 /* Structure to pass data to each thread */
 typedef struct {
-    float* A;
-    float* B;
-    float* R;
-    size_t size;
-    size_t start_row;
-    size_t end_row;
+    mimd_shared_t* shared;
+    int tid;
+    int cpu;
+    pthread_t thread;
 } thread_data_t;
 
+/* Pick the tile width so one thread's slice of the packed B panel
+ * (kc x tile_n floats) occupies about half of its L2.               */
+static size_t mimd_tile_width(size_t kc, size_t nc) {
+    long l2 = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    size_t bytes = (l2 > 0 ? (size_t)l2 : MIMD_DEFAULT_L2_BYTES) / 2;
+    size_t width = bytes / (kc * sizeof(float));
+
+    width = (width / GEMM_NR) * GEMM_NR;
+    if (width < GEMM_NR) width = GEMM_NR;
+    return width < nc ? width : GEMM_ROUND_UP(nc, GEMM_NR);
+}
+
 /* Function executed by each thread */
 void* mimd_worker(void* arg) {
     thread_data_t* data = (thread_data_t*)arg;
-    float* A = data->A;
-    float* B = data->B;
-    float* R = data->R;
-    size_t size = data->size;
-
-    for (size_t i = data->start_row; i < data->end_row; i++) {
-        for (size_t j = 0; j < size; j++) {
-            float sum = 0.0f;
-            for (size_t k = 0; k < size; k++) {
-                sum += A[i * size + k] * B[k * size + j];
+    mimd_shared_t* sh = data->shared;
+    mmult_view_t v = sh->v;
+    size_t MC = sh->blocking->mc, KC = sh->blocking->kc, NC = sh->blocking->nc;
+
+    float* Ap = __ALLOC_DATA(float, GEMM_ROUND_UP(MC, GEMM_MR) * KC);
+    mmult_epilogue_t epi;
+
+    for (size_t jc = 0; jc < v.N; jc += NC) {
+        size_t nc = (v.N - jc < NC) ? v.N - jc : NC;
+        size_t npanels = (nc + GEMM_NR - 1) / GEMM_NR;
+
+        for (size_t pc = 0; pc < v.K; pc += KC) {
+            size_t kc = (v.K - pc < KC) ? v.K - pc : KC;
+
+            /* Cooperative packing: every thread packs a share of the
+             * NR-wide micro-panels of B into the shared buffer.      */
+            size_t p0 = npanels * data->tid / sh->nthreads;
+            size_t p1 = npanels * (data->tid + 1) / sh->nthreads;
+            if (p1 > p0) {
+                size_t j0 = p0 * GEMM_NR;
+                size_t j1 = (p1 * GEMM_NR < nc) ? p1 * GEMM_NR : nc;
+                gemm_pack_b(kc, j1 - j0, GEMM_AT(v.B, v.ldb, v.transb, pc, jc + j0), v.ldb,
+                            v.transb, &sh->Bp[j0 * kc]);
+            }
+
+            if (data->tid == 0) sh->next_tile = 0;
+            pthread_barrier_wait(&sh->barrier);
+
+            /* Claim tiles in row-major order, so consecutive claims
+             * tend to reuse the A block that is already packed.      */
+            size_t mtiles = (v.M + MC - 1) / MC;
+            size_t ntiles = (nc + sh->tile_n - 1) / sh->tile_n;
+            size_t packed_ic = (size_t)-1;
+
+            for (;;) {
+                size_t t = __atomic_fetch_add(&sh->next_tile, 1, __ATOMIC_RELAXED);
+                if (t >= mtiles * ntiles) break;
+
+                size_t ic = (t / ntiles) * MC;
+                size_t jt = (t % ntiles) * sh->tile_n;
+                size_t mc = (v.M - ic < MC) ? v.M - ic : MC;
+                size_t tn = (nc - jt < sh->tile_n) ? nc - jt : sh->tile_n;
+
+                if (ic != packed_ic) {
+                    gemm_pack_a(mc, kc, GEMM_AT(v.A, v.lda, v.transa, ic, pc), v.lda, v.transa, Ap);
+                    packed_ic = ic;
+                }
+                gemm_macro_kernel(mc, tn, kc, Ap, &sh->Bp[jt * kc],
+                                  &v.R[ic * v.ldr + jc + jt], v.ldr, v.alpha, pc > 0 ? 1.0f : v.beta,
+                                  pc + kc == v.K ? mmult_epilogue_at(&v.epi, ic, jc + jt, &epi) : NULL);
             }
-            R[i * size + j] = sum;
+
+            /* The next step overwrites the shared B panel */
+            pthread_barrier_wait(&sh->barrier);
         }
     }
 
+    free(Ap);
     return NULL;
 }
 
@@ -38,31 +126,83 @@ void* mimd_worker(void* arg) {
 void* impl_mimd(void* args) {
     /* Extract arguments */
     args_t* arguments = (args_t*)args;
-    size_t size = arguments->size;
-    float* A = (float*)arguments->input;
-    float* B = (float*)(arguments->input + size * size * sizeof(float));
-    float* R = (float*)arguments->output;
-    int nthreads = 4;
+    mmult_view_t v = mmult_row_major_view(arguments);
+
+    long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (ncpus <= 0) ncpus = 1;
+    int nthreads = arguments->nthreads > 0 ? arguments->nthreads : (int)ncpus;
+
+    /* Nothing to distribute, the serial engine handles empty shapes */
+    if (v.M == 0 || v.N == 0 || v.K == 0 || v.alpha == 0.0f) {
+        gemm_scale(v.M, v.N, v.beta, v.R, v.ldr);
+        if (v.epi.ops) gemm_epilogue(v.M, v.N, &v.epi, v.R, v.ldr);
+        return NULL;
+    }
+
+    /* Matrix-vector and rank-1 shapes are split over rows by their own kernels */
+    if (gemv_dispatch(v.transa, v.transb, v.M, v.N, v.K, v.alpha, v.A, v.lda, v.B, v.ldb,
+                      v.beta, v.R, v.ldr, &v.epi, nthreads)) {
+        return NULL;
+    }
+
+    mimd_shared_t shared;
+    shared.v        = v;
+    shared.blocking = gemm_select_blocking(v.M, v.N, v.K);
+    shared.nthreads = nthreads;
+    shared.tile_n   = mimd_tile_width(shared.blocking->kc < v.K ? shared.blocking->kc : v.K,
+                                      shared.blocking->nc);
+    shared.Bp       = __ALLOC_DATA(float, GEMM_ROUND_UP(shared.blocking->nc, GEMM_NR) *
+                                          shared.blocking->kc);
+    shared.next_tile = 0;
+    pthread_barrier_init(&shared.barrier, NULL, nthreads);
 
-    pthread_t threads[nthreads];
     thread_data_t thread_data[nthreads];
+    cpu_set_t cpuset[nthreads];
 
-    size_t rows_per_thread = size / nthreads;
+    /* The caller works as thread 0; keep its mask to hand it back.
+     * Darwin cannot read a mask back, so the caller is not pinned. */
+    cpu_set_t caller_cpuset;
+#if !defined(__APPLE__)
+    int caller_saved = pthread_getaffinity_np(pthread_self(), sizeof(caller_cpuset),
+                                              &caller_cpuset) == 0;
+#else
+    int caller_saved = 0;
+#endif
 
     for (int t = 0; t < nthreads; t++) {
-        thread_data[t].A = A;
-        thread_data[t].B = B;
-        thread_data[t].R = R;
-        thread_data[t].size = size;
-        thread_data[t].start_row = t * rows_per_thread;
-        thread_data[t].end_row = (t == nthreads - 1) ? size : (t + 1) * rows_per_thread;
-
-        pthread_create(&threads[t], NULL, mimd_worker, &thread_data[t]);
+        thread_data[t].shared = &shared;
+        thread_data[t].tid    = t;
+        thread_data[t].cpu    = (arguments->cpu + t) % ncpus;
+
+        /* Thread 0 is the caller itself */
+        if (t == 0) {
+            thread_data[t].thread = pthread_self();
+        } else {
+            pthread_create(&thread_data[t].thread, NULL, mimd_worker, &thread_data[t]);
+        }
+
+        /* Affinity */
+        if (t == 0 && !caller_saved) continue;
+        CPU_ZERO(&cpuset[t]);
+        CPU_SET(thread_data[t].cpu, &cpuset[t]);
+        int __attribute__((unused)) res_affinity = pthread_setaffinity_np(thread_data[t].thread,
+                                                     sizeof(cpuset[t]), &cpuset[t]);
     }
 
-    for (int t = 0; t < nthreads; t++) {
-        pthread_join(threads[t], NULL);
+    mimd_worker(&thread_data[0]);
+
+    for (int t = 1; t < nthreads; t++) {
+        pthread_join(thread_data[t].thread, NULL);
+    }
+
+#if !defined(__APPLE__)
+    if (caller_saved) {
+        pthread_setaffinity_np(pthread_self(), sizeof(caller_cpuset), &caller_cpuset);
     }
+#endif
+
+    pthread_barrier_destroy(&shared.barrier);
+    free(shared.Bp);
 
     return NULL;
 }
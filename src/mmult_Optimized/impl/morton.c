@@ -0,0 +1,247 @@
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+/*  -> SIMD header file  */
+#if defined(__amd64__) || defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+/* Include common headers */
+#include "common/macros.h"
+#include "common/types.h"
+
+/* Include application-specific headers */
+#include "include/types.h"
+#include "include/layout.h"
+#include "impl/morton.h"
+
+#define MORTON_TILE_ELEMS (MORTON_TILE * MORTON_TILE)
+
+static unsigned ceil_log2(size_t n) {
+    unsigned l = 0;
+    while (((size_t)1 << l) < n) l++;
+    return l;
+}
+
+/* Spread the low 32 bits of x to the even bit positions */
+static uint64_t spread_bits(uint64_t x) {
+    x &= 0xffffffffULL;
+    x = (x | (x << 16)) & 0x0000ffff0000ffffULL;
+    x = (x | (x << 8))  & 0x00ff00ff00ff00ffULL;
+    x = (x | (x << 4))  & 0x0f0f0f0f0f0f0f0fULL;
+    x = (x | (x << 2))  & 0x3333333333333333ULL;
+    x = (x | (x << 1))  & 0x5555555555555555ULL;
+    return x;
+}
+
+/* Z-order index of tile (ti, tj) in a 2^lr x 2^lc grid: the bits of
+ * both coordinates are interleaved up to the shorter side, the rest of
+ * the longer coordinate goes on top, so a rectangular grid is a row
+ * (or column) of square Z-ordered blocks                              */
+static size_t morton_index(size_t ti, size_t tj, unsigned lr, unsigned lc) {
+    unsigned l = lr < lc ? lr : lc;
+    size_t mask = ((size_t)1 << l) - 1;
+    size_t low = (size_t)((spread_bits(ti & mask) << 1) | spread_bits(tj & mask));
+    size_t high = (ti >> l) | (tj >> l);
+    return (high << (2 * l)) | low;
+}
+
+void morton_alloc(morton_t* m, size_t rows, size_t cols) {
+    m->rows = rows;
+    m->cols = cols;
+    m->trows = (rows + MORTON_TILE - 1) / MORTON_TILE;
+    m->tcols = (cols + MORTON_TILE - 1) / MORTON_TILE;
+    m->lr = ceil_log2(m->trows);
+    m->lc = ceil_log2(m->tcols);
+
+    /* Page-aligned, so every tile is exactly one page */
+    size_t ntiles = (size_t)1 << (m->lr + m->lc);
+    m->data = (float*)aligned_alloc(4096, ntiles * MORTON_TILE_ELEMS * sizeof(float));
+    if (m->data == NULL) {
+        printf("\n");
+        printf("  ERROR: Cannot allocate memory!");
+        printf("\n");
+        printf("\n");
+        exit(-1);
+    }
+}
+
+void morton_free(morton_t* m) {
+    free(m->data);
+    m->data = NULL;
+}
+
+float* morton_tile(const morton_t* m, size_t ti, size_t tj) {
+    return m->data + morton_index(ti, tj, m->lr, m->lc) * MORTON_TILE_ELEMS;
+}
+
+void morton_from_row_major(morton_t* m, const float* src, size_t ld, int trans, float scale) {
+    for (size_t ti = 0; ti < m->trows; ti++) {
+        for (size_t tj = 0; tj < m->tcols; tj++) {
+            float* t = morton_tile(m, ti, tj);
+            size_t r1 = m->rows - ti * MORTON_TILE, c1 = m->cols - tj * MORTON_TILE;
+            if (r1 > MORTON_TILE) r1 = MORTON_TILE;
+            if (c1 > MORTON_TILE) c1 = MORTON_TILE;
+
+            if (src == NULL || r1 < MORTON_TILE || c1 < MORTON_TILE) {
+                memset(t, 0, MORTON_TILE_ELEMS * sizeof(float));
+            }
+            if (src == NULL) continue;
+
+            if (!trans) {
+                const float* s = &src[ti * MORTON_TILE * ld + tj * MORTON_TILE];
+                for (size_t r = 0; r < r1; r++) {
+                    for (size_t c = 0; c < c1; c++) {
+                        t[r * MORTON_TILE + c] = scale * s[r * ld + c];
+                    }
+                }
+            } else {
+                /* Stored transposed: walk the source rows contiguously */
+                const float* s = &src[tj * MORTON_TILE * ld + ti * MORTON_TILE];
+                for (size_t c = 0; c < c1; c++) {
+                    for (size_t r = 0; r < r1; r++) {
+                        t[r * MORTON_TILE + c] = scale * s[c * ld + r];
+                    }
+                }
+            }
+        }
+    }
+}
+
+void morton_to_row_major(const morton_t* m, float* dst, size_t ld, const mmult_epilogue_t* epi) {
+    int fused = epi != NULL && epi->ops;
+
+    for (size_t ti = 0; ti < m->trows; ti++) {
+        for (size_t tj = 0; tj < m->tcols; tj++) {
+            const float* t = morton_tile(m, ti, tj);
+            size_t r1 = m->rows - ti * MORTON_TILE, c1 = m->cols - tj * MORTON_TILE;
+            if (r1 > MORTON_TILE) r1 = MORTON_TILE;
+            if (c1 > MORTON_TILE) c1 = MORTON_TILE;
+
+            for (size_t r = 0; r < r1; r++) {
+                size_t i = ti * MORTON_TILE + r;
+                float* d = &dst[i * ld + tj * MORTON_TILE];
+                if (!fused) {
+                    memcpy(d, &t[r * MORTON_TILE], c1 * sizeof(float));
+                    continue;
+                }
+                for (size_t c = 0; c < c1; c++) {
+                    d[c] = mmult_epilogue_apply(epi, i, tj * MORTON_TILE + c, t[r * MORTON_TILE + c]);
+                }
+            }
+        }
+    }
+}
+
+/* C += A * B on single tiles */
+static void morton_tile_kernel(float* restrict C, const float* restrict A, const float* restrict B) {
+#if defined(__AVX2__) && defined(__FMA__)
+    /* 4 rows x 16 columns of C stay in registers across the whole K */
+    for (size_t i = 0; i < MORTON_TILE; i += 4) {
+        for (size_t j = 0; j < MORTON_TILE; j += 16) {
+            __m256 c00 = _mm256_load_ps(&C[(i + 0) * MORTON_TILE + j]);
+            __m256 c01 = _mm256_load_ps(&C[(i + 0) * MORTON_TILE + j + 8]);
+            __m256 c10 = _mm256_load_ps(&C[(i + 1) * MORTON_TILE + j]);
+            __m256 c11 = _mm256_load_ps(&C[(i + 1) * MORTON_TILE + j + 8]);
+            __m256 c20 = _mm256_load_ps(&C[(i + 2) * MORTON_TILE + j]);
+            __m256 c21 = _mm256_load_ps(&C[(i + 2) * MORTON_TILE + j + 8]);
+            __m256 c30 = _mm256_load_ps(&C[(i + 3) * MORTON_TILE + j]);
+            __m256 c31 = _mm256_load_ps(&C[(i + 3) * MORTON_TILE + j + 8]);
+
+            for (size_t k = 0; k < MORTON_TILE; k++) {
+                __m256 b0 = _mm256_load_ps(&B[k * MORTON_TILE + j]);
+                __m256 b1 = _mm256_load_ps(&B[k * MORTON_TILE + j + 8]);
+                __m256 a;
+                a = _mm256_broadcast_ss(&A[(i + 0) * MORTON_TILE + k]);
+                c00 = _mm256_fmadd_ps(a, b0, c00);
+                c01 = _mm256_fmadd_ps(a, b1, c01);
+                a = _mm256_broadcast_ss(&A[(i + 1) * MORTON_TILE + k]);
+                c10 = _mm256_fmadd_ps(a, b0, c10);
+                c11 = _mm256_fmadd_ps(a, b1, c11);
+                a = _mm256_broadcast_ss(&A[(i + 2) * MORTON_TILE + k]);
+                c20 = _mm256_fmadd_ps(a, b0, c20);
+                c21 = _mm256_fmadd_ps(a, b1, c21);
+                a = _mm256_broadcast_ss(&A[(i + 3) * MORTON_TILE + k]);
+                c30 = _mm256_fmadd_ps(a, b0, c30);
+                c31 = _mm256_fmadd_ps(a, b1, c31);
+            }
+
+            _mm256_store_ps(&C[(i + 0) * MORTON_TILE + j], c00);
+            _mm256_store_ps(&C[(i + 0) * MORTON_TILE + j + 8], c01);
+            _mm256_store_ps(&C[(i + 1) * MORTON_TILE + j], c10);
+            _mm256_store_ps(&C[(i + 1) * MORTON_TILE + j + 8], c11);
+            _mm256_store_ps(&C[(i + 2) * MORTON_TILE + j], c20);
+            _mm256_store_ps(&C[(i + 2) * MORTON_TILE + j + 8], c21);
+            _mm256_store_ps(&C[(i + 3) * MORTON_TILE + j], c30);
+            _mm256_store_ps(&C[(i + 3) * MORTON_TILE + j + 8], c31);
+        }
+    }
+#else
+    for (size_t i = 0; i < MORTON_TILE; i++) {
+        for (size_t k = 0; k < MORTON_TILE; k++) {
+            float a = A[i * MORTON_TILE + k];
+            for (size_t j = 0; j < MORTON_TILE; j++) {
+                C[i * MORTON_TILE + j] += a * B[k * MORTON_TILE + j];
+            }
+        }
+    }
+#endif
+}
+
+/* C[i0.., j0..] += A[i0.., k0..] * B[k0.., j0..] over an m x n x k box of
+ * tiles (powers of two). The longest side is halved, so the three
+ * blocks of a call stay roughly square and contiguous at every depth  */
+static void morton_rec(morton_t* C, const morton_t* A, const morton_t* B,
+                       size_t i0, size_t j0, size_t k0, size_t m, size_t n, size_t k) {
+    /* Boxes past the logical grid only hold padding */
+    if (i0 >= C->trows || j0 >= C->tcols || k0 >= A->tcols) return;
+
+    if (m == 1 && n == 1 && k == 1) {
+        morton_tile_kernel(morton_tile(C, i0, j0), morton_tile(A, i0, k0), morton_tile(B, k0, j0));
+        return;
+    }
+
+    if (m >= n && m >= k) {
+        morton_rec(C, A, B, i0, j0, k0, m / 2, n, k);
+        morton_rec(C, A, B, i0 + m / 2, j0, k0, m / 2, n, k);
+    } else if (n >= k) {
+        morton_rec(C, A, B, i0, j0, k0, m, n / 2, k);
+        morton_rec(C, A, B, i0, j0 + n / 2, k0, m, n / 2, k);
+    } else {
+        /* Both halves accumulate into the same C block, one after the other */
+        morton_rec(C, A, B, i0, j0, k0, m, n, k / 2);
+        morton_rec(C, A, B, i0, j0, k0 + k / 2, m, n, k / 2);
+    }
+}
+
+void morton_gemm(morton_t* C, const morton_t* A, const morton_t* B) {
+    if (C->trows == 0 || C->tcols == 0 || A->tcols == 0) return;
+    morton_rec(C, A, B, 0, 0, 0, (size_t)1 << C->lr, (size_t)1 << C->lc, (size_t)1 << A->lc);
+}
+
+void* impl_morton(void* args) {
+    /* Extract arguments */
+    args_t* arguments = (args_t*)args;
+    mmult_view_t v = mmult_row_major_view(arguments);
+
+    morton_t A, B, C;
+    morton_alloc(&A, v.M, v.K);
+    morton_alloc(&B, v.K, v.N);
+    morton_alloc(&C, v.M, v.N);
+
+    /* alpha goes into A, beta * R seeds C; R is not read when beta is 0 */
+    morton_from_row_major(&A, v.A, v.lda, v.transa, v.alpha);
+    morton_from_row_major(&B, v.B, v.ldb, v.transb, 1.0f);
+    morton_from_row_major(&C, v.beta != 0.0f ? v.R : NULL, v.ldr, 0, v.beta);
+
+    morton_gemm(&C, &A, &B);
+
+    morton_to_row_major(&C, v.R, v.ldr, &v.epi);
+
+    morton_free(&A);
+    morton_free(&B);
+    morton_free(&C);
+    return NULL;
+}
@@ -0,0 +1,54 @@
+/* morton.h
+ *
+ * Matrices stored as MORTON_TILE x MORTON_TILE tiles laid out in Z-order
+ * (Morton order) of their tile coordinates, and a divide-and-conquer
+ * multiply on that storage. Every aligned square block of tiles is
+ * contiguous, so halving the largest of M, N, K at each level keeps the
+ * working set of the recursion inside whichever cache it reaches first,
+ * without a blocking parameter per cache level. The tile size only
+ * feeds the register kernel at the leaves.
+ *
+ * The tile grid is rounded up to powers of two; tiles outside the
+ * logical matrix are never touched, and as a tile is one page they are
+ * not backed by memory either.
+ */
+
+#ifndef __IMPL_MORTON_H_
+#define __IMPL_MORTON_H_
+
+#include <stddef.h>
+
+#include "include/types.h"
+
+/* Tile edge in floats: 32 x 32 x 4 bytes = 4 KiB, three tiles fit any L1 */
+#define MORTON_TILE 32
+
+typedef struct {
+    size_t rows, cols;      // Logical shape
+    size_t trows, tcols;    // Tiles covering it
+    unsigned lr, lc;        // log2 of the tile grid rounded up to a power of two
+    float* data;
+} morton_t;
+
+/* Allocate the tiled storage of a rows x cols matrix (contents undefined) */
+void morton_alloc(morton_t* m, size_t rows, size_t cols);
+void morton_free(morton_t* m);
+
+/* Tile (ti, tj), MORTON_TILE x MORTON_TILE floats, row-major inside */
+float* morton_tile(const morton_t* m, size_t ti, size_t tj);
+
+/* m = scale * op(src), src row-major with leading dimension ld and stored
+ * cols x rows when trans is set. src == NULL zero-fills. Padding of the
+ * edge tiles is always zeroed.                                          */
+void morton_from_row_major(morton_t* m, const float* src, size_t ld, int trans, float scale);
+
+/* dst = m (row-major), through the epilogue when epi has operations */
+void morton_to_row_major(const morton_t* m, float* dst, size_t ld, const mmult_epilogue_t* epi);
+
+/* C += A * B on tiled storage; shapes must agree */
+void morton_gemm(morton_t* C, const morton_t* A, const morton_t* B);
+
+/* Function declaration: converts the operands, multiplies, converts back */
+void* impl_morton(void* args);
+
+#endif //__IMPL_MORTON_H_
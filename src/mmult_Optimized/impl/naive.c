@@ -7,27 +7,28 @@
 
 /* Include application-specific headers */
 #include "include/types.h"
+#include "include/layout.h"
 
 
 void* impl_scalar_naive(void* args) {
     /* Extract arguments */
     args_t* arguments = (args_t*)args;
-    size_t size = arguments->size;
+    mmult_view_t v = mmult_row_major_view(arguments);
 
-    float* A = (float*)arguments->input;                            // A starts at the beginning
-    float* B = (float*)(arguments->input + size * size * sizeof(float)); // B starts after A
-    float* R = (float*)arguments->output;
+    float* R = v.R;         // R is M x N
 
-    /* Perform matrix-matrix multiplication */
-    for (size_t i = 0; i < size; i++) {
-        for (size_t j = 0; j < size; j++) {
-            R[i * size + j] = 0.0f; // Initialize the result matrix
-            for (size_t k = 0; k < size; k++) {
-                R[i * size + j] += A[i * size + k] * B[k * size + j];
+    /* Perform matrix-matrix multiplication: R = alpha * op(A) * op(B) + beta * R */
+    for (size_t i = 0; i < v.M; i++) {
+        for (size_t j = 0; j < v.N; j++) {
+            float sum = 0.0f;
+            for (size_t k = 0; k < v.K; k++) {
+                sum += mmult_view_a(&v, i, k) * mmult_view_b(&v, k, j);
             }
+            /* R is only read when beta is non-zero */
+            float r = v.alpha * sum + (v.beta != 0.0f ? v.beta * R[i * v.ldr + j] : 0.0f);
+            R[i * v.ldr + j] = v.epi.ops ? mmult_epilogue_apply(&v.epi, i, j, r) : r;
         }
     }
 
     return NULL;
 }
-
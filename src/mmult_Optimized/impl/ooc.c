@@ -0,0 +1,338 @@
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+
+/* Include common headers */
+#include "common/macros.h"
+#include "common/types.h"
+
+/* Include application-specific headers */
+#include "include/types.h"
+#include "io/matfile.h"
+#include "impl/gemm.h"
+#include "impl/ooc.h"
+
+#define OOC_SLOTS 2
+
+/* Tiles are multiples of this many elements in every dimension */
+#define OOC_TILE_ALIGN 64
+
+typedef struct {
+    float* A;                 /* tile_m x tile_k, ld tile_k */
+    float* B;                 /* tile_k x tile_n, ld tile_n */
+} ooc_slot_t;
+
+typedef struct {
+    const matfile_t* a;
+    const matfile_t* b;
+    size_t M, K, N;
+    size_t tm, tk, tn;
+    size_t nsteps;            /* Tile pairs in the whole product */
+
+    ooc_slot_t slot[OOC_SLOTS];
+
+    pthread_mutex_t lock;
+    pthread_cond_t  cond;
+    size_t loaded;            /* Steps whose tiles are in their slot */
+    size_t consumed;          /* Steps the compute thread is done with */
+    int    failed;
+
+    double load_time;
+    size_t bytes_read;
+} ooc_shared_t;
+
+/* Step s multiplies A(i, p) by B(p, j) with p fastest, then j, then i */
+static void ooc_step_tiles(const ooc_shared_t* sh, size_t s, size_t* i, size_t* j, size_t* p) {
+    size_t np = (sh->K + sh->tk - 1) / sh->tk;
+    size_t nj = (sh->N + sh->tn - 1) / sh->tn;
+    *p = (s % np) * sh->tk;
+    *j = (s / np % nj) * sh->tn;
+    *i = (s / np / nj) * sh->tm;
+}
+
+#define OOC_MIN(a, b) ((a) < (b) ? (a) : (b))
+
+static double ooc_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Ask the kernel to start reading a rows x cols block of a mapping */
+static void ooc_prefetch(const matfile_t* mf, size_t r0, size_t c0, size_t rows, size_t cols) {
+    size_t ld = matfile_ld(&mf->hdr);
+    long page = sysconf(_SC_PAGESIZE);
+    for (size_t r = r0; r < r0 + rows; r++) {
+        uintptr_t lo = (uintptr_t)&mf->data[r * ld + c0] & ~(uintptr_t)(page - 1);
+        uintptr_t hi = (uintptr_t)&mf->data[r * ld + c0 + cols];
+        madvise((void*)lo, hi - lo, MADV_WILLNEED);
+    }
+}
+
+static void* ooc_loader(void* arg) {
+    ooc_shared_t* sh = (ooc_shared_t*)arg;
+    size_t ld_a = matfile_ld(&sh->a->hdr), ld_b = matfile_ld(&sh->b->hdr);
+
+    for (size_t s = 0; s < sh->nsteps; s++) {
+        /* Wait for the slot to be released */
+        pthread_mutex_lock(&sh->lock);
+        while (s >= sh->consumed + OOC_SLOTS && !sh->failed) {
+            pthread_cond_wait(&sh->cond, &sh->lock);
+        }
+        int failed = sh->failed;
+        pthread_mutex_unlock(&sh->lock);
+        if (failed) break;
+
+        double t0 = ooc_now();
+        size_t i, j, p;
+        ooc_step_tiles(sh, s, &i, &j, &p);
+        size_t m = OOC_MIN(sh->tm, sh->M - i);
+        size_t n = OOC_MIN(sh->tn, sh->N - j);
+        size_t k = OOC_MIN(sh->tk, sh->K - p);
+        ooc_slot_t* slot = &sh->slot[s % OOC_SLOTS];
+
+        for (size_t r = 0; r < m; r++) {
+            memcpy(&slot->A[r * sh->tk], &sh->a->data[(i + r) * ld_a + p], k * sizeof(float));
+        }
+        for (size_t r = 0; r < k; r++) {
+            memcpy(&slot->B[r * sh->tn], &sh->b->data[(p + r) * ld_b + j], n * sizeof(float));
+        }
+
+        /* Start the reads for the step after this one */
+        if (s + 1 < sh->nsteps) {
+            ooc_step_tiles(sh, s + 1, &i, &j, &p);
+            ooc_prefetch(sh->a, i, p, OOC_MIN(sh->tm, sh->M - i), OOC_MIN(sh->tk, sh->K - p));
+            ooc_prefetch(sh->b, p, j, OOC_MIN(sh->tk, sh->K - p), OOC_MIN(sh->tn, sh->N - j));
+        }
+
+        sh->load_time += ooc_now() - t0;
+        sh->bytes_read += (m + n) * k * sizeof(float);
+
+        pthread_mutex_lock(&sh->lock);
+        sh->loaded = s + 1;
+        pthread_cond_broadcast(&sh->cond);
+        pthread_mutex_unlock(&sh->lock);
+    }
+    return NULL;
+}
+
+/* C tile += A tile * B tile through the packed kernels */
+static void ooc_multiply(size_t m, size_t n, size_t k, const float* A, size_t lda,
+                         const float* B, size_t ldb, float* C, size_t ldc, int accumulate,
+                         const gemm_blocking_t* blk, float* Ap, float* Bp) {
+    for (size_t jc = 0; jc < n; jc += blk->nc) {
+        size_t nc = OOC_MIN(blk->nc, n - jc);
+        for (size_t pc = 0; pc < k; pc += blk->kc) {
+            size_t kc = OOC_MIN(blk->kc, k - pc);
+            gemm_pack_b(kc, nc, &B[pc * ldb + jc], ldb, 0, Bp);
+            for (size_t ic = 0; ic < m; ic += blk->mc) {
+                size_t mc = OOC_MIN(blk->mc, m - ic);
+                gemm_pack_a(mc, kc, &A[ic * lda + pc], lda, 0, Ap);
+                gemm_macro_kernel(mc, nc, kc, Ap, Bp, &C[ic * ldc + jc], ldc,
+                                  1.0f, (accumulate || pc > 0) ? 1.0f : 0.0f, NULL);
+            }
+        }
+    }
+}
+
+/* Write rows of a C tile to their place in the output file */
+static int ooc_writeback(int fd, const matfile_header_t* hdr, size_t i, size_t j,
+                         size_t m, size_t n, const float* tile, size_t ld) {
+    for (size_t r = 0; r < m; r++) {
+        off_t off = (off_t)(hdr->data_offset + ((i + r) * hdr->cols + j) * sizeof(float));
+        const char* src = (const char*)&tile[r * ld];
+        size_t left = n * sizeof(float);
+        while (left > 0) {
+            ssize_t w = pwrite(fd, src, left, off);
+            if (w < 0) {
+                if (errno == EINTR) continue;
+                return -1;
+            }
+            src += w; off += w; left -= (size_t)w;
+        }
+    }
+    return 0;
+}
+
+/* Packing buffers for the tiles: the blocking clamped to the tile dims */
+static size_t ooc_pack_elems(const gemm_blocking_t* blk, size_t tm, size_t tk, size_t tn,
+                             size_t* a_elems, size_t* b_elems) {
+    size_t kc = OOC_MIN(blk->kc, tk);
+    *a_elems = GEMM_ROUND_UP(OOC_MIN(blk->mc, tm), GEMM_MR) * kc;
+    *b_elems = GEMM_ROUND_UP(OOC_MIN(blk->nc, tn), GEMM_NR) * kc;
+    return *a_elems + *b_elems;
+}
+
+/* Bytes in use for tm x tk x tn tiles: two slots, the C tile, packing */
+static size_t ooc_mem_bytes(const gemm_blocking_t* blk, size_t tm, size_t tk, size_t tn) {
+    size_t a_elems, b_elems;
+    size_t pack = ooc_pack_elems(blk, tm, tk, tn, &a_elems, &b_elems);
+    return (OOC_SLOTS * (tm * tk + tk * tn) + tm * tn + pack) * sizeof(float);
+}
+
+/* Largest square tile T (a multiple of OOC_TILE_ALIGN, clamped to the
+ * matrix dims) whose buffers fit in mem_cap; 0 if even the smallest
+ * does not. The slots and C tile alone take 2 * (T^2 + T^2) + T^2
+ * floats, which bounds the first candidate.                         */
+static size_t ooc_tile_size(const gemm_blocking_t* blk, size_t M, size_t K, size_t N,
+                            size_t mem_cap) {
+    size_t t = (size_t)sqrt((double)mem_cap / (5.0 * sizeof(float)));
+    t = t / OOC_TILE_ALIGN * OOC_TILE_ALIGN;
+    if (t < OOC_TILE_ALIGN) t = OOC_TILE_ALIGN;
+
+    for (; t >= OOC_TILE_ALIGN; t -= OOC_TILE_ALIGN) {
+        if (ooc_mem_bytes(blk, OOC_MIN(t, M), OOC_MIN(t, K), OOC_MIN(t, N)) <= mem_cap) return t;
+    }
+    return 0;
+}
+
+int ooc_gemm(const char* a_path, const char* b_path, const char* c_path,
+             size_t mem_cap, ooc_stats_t* stats) {
+    memset(stats, 0, sizeof(*stats));
+
+    matfile_t a, b, c;
+    if (matfile_map(&a, a_path, 0) != 0) return -1;
+    if (matfile_map(&b, b_path, 0) != 0) {
+        matfile_unmap(&a);
+        return -1;
+    }
+    if (a.hdr.layout != MMULT_ROW_MAJOR || b.hdr.layout != MMULT_ROW_MAJOR ||
+        a.hdr.cols != b.hdr.rows) {
+        fprintf(stderr, "Out-of-core GEMM needs row-major files with matching inner dimensions\n");
+        matfile_unmap(&a);
+        matfile_unmap(&b);
+        return -1;
+    }
+
+    size_t M = a.hdr.rows, K = a.hdr.cols, N = b.hdr.cols;
+
+    /* Tiles, slots and packing buffers all come out of the budget */
+    const gemm_blocking_t* blk = &gemm_default_blocking;
+    size_t t = ooc_tile_size(blk, M ? M : 1, K ? K : 1, N ? N : 1, mem_cap);
+    if (t == 0) {
+        size_t min_bytes = ooc_mem_bytes(blk, OOC_MIN(OOC_TILE_ALIGN, M ? M : 1),
+                                         OOC_MIN(OOC_TILE_ALIGN, K ? K : 1),
+                                         OOC_MIN(OOC_TILE_ALIGN, N ? N : 1));
+        fprintf(stderr, "Out-of-core GEMM needs at least %zu bytes of buffers, the cap is %zu\n",
+                min_bytes, mem_cap);
+        matfile_unmap(&a);
+        matfile_unmap(&b);
+        return -1;
+    }
+
+    /* Output: created at full size, filled with pwrite rather than mapped */
+    if (matfile_create(&c, c_path, M, N, MMULT_ROW_MAJOR) != 0) {
+        matfile_unmap(&a);
+        matfile_unmap(&b);
+        return -1;
+    }
+    munmap(c.map, c.map_size);
+    c.map = NULL;
+    c.data = NULL;
+
+    ooc_shared_t sh;
+    memset(&sh, 0, sizeof(sh));
+    sh.a = &a; sh.b = &b;
+    sh.M = M; sh.K = K; sh.N = N;
+    sh.tm = OOC_MIN(t, M ? M : 1);
+    sh.tk = OOC_MIN(t, K ? K : 1);
+    sh.tn = OOC_MIN(t, N ? N : 1);
+    sh.nsteps = ((M + sh.tm - 1) / sh.tm) * ((N + sh.tn - 1) / sh.tn) * ((K + sh.tk - 1) / sh.tk);
+
+    stats->tile_m = sh.tm;
+    stats->tile_k = sh.tk;
+    stats->tile_n = sh.tn;
+    stats->mem_bytes = ooc_mem_bytes(blk, sh.tm, sh.tk, sh.tn);
+
+    for (int s = 0; s < OOC_SLOTS; s++) {
+        sh.slot[s].A = __ALLOC_DATA(float, sh.tm * sh.tk);
+        sh.slot[s].B = __ALLOC_DATA(float, sh.tk * sh.tn);
+    }
+    float* Ct = __ALLOC_DATA(float, sh.tm * sh.tn);
+    size_t ap_elems, bp_elems;
+    ooc_pack_elems(blk, sh.tm, sh.tk, sh.tn, &ap_elems, &bp_elems);
+    float* Ap = __ALLOC_DATA(float, ap_elems);
+    float* Bp = __ALLOC_DATA(float, bp_elems);
+
+    pthread_mutex_init(&sh.lock, NULL);
+    pthread_cond_init(&sh.cond, NULL);
+
+    /* The file is read front to back within each tile row */
+    madvise(a.map, a.map_size, MADV_SEQUENTIAL);
+
+    int ret = 0;
+    double start = ooc_now();
+
+    pthread_t loader;
+    pthread_create(&loader, NULL, ooc_loader, &sh);
+
+    for (size_t s = 0; s < sh.nsteps; s++) {
+        double t0 = ooc_now();
+        pthread_mutex_lock(&sh.lock);
+        while (sh.loaded <= s) {
+            pthread_cond_wait(&sh.cond, &sh.lock);
+        }
+        pthread_mutex_unlock(&sh.lock);
+        double t1 = ooc_now();
+        stats->stall += t1 - t0;
+
+        size_t i, j, p;
+        ooc_step_tiles(&sh, s, &i, &j, &p);
+        size_t m = OOC_MIN(sh.tm, M - i);
+        size_t n = OOC_MIN(sh.tn, N - j);
+        size_t k = OOC_MIN(sh.tk, K - p);
+        const ooc_slot_t* slot = &sh.slot[s % OOC_SLOTS];
+
+        ooc_multiply(m, n, k, slot->A, sh.tk, slot->B, sh.tn, Ct, sh.tn, p > 0, blk, Ap, Bp);
+        double t2 = ooc_now();
+        stats->compute += t2 - t1;
+
+        /* Release the slot before writing back so the loader can refill it */
+        pthread_mutex_lock(&sh.lock);
+        sh.consumed = s + 1;
+        pthread_cond_broadcast(&sh.cond);
+        pthread_mutex_unlock(&sh.lock);
+
+        /* Last slice of K: the C tile is complete */
+        if (p + k == K) {
+            if (ooc_writeback(c.fd, &c.hdr, i, j, m, n, Ct, sh.tn) != 0) {
+                fprintf(stderr, "Error writing %s: %s\n", c_path, strerror(errno));
+                ret = -1;
+                pthread_mutex_lock(&sh.lock);
+                sh.failed = 1;
+                pthread_cond_broadcast(&sh.cond);
+                pthread_mutex_unlock(&sh.lock);
+                break;
+            }
+            stats->bytes_written += m * n * sizeof(float);
+            stats->writeback += ooc_now() - t2;
+        }
+    }
+
+    pthread_join(loader, NULL);
+    if (ret == 0 && fdatasync(c.fd) != 0) ret = -1;
+    stats->wall = ooc_now() - start;
+    stats->load = sh.load_time;
+    stats->bytes_read = sh.bytes_read;
+
+    pthread_mutex_destroy(&sh.lock);
+    pthread_cond_destroy(&sh.cond);
+    for (int s = 0; s < OOC_SLOTS; s++) {
+        free(sh.slot[s].A);
+        free(sh.slot[s].B);
+    }
+    free(Ct); free(Ap); free(Bp);
+    matfile_unmap(&a);
+    matfile_unmap(&b);
+    matfile_unmap(&c);
+    return ret;
+}
@@ -0,0 +1,37 @@
+/* ooc.h
+ *
+ * Out-of-core GEMM over binary matrix files (io/matfile.h). A and B
+ * are memory-mapped and streamed through a two-slot tile cache: while
+ * the compute thread multiplies the tiles in one slot, a loader thread
+ * copies the next pair of tiles out of the mappings into the other.
+ * Every finished C tile is written back to the output file with
+ * pwrite, so only the tile cache and the packing buffers have to fit
+ * in the memory budget.
+ */
+
+#ifndef __IMPL_OOC_H_
+#define __IMPL_OOC_H_
+
+#include <stddef.h>
+
+/* Timings and traffic of one out-of-core product */
+typedef struct {
+    size_t tile_m, tile_k, tile_n;   /* Tile shape chosen for the budget   */
+    size_t mem_bytes;                /* Tile cache plus packing buffers    */
+    size_t bytes_read;
+    size_t bytes_written;
+    double wall;                     /* Seconds for the whole product      */
+    double load;                     /* Seconds the loader spent copying   */
+    double compute;                  /* Seconds spent in the kernels       */
+    double stall;                    /* Seconds compute waited for tiles   */
+    double writeback;                /* Seconds spent writing C tiles      */
+} ooc_stats_t;
+
+/* C = A * B for row-major matrix files. The output file is created (or
+ * truncated) with the right shape. mem_cap bounds the bytes of tile
+ * and packing buffers in use. Returns 0 on success, -1 on I/O or shape
+ * errors, or when mem_cap is below the smallest working set.         */
+int ooc_gemm(const char* a_path, const char* b_path, const char* c_path,
+             size_t mem_cap, ooc_stats_t* stats);
+
+#endif //__IMPL_OOC_H_
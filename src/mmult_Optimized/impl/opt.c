@@ -1,5 +1,3 @@
-
-
 /* Standard C includes */
 #include <stdlib.h>
 
@@ -9,39 +7,48 @@
 
 /* Include application-specific headers */
 #include "include/types.h"
+#include "include/layout.h"
 
 
 void* impl_scalar_opt(void* args) {
     /* Extract arguments */
     args_t* arguments = (args_t*)args;
-    size_t size = arguments->size;
+    mmult_view_t v = mmult_row_major_view(arguments);
 
-    float* A = (float*)arguments->input;                            // Matrix A
-    float* B = (float*)(arguments->input + size * size * sizeof(float)); // Matrix B
-    float* R = (float*)arguments->output;                           // Result matrix R
+    size_t M = v.M, N = v.N, K = v.K;
+    float* R = v.R;                                                 // Result matrix R
 
     /* Set block size (tunable parameter) */
     size_t block_size = 16; // A typical value for cache optimization (adjust if necessary)
 
-    /* Initialize Result Matrix */
-    for (size_t i = 0; i < size; i++) {
-        for (size_t j = 0; j < size; j++) {
-            R[i * size + j] = 0.0f; // Initialize all elements of R to zero
+    /* Initialize Result Matrix: beta * R, without reading R when beta is 0 */
+    for (size_t i = 0; i < M; i++) {
+        for (size_t j = 0; j < N; j++) {
+            R[i * v.ldr + j] = (v.beta != 0.0f) ? v.beta * R[i * v.ldr + j] : 0.0f;
+            /* Without a K loop the epilogue has to run here */
+            if (K == 0 && v.epi.ops) {
+                R[i * v.ldr + j] = mmult_epilogue_apply(&v.epi, i, j, R[i * v.ldr + j]);
+            }
         }
     }
 
     /* Perform Blocked Matrix Multiplication */
-    for (size_t ii = 0; ii < size; ii += block_size) {
-        for (size_t jj = 0; jj < size; jj += block_size) {
-            for (size_t kk = 0; kk < size; kk += block_size) {
+    for (size_t ii = 0; ii < M; ii += block_size) {
+        for (size_t jj = 0; jj < N; jj += block_size) {
+            for (size_t kk = 0; kk < K; kk += block_size) {
                 /* Multiply blocks */
-                for (size_t i = ii; i < ii + block_size && i < size; i++) {
-                    for (size_t j = jj; j < jj + block_size && j < size; j++) {
-                        float sum = R[i * size + j];
-                        for (size_t k = kk; k < kk + block_size && k < size; k++) {
-                            sum += A[i * size + k] * B[k * size + j];
+                for (size_t i = ii; i < ii + block_size && i < M; i++) {
+                    for (size_t j = jj; j < jj + block_size && j < N; j++) {
+                        float sum = 0.0f;
+                        for (size_t k = kk; k < kk + block_size && k < K; k++) {
+                            sum += mmult_view_a(&v, i, k) * mmult_view_b(&v, k, j);
                         }
-                        R[i * size + j] = sum;
+                        float r = R[i * v.ldr + j] + v.alpha * sum;
+                        /* Last block of K: apply the epilogue on the way out */
+                        if (kk + block_size >= K && v.epi.ops) {
+                            r = mmult_epilogue_apply(&v.epi, i, j, r);
+                        }
+                        R[i * v.ldr + j] = r;
                     }
                 }
             }
@@ -50,4 +57,3 @@ void* impl_scalar_opt(void* args) {
 
     return NULL;
 }
-
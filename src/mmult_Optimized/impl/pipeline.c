@@ -0,0 +1,257 @@
+/* Standard C includes */
+#include <stdlib.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <unistd.h>
+
+/* Include common headers */
+#include "common/macros.h"
+#include "common/types.h"
+
+/* Include application-specific headers */
+#include "include/types.h"
+#include "include/layout.h"
+#include "impl/gemm.h"
+#include "impl/gemv.h"
+#include "impl/pipeline.h"
+
+#define PIPE_SLOTS 2
+
+#define PIPE_MIN(a, b) ((a) < (b) ? (a) : (b))
+#define PIPE_CEIL(a, b) (((a) + (b) - 1) / (b))
+
+static const char* const pipe_mode_names[GEMM_PIPE_NUM_MODES] = {
+    "serial", "interleaved", "thread",
+};
+
+const char* gemm_pipe_mode_name(gemm_pipe_mode_t mode) {
+    return (mode < GEMM_PIPE_NUM_MODES) ? pipe_mode_names[mode] : "unknown";
+}
+
+typedef struct {
+    int transa, transb;
+    size_t M, N, K;
+    const float* A;
+    size_t lda;
+    const float* B;
+    size_t ldb;
+    size_t MC, KC, NC;
+    size_t ni;                /* MC blocks per B panel */
+    size_t njobs;
+
+    float* Ap[PIPE_SLOTS];    /* Job s uses Ap[s % 2]            */
+    float* Bp[PIPE_SLOTS];    /* B panel q uses Bp[q % 2]        */
+
+    /* Thread mode */
+    pthread_mutex_t lock;
+    pthread_cond_t  cond;
+    size_t loaded;            /* Jobs whose operands are packed  */
+    size_t consumed;          /* Jobs the multiply is done with  */
+} pipe_t;
+
+/* Job s: block ic of the (jc, pc) panel, panels ordered as in the
+ * blocked loop (pc fastest); the first job of a panel packs it     */
+typedef struct {
+    size_t ic, pc, jc;
+    size_t mc, kc, nc;
+    size_t panel;
+    int new_panel;
+} pipe_job_t;
+
+static void pipe_job(const pipe_t* p, size_t s, pipe_job_t* job) {
+    size_t np = PIPE_CEIL(p->K, p->KC);
+
+    job->panel = s / p->ni;
+    job->new_panel = (s % p->ni) == 0;
+    job->ic = (s % p->ni) * p->MC;
+    job->pc = (job->panel % np) * p->KC;
+    job->jc = (job->panel / np) * p->NC;
+    job->mc = PIPE_MIN(p->MC, p->M - job->ic);
+    job->kc = PIPE_MIN(p->KC, p->K - job->pc);
+    job->nc = PIPE_MIN(p->NC, p->N - job->jc);
+}
+
+/* The packing of a job, in micro-panels: those of its B panel (only
+ * for the first job of the panel), then those of its A block        */
+static size_t pipe_units(const pipe_job_t* job) {
+    return (job->new_panel ? PIPE_CEIL(job->nc, GEMM_NR) : 0) + PIPE_CEIL(job->mc, GEMM_MR);
+}
+
+/* Pack micro-panels [u0, u1) of job s */
+static void pipe_pack(const pipe_t* p, size_t s, const pipe_job_t* job, size_t u0, size_t u1) {
+    size_t nb = job->new_panel ? PIPE_CEIL(job->nc, GEMM_NR) : 0;
+
+    if (u0 < nb) {
+        size_t c0 = u0 * GEMM_NR, c1 = PIPE_MIN(PIPE_MIN(u1, nb) * GEMM_NR, job->nc);
+        gemm_pack_b(job->kc, c1 - c0, GEMM_AT(p->B, p->ldb, p->transb, job->pc, job->jc + c0),
+                    p->ldb, p->transb, &p->Bp[job->panel % PIPE_SLOTS][c0 * job->kc]);
+    }
+    if (u1 > nb) {
+        size_t a0 = (u0 > nb ? u0 - nb : 0) * GEMM_MR;
+        size_t a1 = PIPE_MIN((u1 - nb) * GEMM_MR, job->mc);
+        gemm_pack_a(a1 - a0, job->kc, GEMM_AT(p->A, p->lda, p->transa, job->ic + a0, job->pc),
+                    p->lda, p->transa, &p->Ap[s % PIPE_SLOTS][a0 * job->kc]);
+    }
+}
+
+/* Multiply job s; with next set, pack an even share of job s + 1
+ * after every column of micro-tiles                               */
+static void pipe_multiply(const pipe_t* p, size_t s, const pipe_job_t* job, const pipe_job_t* next,
+                          float alpha, float beta, float* C, size_t ldc,
+                          const mmult_epilogue_t* epi) {
+    mmult_epilogue_t tmp, tmp_tile;
+    const float* Ap = p->Ap[s % PIPE_SLOTS];
+    const float* Bp = p->Bp[job->panel % PIPE_SLOTS];
+    float* Cb = &C[job->ic * ldc + job->jc];
+
+    /* beta applies once, later K slices accumulate and the last one
+     * runs the epilogue before its store                            */
+    float b = job->pc > 0 ? 1.0f : beta;
+    const mmult_epilogue_t* e = (job->pc + job->kc == p->K) ?
+                                mmult_epilogue_at(epi, job->ic, job->jc, &tmp) : NULL;
+
+    size_t units = next ? pipe_units(next) : 0;
+    size_t share = PIPE_CEIL(units, PIPE_CEIL(job->nc, GEMM_NR));
+    size_t u = 0;
+
+    for (size_t jr = 0; jr < job->nc; jr += GEMM_NR) {
+        size_t nr = PIPE_MIN(job->nc - jr, GEMM_NR);
+
+        for (size_t ir = 0; ir < job->mc; ir += GEMM_MR) {
+            size_t mr = PIPE_MIN(job->mc - ir, GEMM_MR);
+
+            gemm_ukernel(job->kc, &Ap[ir * job->kc], &Bp[jr * job->kc],
+                         &Cb[ir * ldc + jr], ldc, mr, nr, alpha, b,
+                         mmult_epilogue_at(e, ir, jr, &tmp_tile));
+        }
+
+        if (u < units) {
+            pipe_pack(p, s + 1, next, u, PIPE_MIN(u + share, units));
+            u += share;
+        }
+    }
+    if (u < units) pipe_pack(p, s + 1, next, u, units);
+}
+
+/* Thread mode: pack every job as soon as its slots are free */
+static void* pipe_packer(void* arg) {
+    pipe_t* p = (pipe_t*)arg;
+
+    for (size_t s = 0; s < p->njobs; s++) {
+        /* Slot s % 2 is free once job s - 2 is done; the B slot of a
+         * new panel was last read by jobs before job s - 1          */
+        pthread_mutex_lock(&p->lock);
+        while (p->consumed + 1 < s) {
+            pthread_cond_wait(&p->cond, &p->lock);
+        }
+        pthread_mutex_unlock(&p->lock);
+
+        pipe_job_t job;
+        pipe_job(p, s, &job);
+        pipe_pack(p, s, &job, 0, pipe_units(&job));
+
+        pthread_mutex_lock(&p->lock);
+        p->loaded = s + 1;
+        pthread_cond_broadcast(&p->cond);
+        pthread_mutex_unlock(&p->lock);
+    }
+    return NULL;
+}
+
+void gemm_sgemm_pipelined(gemm_pipe_mode_t mode,
+                          int transa, int transb, size_t M, size_t N, size_t K,
+                          float alpha, const float* A, size_t lda,
+                          const float* B, size_t ldb,
+                          float beta, float* C, size_t ldc,
+                          const mmult_epilogue_t* epi,
+                          const gemm_blocking_t* blocking) {
+    if (blocking == NULL) blocking = &gemm_default_blocking;
+    if (epi != NULL && epi->ops == 0) epi = NULL;
+
+    /* Nothing to overlap: the plain engine handles empty products too */
+    if (mode == GEMM_PIPE_SERIAL || M == 0 || N == 0 || K == 0 || alpha == 0.0f) {
+        gemm_sgemm_blocked(transa, transb, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc,
+                           epi, blocking);
+        return;
+    }
+
+    pipe_t p = {
+        .transa = transa, .transb = transb, .M = M, .N = N, .K = K,
+        .A = A, .lda = lda, .B = B, .ldb = ldb,
+        .MC = blocking->mc, .KC = blocking->kc, .NC = blocking->nc,
+    };
+    p.ni = PIPE_CEIL(M, p.MC);
+    p.njobs = p.ni * PIPE_CEIL(K, p.KC) * PIPE_CEIL(N, p.NC);
+    for (int s = 0; s < PIPE_SLOTS; s++) {
+        p.Ap[s] = __ALLOC_DATA(float, GEMM_ROUND_UP(p.MC, GEMM_MR) * p.KC);
+        p.Bp[s] = __ALLOC_DATA(float, GEMM_ROUND_UP(p.NC, GEMM_NR) * p.KC);
+    }
+
+    pipe_job_t job, next;
+
+    if (mode == GEMM_PIPE_INTERLEAVED) {
+        /* Prologue: the first job is packed up front */
+        pipe_job(&p, 0, &job);
+        pipe_pack(&p, 0, &job, 0, pipe_units(&job));
+
+        for (size_t s = 0; s < p.njobs; s++) {
+            int last = (s + 1 == p.njobs);
+            if (!last) pipe_job(&p, s + 1, &next);
+            pipe_multiply(&p, s, &job, last ? NULL : &next, alpha, beta, C, ldc, epi);
+            if (!last) job = next;
+        }
+    } else {
+        pthread_t packer;
+        pthread_mutex_init(&p.lock, NULL);
+        pthread_cond_init(&p.cond, NULL);
+        p.loaded = p.consumed = 0;
+        pthread_create(&packer, NULL, pipe_packer, &p);
+
+        for (size_t s = 0; s < p.njobs; s++) {
+            pthread_mutex_lock(&p.lock);
+            while (p.loaded <= s) {
+                pthread_cond_wait(&p.cond, &p.lock);
+            }
+            pthread_mutex_unlock(&p.lock);
+
+            pipe_job(&p, s, &job);
+            pipe_multiply(&p, s, &job, NULL, alpha, beta, C, ldc, epi);
+
+            pthread_mutex_lock(&p.lock);
+            p.consumed = s + 1;
+            pthread_cond_broadcast(&p.cond);
+            pthread_mutex_unlock(&p.lock);
+        }
+
+        pthread_join(packer, NULL);
+        pthread_mutex_destroy(&p.lock);
+        pthread_cond_destroy(&p.cond);
+    }
+
+    for (int s = 0; s < PIPE_SLOTS; s++) {
+        free(p.Ap[s]);
+        free(p.Bp[s]);
+    }
+}
+
+void* impl_pipelined(void* args) {
+    /* Extract arguments */
+    args_t* arguments = (args_t*)args;
+    mmult_view_t v = mmult_row_major_view(arguments);
+
+    long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (ncpus <= 0) ncpus = 1;
+    int nthreads = arguments->nthreads > 0 ? arguments->nthreads : (int)ncpus;
+
+    /* Matrix-vector and rank-1 shapes have nothing to pack */
+    if (gemv_dispatch(v.transa, v.transb, v.M, v.N, v.K, v.alpha, v.A, v.lda, v.B, v.ldb,
+                      v.beta, v.R, v.ldr, &v.epi, 1)) {
+        return NULL;
+    }
+
+    gemm_sgemm_pipelined(nthreads > 1 ? GEMM_PIPE_THREAD : GEMM_PIPE_INTERLEAVED,
+                         v.transa, v.transb, v.M, v.N, v.K, v.alpha, v.A, v.lda, v.B, v.ldb,
+                         v.beta, v.R, v.ldr, &v.epi, gemm_select_blocking(v.M, v.N, v.K));
+
+    return NULL;
+}
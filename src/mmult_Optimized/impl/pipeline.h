@@ -0,0 +1,49 @@
+/* pipeline.h
+ *
+ * The packed GEMM engine (impl/gemm.h) with its packing taken off the
+ * critical path. The blocked loop is a sequence of jobs, one per MC
+ * block of A in every (NC, KC) panel of B; each job multiplies a packed
+ * A block by a packed B panel. Both are double-buffered, so the
+ * operands of job s + 1 are packed while job s is being multiplied:
+ *
+ *  - interleaved: by the same thread, a few micro-panels after every
+ *                 column of micro-tiles, so the packing loads and
+ *                 stores issue between the FMAs of the micro-kernel
+ *  - thread:      by a helper thread, which runs one job ahead
+ *
+ * Serial mode is the plain engine (gemm_sgemm_blocked), which packs
+ * each block right before multiplying it.
+ */
+
+#ifndef __IMPL_PIPELINE_H_
+#define __IMPL_PIPELINE_H_
+
+#include <stddef.h>
+
+#include "include/types.h"
+#include "impl/gemm.h"
+
+typedef enum {
+    GEMM_PIPE_SERIAL = 0,
+    GEMM_PIPE_INTERLEAVED,
+    GEMM_PIPE_THREAD,
+    GEMM_PIPE_NUM_MODES
+} gemm_pipe_mode_t;
+
+const char* gemm_pipe_mode_name(gemm_pipe_mode_t mode);
+
+/* gemm_sgemm_blocked, with the packing of the next job overlapped with
+ * the multiply of the current one as selected by mode              */
+void gemm_sgemm_pipelined(gemm_pipe_mode_t mode,
+                          int transa, int transb, size_t M, size_t N, size_t K,
+                          float alpha, const float* A, size_t lda,
+                          const float* B, size_t ldb,
+                          float beta, float* C, size_t ldc,
+                          const mmult_epilogue_t* epi,
+                          const gemm_blocking_t* blocking);
+
+/* Function declaration: the helper thread packs when it can have a
+ * CPU of its own (nthreads > 1), the interleaved schedule otherwise */
+void* impl_pipelined(void* args);
+
+#endif //__IMPL_PIPELINE_H_
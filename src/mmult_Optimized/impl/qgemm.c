@@ -0,0 +1,250 @@
+/* qgemm.c
+ *
+ * int8 x int8 -> int32 GEMM. B is packed into 16-column micro-panels
+ * in which every group of 4 consecutive k values of a column is 4
+ * adjacent bytes, and rows of A are padded to a multiple of 4 in k.
+ * The 4 x 16 micro-kernel then broadcasts 4 bytes of an A row and
+ * forms 4-term dot products for 8 columns per ymm register.
+ *
+ * Both x86 instructions take an unsigned and a signed operand, so the
+ * sign of a is moved onto b: |a| * (sign(a) * b) == a * b.
+ */
+
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+/*  -> SIMD header file  */
+#if defined(__amd64__) || defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+/* Include common headers */
+#include "common/macros.h"
+#include "common/types.h"
+
+/* Include application-specific headers */
+#include "impl/qgemm.h"
+
+/* Micro-kernel shape and column panel width (packed B stays in L2) */
+#define QGEMM_MR 4
+#define QGEMM_NR 16
+#define QGEMM_NC 512
+
+qgemm_isa_t qgemm_detect_isa(void) {
+#if defined(__amd64__) || defined(__x86_64__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avxvnni")) return QGEMM_ISA_VNNI;
+    if (__builtin_cpu_supports("avx2"))    return QGEMM_ISA_AVX2;
+#endif
+    return QGEMM_ISA_SCALAR;
+}
+
+const char* qgemm_isa_name(qgemm_isa_t isa) {
+    switch (isa) {
+        case QGEMM_ISA_AUTO:   return "auto";
+        case QGEMM_ISA_SCALAR: return "scalar";
+        case QGEMM_ISA_AVX2:   return "avx2";
+        case QGEMM_ISA_VNNI:   return "avx-vnni";
+        default:               return "unknown";
+    }
+}
+
+/* Copy A into rows of Kp bytes, zero padded to Mp rows */
+static void qgemm_pack_a(size_t M, size_t K, size_t Mp, size_t Kp,
+                         const int8_t* A, size_t lda, int8_t* Ap) {
+    memset(Ap, 0, Mp * Kp);
+    for (size_t i = 0; i < M; i++) {
+        memcpy(&Ap[i * Kp], &A[i * lda], K);
+    }
+}
+
+/* Pack a K x nc panel of B: per 16-column micro-panel, per group of 4
+ * k values, 16 columns x 4 bytes                                      */
+static void qgemm_pack_b(size_t K, size_t Kp, size_t nc,
+                         const int8_t* B, size_t ldb, int8_t* Bp) {
+    for (size_t j0 = 0; j0 < nc; j0 += QGEMM_NR) {
+        for (size_t g = 0; g < Kp; g += 4) {
+            for (size_t c = 0; c < QGEMM_NR; c++) {
+                for (size_t q = 0; q < 4; q++) {
+                    size_t k = g + q, j = j0 + c;
+                    *Bp++ = (k < K && j < nc) ? B[k * ldb + j] : 0;
+                }
+            }
+        }
+    }
+}
+
+/* Store the valid part of a 4 x 16 tile */
+static inline void qgemm_store_tile(const int32_t* tile, int32_t* C, size_t ldc,
+                                    size_t mr, size_t nr) {
+    for (size_t r = 0; r < mr; r++) {
+        memcpy(&C[r * ldc], &tile[r * QGEMM_NR], nr * sizeof(int32_t));
+    }
+}
+
+static void qgemm_kernel_scalar(size_t Kp, const int8_t* Ap, const int8_t* Bp,
+                                int32_t* C, size_t ldc, size_t mr, size_t nr) {
+    int32_t tile[QGEMM_MR * QGEMM_NR] = { 0 };
+
+    for (size_t g = 0; g < Kp; g += 4) {
+        for (size_t r = 0; r < QGEMM_MR; r++) {
+            for (size_t c = 0; c < QGEMM_NR; c++) {
+                for (size_t q = 0; q < 4; q++) {
+                    tile[r * QGEMM_NR + c] += (int32_t)Ap[r * Kp + g + q] * Bp[g * QGEMM_NR + c * 4 + q];
+                }
+            }
+        }
+    }
+    qgemm_store_tile(tile, C, ldc, mr, nr);
+}
+
+#if defined(__amd64__) || defined(__x86_64__)
+/* 4-byte broadcast of A[r][g..g+3] */
+#define __QGEMM_BCAST_A(r) ({                                             \
+    int32_t __a;                                                          \
+    memcpy(&__a, &Ap[(r) * Kp + g], sizeof(__a));                         \
+    _mm256_set1_epi32(__a);                                               \
+})
+
+/* Body shared by both x86 kernels; DOT(acc, a, b) accumulates the
+ * 4-term dot products of a and b into the int32 lanes of acc.        */
+#define __DEFINE_QGEMM_KERNEL(name, DOT)                                  \
+static void name(size_t Kp, const int8_t* Ap, const int8_t* Bp,           \
+                 int32_t* C, size_t ldc, size_t mr, size_t nr) {          \
+    __m256i c00 = _mm256_setzero_si256(), c01 = _mm256_setzero_si256();   \
+    __m256i c10 = _mm256_setzero_si256(), c11 = _mm256_setzero_si256();   \
+    __m256i c20 = _mm256_setzero_si256(), c21 = _mm256_setzero_si256();   \
+    __m256i c30 = _mm256_setzero_si256(), c31 = _mm256_setzero_si256();   \
+                                                                          \
+    for (size_t g = 0; g < Kp; g += 4) {                                  \
+        __m256i b0 = _mm256_loadu_si256((const __m256i*)&Bp[g * QGEMM_NR]);      \
+        __m256i b1 = _mm256_loadu_si256((const __m256i*)&Bp[g * QGEMM_NR + 32]); \
+        __m256i a;                                                        \
+        a = __QGEMM_BCAST_A(0); c00 = DOT(c00, a, b0); c01 = DOT(c01, a, b1); \
+        a = __QGEMM_BCAST_A(1); c10 = DOT(c10, a, b0); c11 = DOT(c11, a, b1); \
+        a = __QGEMM_BCAST_A(2); c20 = DOT(c20, a, b0); c21 = DOT(c21, a, b1); \
+        a = __QGEMM_BCAST_A(3); c30 = DOT(c30, a, b0); c31 = DOT(c31, a, b1); \
+    }                                                                     \
+                                                                          \
+    int32_t tile[QGEMM_MR * QGEMM_NR] __attribute__((aligned(32)));       \
+    _mm256_store_si256((__m256i*)&tile[ 0], c00);                         \
+    _mm256_store_si256((__m256i*)&tile[ 8], c01);                         \
+    _mm256_store_si256((__m256i*)&tile[16], c10);                         \
+    _mm256_store_si256((__m256i*)&tile[24], c11);                         \
+    _mm256_store_si256((__m256i*)&tile[32], c20);                         \
+    _mm256_store_si256((__m256i*)&tile[40], c21);                         \
+    _mm256_store_si256((__m256i*)&tile[48], c30);                         \
+    _mm256_store_si256((__m256i*)&tile[56], c31);                         \
+    qgemm_store_tile(tile, C, ldc, mr, nr);                               \
+}
+
+/* vpmaddubsw forms saturating pairwise sums in 16 bits (exact for
+ * |values| <= 127), vpmaddwd with ones widens them to 4-term sums.   */
+__attribute__((target("avx2")))
+static inline __m256i qgemm_dot_avx2(__m256i acc, __m256i a, __m256i b) {
+    __m256i p16 = _mm256_maddubs_epi16(_mm256_abs_epi8(a), _mm256_sign_epi8(b, a));
+    return _mm256_add_epi32(acc, _mm256_madd_epi16(p16, _mm256_set1_epi16(1)));
+}
+
+__attribute__((target("avxvnni")))
+static inline __m256i qgemm_dot_vnni(__m256i acc, __m256i a, __m256i b) {
+    return _mm256_dpbusd_avx_epi32(acc, _mm256_abs_epi8(a), _mm256_sign_epi8(b, a));
+}
+
+__attribute__((target("avx2")))
+__DEFINE_QGEMM_KERNEL(qgemm_kernel_avx2, qgemm_dot_avx2)
+
+__attribute__((target("avx2,avxvnni")))
+__DEFINE_QGEMM_KERNEL(qgemm_kernel_vnni, qgemm_dot_vnni)
+#endif
+
+typedef void (*qgemm_kernel_fn)(size_t Kp, const int8_t* Ap, const int8_t* Bp,
+                                int32_t* C, size_t ldc, size_t mr, size_t nr);
+
+void qgemm_s8s8s32(size_t M, size_t N, size_t K,
+                   const int8_t* A, size_t lda,
+                   const int8_t* B, size_t ldb,
+                   int32_t* C, size_t ldc, qgemm_isa_t isa) {
+    if (isa == QGEMM_ISA_AUTO) isa = qgemm_detect_isa();
+
+    qgemm_kernel_fn kernel = qgemm_kernel_scalar;
+#if defined(__amd64__) || defined(__x86_64__)
+    if (isa == QGEMM_ISA_AVX2) kernel = qgemm_kernel_avx2;
+    if (isa == QGEMM_ISA_VNNI) kernel = qgemm_kernel_vnni;
+#endif
+
+    size_t Kp = ((K + 3) / 4) * 4;
+    size_t Mp = ((M + QGEMM_MR - 1) / QGEMM_MR) * QGEMM_MR;
+    size_t NCp = ((QGEMM_NC + QGEMM_NR - 1) / QGEMM_NR) * QGEMM_NR;
+
+    int8_t* Ap = __ALLOC_DATA(int8_t, (Mp ? Mp : 1) * (Kp ? Kp : 4));
+    int8_t* Bp = __ALLOC_DATA(int8_t, NCp * (Kp ? Kp : 4));
+
+    qgemm_pack_a(M, K, Mp, Kp, A, lda, Ap);
+
+    for (size_t jc = 0; jc < N; jc += QGEMM_NC) {
+        size_t nc = (N - jc < QGEMM_NC) ? N - jc : QGEMM_NC;
+        qgemm_pack_b(K, Kp, nc, &B[jc], ldb, Bp);
+
+        for (size_t jr = 0; jr < nc; jr += QGEMM_NR) {
+            size_t nr = (nc - jr < QGEMM_NR) ? nc - jr : QGEMM_NR;
+
+            for (size_t ir = 0; ir < M; ir += QGEMM_MR) {
+                size_t mr = (M - ir < QGEMM_MR) ? M - ir : QGEMM_MR;
+                kernel(Kp, &Ap[ir * Kp], &Bp[jr * Kp], &C[ir * ldc + jc + jr], ldc, mr, nr);
+            }
+        }
+    }
+
+    free(Ap);
+    free(Bp);
+}
+
+static inline int8_t qgemm_quantize(float x, float inv_scale) {
+    float q = rintf(x * inv_scale);
+    q = q >  QGEMM_QMAX ?  QGEMM_QMAX : q;
+    q = q < -QGEMM_QMAX ? -QGEMM_QMAX : q;
+    return (int8_t)q;
+}
+
+void qgemm_quantize_rows(size_t rows, size_t cols, const float* X, size_t ldx,
+                         int8_t* Q, size_t ldq, float* scales) {
+    for (size_t i = 0; i < rows; i++) {
+        float amax = 0.0f;
+        for (size_t j = 0; j < cols; j++) amax = fmaxf(amax, fabsf(X[i * ldx + j]));
+
+        float scale = amax > 0.0f ? amax / QGEMM_QMAX : 1.0f;
+        float inv = 1.0f / scale;
+        for (size_t j = 0; j < cols; j++) Q[i * ldq + j] = qgemm_quantize(X[i * ldx + j], inv);
+        scales[i] = scale;
+    }
+}
+
+void qgemm_quantize_cols(size_t rows, size_t cols, const float* X, size_t ldx,
+                         int8_t* Q, size_t ldq, float* scales) {
+    for (size_t j = 0; j < cols; j++) scales[j] = 0.0f;
+    for (size_t i = 0; i < rows; i++) {
+        for (size_t j = 0; j < cols; j++) scales[j] = fmaxf(scales[j], fabsf(X[i * ldx + j]));
+    }
+    for (size_t j = 0; j < cols; j++) {
+        scales[j] = scales[j] > 0.0f ? scales[j] / QGEMM_QMAX : 1.0f;
+    }
+    for (size_t i = 0; i < rows; i++) {
+        for (size_t j = 0; j < cols; j++) {
+            Q[i * ldq + j] = qgemm_quantize(X[i * ldx + j], 1.0f / scales[j]);
+        }
+    }
+}
+
+void qgemm_dequantize(size_t M, size_t N, const int32_t* C, size_t ldc,
+                      const float* row_scale, const float* col_scale, float alpha,
+                      float* R, size_t ldr) {
+    for (size_t i = 0; i < M; i++) {
+        float rs = alpha * (row_scale ? row_scale[i] : 1.0f);
+        for (size_t j = 0; j < N; j++) {
+            R[i * ldr + j] = rs * (col_scale ? col_scale[j] : 1.0f) * (float)C[i * ldc + j];
+        }
+    }
+}
@@ -0,0 +1,45 @@
+#ifndef __IMPL_QGEMM_H_
+#define __IMPL_QGEMM_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Instruction sets for the int8 kernel */
+typedef enum {
+    QGEMM_ISA_AUTO = 0,   /* Best available, detected with CPUID */
+    QGEMM_ISA_SCALAR,
+    QGEMM_ISA_AVX2,       /* vpmaddubsw + vpmaddwd               */
+    QGEMM_ISA_VNNI,       /* vpdpbusd (AVX-VNNI)                 */
+} qgemm_isa_t;
+
+/* Largest magnitude of a quantized value. Symmetric quantization to
+ * [-127, 127] keeps every vpmaddubsw pair sum below 2^15, so the
+ * AVX2 path never saturates and all paths are exact.                */
+#define QGEMM_QMAX 127
+
+/* ISA that QGEMM_ISA_AUTO resolves to on this host */
+qgemm_isa_t qgemm_detect_isa(void);
+const char* qgemm_isa_name(qgemm_isa_t isa);
+
+/* C (int32, M x N) = A (int8, M x K) * B (int8, K x N), row-major.
+ * Inputs must lie in [-QGEMM_QMAX, QGEMM_QMAX]. Exact for
+ * K * 127^2 < 2^31.                                                  */
+void qgemm_s8s8s32(size_t M, size_t N, size_t K,
+                   const int8_t* A, size_t lda,
+                   const int8_t* B, size_t ldb,
+                   int32_t* C, size_t ldc, qgemm_isa_t isa);
+
+/* Symmetric quantization with one scale per row of X (for A) or per
+ * column of X (for B): q = round(x / scale), scale = max|x| / 127.   */
+void qgemm_quantize_rows(size_t rows, size_t cols, const float* X, size_t ldx,
+                         int8_t* Q, size_t ldq, float* scales);
+void qgemm_quantize_cols(size_t rows, size_t cols, const float* X, size_t ldx,
+                         int8_t* Q, size_t ldq, float* scales);
+
+/* R[i][j] = alpha * row_scale[i] * col_scale[j] * C[i][j]; either scale
+ * array may be NULL to mean all ones.                                */
+void qgemm_dequantize(size_t M, size_t N, const int32_t* C, size_t ldc,
+                      const float* row_scale, const float* col_scale, float alpha,
+                      float* R, size_t ldr);
+
+#endif //__IMPL_QGEMM_H_
@@ -0,0 +1,201 @@
+/* sparse.c
+ *
+ * CSR sparse matrix kernels. Work is split across threads by non-zeros
+ * rather than by rows: thread t starts at the first row whose offset in
+ * row_ptr reaches t * nnz / nthreads, so skewed row lengths do not
+ * leave threads idle. SpMV gathers x eight non-zeros at a time; SpMM
+ * broadcasts each non-zero and streams the matching row of B into
+ * register-resident accumulators for a 32-column strip of C.
+ */
+
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+/*  -> SIMD header file  */
+#if defined(__amd64__) || defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+/* Include common headers */
+#include "common/macros.h"
+#include "common/types.h"
+
+/* Include application-specific headers */
+#include "impl/sparse.h"
+
+int csr_from_dense(csr_t* csr, size_t rows, size_t cols, const float* X, size_t ldx) {
+    size_t nnz = 0;
+    for (size_t i = 0; i < rows; i++) {
+        for (size_t j = 0; j < cols; j++) nnz += X[i * ldx + j] != 0.0f;
+    }
+
+    csr->rows    = rows;
+    csr->cols    = cols;
+    csr->nnz     = nnz;
+    csr->row_ptr = malloc((rows + 1) * sizeof(size_t));
+    csr->col_idx = malloc((nnz ? nnz : 1) * sizeof(uint32_t));
+    csr->values  = malloc((nnz ? nnz : 1) * sizeof(float));
+    if (!csr->row_ptr || !csr->col_idx || !csr->values) {
+        csr_free(csr);
+        return -1;
+    }
+
+    size_t n = 0;
+    for (size_t i = 0; i < rows; i++) {
+        csr->row_ptr[i] = n;
+        for (size_t j = 0; j < cols; j++) {
+            float v = X[i * ldx + j];
+            if (v != 0.0f) {
+                csr->col_idx[n] = (uint32_t)j;
+                csr->values[n]  = v;
+                n++;
+            }
+        }
+    }
+    csr->row_ptr[rows] = n;
+    return 0;
+}
+
+void csr_to_dense(const csr_t* csr, float* X, size_t ldx) {
+    for (size_t i = 0; i < csr->rows; i++) {
+        memset(&X[i * ldx], 0, csr->cols * sizeof(float));
+        for (size_t n = csr->row_ptr[i]; n < csr->row_ptr[i + 1]; n++) {
+            X[i * ldx + csr->col_idx[n]] = csr->values[n];
+        }
+    }
+}
+
+void csr_free(csr_t* csr) {
+    free(csr->row_ptr);
+    free(csr->col_idx);
+    free(csr->values);
+    csr->row_ptr = NULL;
+    csr->col_idx = NULL;
+    csr->values  = NULL;
+}
+
+/* First row whose non-zeros start at or after `target` */
+static size_t csr_row_at_nnz(const csr_t* A, size_t target) {
+    size_t lo = 0, hi = A->rows;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (A->row_ptr[mid] < target) lo = mid + 1; else hi = mid;
+    }
+    return lo;
+}
+
+static void spmv_rows(const csr_t* A, const float* x, float* y, size_t r0, size_t r1) {
+    for (size_t i = r0; i < r1; i++) {
+        size_t n = A->row_ptr[i], end = A->row_ptr[i + 1];
+        float sum = 0.0f;
+#if defined(__AVX2__) && defined(__FMA__)
+        __m256 acc = _mm256_setzero_ps();
+        for (; n + 8 <= end; n += 8) {
+            __m256i idx = _mm256_loadu_si256((const __m256i*)&A->col_idx[n]);
+            acc = _mm256_fmadd_ps(_mm256_loadu_ps(&A->values[n]),
+                                  _mm256_i32gather_ps(x, idx, sizeof(float)), acc);
+        }
+        __m128 s = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+        s = _mm_hadd_ps(s, s);
+        s = _mm_hadd_ps(s, s);
+        sum = _mm_cvtss_f32(s);
+#endif
+        for (; n < end; n++) sum += A->values[n] * x[A->col_idx[n]];
+        y[i] = sum;
+    }
+}
+
+static void spmm_rows(const csr_t* A, size_t N, const float* B, size_t ldb,
+                      float* C, size_t ldc, size_t r0, size_t r1) {
+    for (size_t i = r0; i < r1; i++) {
+        size_t n0 = A->row_ptr[i], n1 = A->row_ptr[i + 1];
+        float* c = &C[i * ldc];
+        size_t j = 0;
+#if defined(__AVX2__) && defined(__FMA__)
+        for (; j + 32 <= N; j += 32) {
+            __m256 c0 = _mm256_setzero_ps(), c1 = _mm256_setzero_ps();
+            __m256 c2 = _mm256_setzero_ps(), c3 = _mm256_setzero_ps();
+            for (size_t n = n0; n < n1; n++) {
+                __m256 a = _mm256_broadcast_ss(&A->values[n]);
+                const float* b = &B[A->col_idx[n] * ldb + j];
+                c0 = _mm256_fmadd_ps(a, _mm256_loadu_ps(b +  0), c0);
+                c1 = _mm256_fmadd_ps(a, _mm256_loadu_ps(b +  8), c1);
+                c2 = _mm256_fmadd_ps(a, _mm256_loadu_ps(b + 16), c2);
+                c3 = _mm256_fmadd_ps(a, _mm256_loadu_ps(b + 24), c3);
+            }
+            _mm256_storeu_ps(c + j +  0, c0);
+            _mm256_storeu_ps(c + j +  8, c1);
+            _mm256_storeu_ps(c + j + 16, c2);
+            _mm256_storeu_ps(c + j + 24, c3);
+        }
+        for (; j + 8 <= N; j += 8) {
+            __m256 c0 = _mm256_setzero_ps();
+            for (size_t n = n0; n < n1; n++) {
+                c0 = _mm256_fmadd_ps(_mm256_broadcast_ss(&A->values[n]),
+                                     _mm256_loadu_ps(&B[A->col_idx[n] * ldb + j]), c0);
+            }
+            _mm256_storeu_ps(c + j, c0);
+        }
+#endif
+        for (size_t jj = j; jj < N; jj++) c[jj] = 0.0f;
+        for (size_t n = n0; n < n1 && j < N; n++) {
+            const float* b = &B[A->col_idx[n] * ldb];
+            for (size_t jj = j; jj < N; jj++) c[jj] += A->values[n] * b[jj];
+        }
+    }
+}
+
+/* One thread's share of an SpMV or SpMM (N == 0 means SpMV) */
+typedef struct {
+    const csr_t* A;
+    size_t N;
+    const float* B; size_t ldb;
+    float* C; size_t ldc;
+    size_t r0, r1;
+} sparse_task_t;
+
+static void* sparse_worker(void* arg) {
+    sparse_task_t* t = (sparse_task_t*)arg;
+    if (t->N == 0) {
+        spmv_rows(t->A, t->B, t->C, t->r0, t->r1);
+    } else {
+        spmm_rows(t->A, t->N, t->B, t->ldb, t->C, t->ldc, t->r0, t->r1);
+    }
+    return NULL;
+}
+
+static void sparse_run(const sparse_task_t* proto, int nthreads) {
+    const csr_t* A = proto->A;
+    if (nthreads <= 0) nthreads = 1;
+
+    pthread_t tid[nthreads];
+    sparse_task_t tasks[nthreads];
+
+    /* Row-balanced by non-zeros */
+    for (int t = 0; t < nthreads; t++) {
+        tasks[t] = *proto;
+        tasks[t].r0 = (t == 0) ? 0 : csr_row_at_nnz(A, A->nnz * t / nthreads);
+        tasks[t].r1 = (t == nthreads - 1) ? A->rows : csr_row_at_nnz(A, A->nnz * (t + 1) / nthreads);
+        if (t > 0) pthread_create(&tid[t], NULL, sparse_worker, &tasks[t]);
+    }
+
+    sparse_worker(&tasks[0]);
+
+    for (int t = 1; t < nthreads; t++) {
+        pthread_join(tid[t], NULL);
+    }
+}
+
+void csr_spmv(const csr_t* A, const float* x, float* y, int nthreads) {
+    sparse_task_t proto = { .A = A, .N = 0, .B = x, .C = y };
+    sparse_run(&proto, nthreads);
+}
+
+void csr_spmm(const csr_t* A, size_t N, const float* B, size_t ldb,
+              float* C, size_t ldc, int nthreads) {
+    if (N == 0) return;
+    sparse_task_t proto = { .A = A, .N = N, .B = B, .ldb = ldb, .C = C, .ldc = ldc };
+    sparse_run(&proto, nthreads);
+}
@@ -0,0 +1,33 @@
+#ifndef __IMPL_SPARSE_H_
+#define __IMPL_SPARSE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Compressed sparse row matrix */
+typedef struct {
+    size_t    rows;
+    size_t    cols;
+    size_t    nnz;
+    size_t*   row_ptr;   /* rows + 1 offsets into col_idx/values */
+    uint32_t* col_idx;   /* Column of every stored value          */
+    float*    values;
+} csr_t;
+
+/* Build a CSR matrix from the non-zeros of a dense row-major matrix.
+ * Returns 0 on success, -1 on allocation failure.                    */
+int csr_from_dense(csr_t* csr, size_t rows, size_t cols, const float* X, size_t ldx);
+
+/* Expand back into a dense row-major matrix */
+void csr_to_dense(const csr_t* csr, float* X, size_t ldx);
+
+void csr_free(csr_t* csr);
+
+/* y = A * x */
+void csr_spmv(const csr_t* A, const float* x, float* y, int nthreads);
+
+/* C (rows x N) = A * B (cols x N), B and C dense row-major */
+void csr_spmm(const csr_t* A, size_t N, const float* B, size_t ldb,
+              float* C, size_t ldc, int nthreads);
+
+#endif //__IMPL_SPARSE_H_
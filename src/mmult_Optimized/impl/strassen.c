@@ -0,0 +1,157 @@
+/* strassen.c
+ *
+ * Strassen-Winograd multiplication (7 products, 15 additions per
+ * level). Every level splits A, B and C into quadrants and follows the
+ * two-temporary schedule of Boyer, Dumas, Pernet and Zhou, using the
+ * quadrants of C as scratch so only X (mh x max(kh, nh)) and Y
+ * (kh x nh) are needed per level. All temporaries come from a single
+ * workspace sized up front. Odd dimensions are peeled: the even part
+ * recurses, and the extra row, column or rank-1 term is added by the
+ * packed kernel afterwards.
+ */
+
+/* Standard C includes */
+#include <stdlib.h>
+#include <stdio.h>
+
+/* Include common headers */
+#include "common/macros.h"
+#include "common/types.h"
+
+/* Include application-specific headers */
+#include "include/types.h"
+#include "include/layout.h"
+#include "impl/gemm.h"
+#include "impl/strassen.h"
+
+static inline int strassen_is_leaf(size_t M, size_t K, size_t N, size_t cutoff) {
+    return M <= cutoff || K <= cutoff || N <= cutoff || M < 2 || K < 2 || N < 2;
+}
+
+size_t strassen_workspace_size(size_t M, size_t K, size_t N, size_t cutoff) {
+    if (strassen_is_leaf(M, K, N, cutoff)) return 0;
+
+    size_t mh = M / 2, kh = K / 2, nh = N / 2;
+    return mh * (kh > nh ? kh : nh) + kh * nh +
+           strassen_workspace_size(mh, kh, nh, cutoff);
+}
+
+/* Z = X + Y and Z = X - Y over an m x n block */
+static void mat_add(size_t m, size_t n, const float* X, size_t ldx,
+                    const float* Y, size_t ldy, float* Z, size_t ldz) {
+    for (size_t i = 0; i < m; i++) {
+        for (size_t j = 0; j < n; j++) {
+            Z[i * ldz + j] = X[i * ldx + j] + Y[i * ldy + j];
+        }
+    }
+}
+
+static void mat_sub(size_t m, size_t n, const float* X, size_t ldx,
+                    const float* Y, size_t ldy, float* Z, size_t ldz) {
+    for (size_t i = 0; i < m; i++) {
+        for (size_t j = 0; j < n; j++) {
+            Z[i * ldz + j] = X[i * ldx + j] - Y[i * ldy + j];
+        }
+    }
+}
+
+/* One Winograd level over even-sized M, K, N */
+static void winograd_level(size_t M, size_t K, size_t N,
+                           const float* A, size_t lda,
+                           const float* B, size_t ldb,
+                           float* C, size_t ldc,
+                           size_t cutoff, float* ws) {
+    size_t mh = M / 2, kh = K / 2, nh = N / 2;
+
+    const float *A11 = A, *A12 = A + kh, *A21 = A + mh * lda, *A22 = A21 + kh;
+    const float *B11 = B, *B12 = B + nh, *B21 = B + kh * ldb, *B22 = B21 + nh;
+    float *C11 = C, *C12 = C + nh, *C21 = C + mh * ldc, *C22 = C21 + nh;
+
+    /* X holds S_i (mh x kh) and later P1 (mh x nh); Y holds T_i */
+    size_t ldx = kh > nh ? kh : nh, ldy = nh;
+    float* X    = ws;
+    float* Y    = X + mh * ldx;
+    float* next = Y + kh * ldy;
+
+    mat_sub(mh, kh, A11, lda, A21, lda, X, ldx);                           /* S3 = A11 - A21 */
+    mat_sub(kh, nh, B22, ldb, B12, ldb, Y, ldy);                           /* T3 = B22 - B12 */
+    strassen_gemm(mh, kh, nh, X, ldx, Y, ldy, C21, ldc, cutoff, next);    /* P7 = S3 T3     */
+    mat_add(mh, kh, A21, lda, A22, lda, X, ldx);                           /* S1 = A21 + A22 */
+    mat_sub(kh, nh, B12, ldb, B11, ldb, Y, ldy);                           /* T1 = B12 - B11 */
+    strassen_gemm(mh, kh, nh, X, ldx, Y, ldy, C22, ldc, cutoff, next);    /* P5 = S1 T1     */
+    mat_sub(mh, kh, X, ldx, A11, lda, X, ldx);                             /* S2 = S1 - A11  */
+    mat_sub(kh, nh, B22, ldb, Y, ldy, Y, ldy);                             /* T2 = B22 - T1  */
+    strassen_gemm(mh, kh, nh, X, ldx, Y, ldy, C12, ldc, cutoff, next);    /* P6 = S2 T2     */
+    mat_sub(mh, kh, A12, lda, X, ldx, X, ldx);                             /* S4 = A12 - S2  */
+    strassen_gemm(mh, kh, nh, X, ldx, B22, ldb, C11, ldc, cutoff, next);  /* P3 = S4 B22    */
+    strassen_gemm(mh, kh, nh, A11, lda, B11, ldb, X, ldx, cutoff, next);  /* P1 = A11 B11   */
+    mat_add(mh, nh, X, ldx, C12, ldc, C12, ldc);                           /* U2 = P1 + P6   */
+    mat_add(mh, nh, C12, ldc, C21, ldc, C21, ldc);                         /* U3 = U2 + P7   */
+    mat_add(mh, nh, C12, ldc, C22, ldc, C12, ldc);                         /* U4 = U2 + P5   */
+    mat_add(mh, nh, C21, ldc, C22, ldc, C22, ldc);                         /* U7 = U3 + P5   */
+    mat_add(mh, nh, C12, ldc, C11, ldc, C12, ldc);                         /* U5 = U4 + P3   */
+    mat_sub(kh, nh, Y, ldy, B21, ldb, Y, ldy);                             /* T4 = T2 - B21  */
+    strassen_gemm(mh, kh, nh, A22, lda, Y, ldy, C11, ldc, cutoff, next);  /* P4 = A22 T4    */
+    mat_sub(mh, nh, C21, ldc, C11, ldc, C21, ldc);                         /* U6 = U3 - P4   */
+    strassen_gemm(mh, kh, nh, A12, lda, B21, ldb, C11, ldc, cutoff, next); /* P2 = A12 B21   */
+    mat_add(mh, nh, X, ldx, C11, ldc, C11, ldc);                           /* U1 = P1 + P2   */
+}
+
+void strassen_gemm(size_t M, size_t K, size_t N,
+                   const float* A, size_t lda,
+                   const float* B, size_t ldb,
+                   float* C, size_t ldc,
+                   size_t cutoff, float* ws) {
+    if (strassen_is_leaf(M, K, N, cutoff)) {
+        gemm_packed(M, N, K, A, lda, B, ldb, C, ldc, gemm_select_blocking(M, N, K));
+        return;
+    }
+
+    /* Even part through Winograd */
+    size_t m2 = M & ~(size_t)1, k2 = K & ~(size_t)1, n2 = N & ~(size_t)1;
+    winograd_level(m2, k2, n2, A, lda, B, ldb, C, ldc, cutoff, ws);
+
+    /* Peeled depth: rank-1 update with the last column of A and row of B */
+    if (k2 < K) {
+        for (size_t i = 0; i < m2; i++) {
+            float a = A[i * lda + k2];
+            for (size_t j = 0; j < n2; j++) {
+                C[i * ldc + j] += a * B[k2 * ldb + j];
+            }
+        }
+    }
+
+    /* Peeled last column and last row of C */
+    if (n2 < N) {
+        gemm_packed(m2, 1, K, A, lda, &B[n2], ldb, &C[n2], ldc, NULL);
+    }
+    if (m2 < M) {
+        gemm_packed(1, N, K, &A[m2 * lda], lda, B, ldb, &C[m2 * ldc], ldc, NULL);
+    }
+}
+
+/* Strassen Implementation */
+void* impl_strassen(void* args) {
+    /* Extract arguments */
+    args_t* arguments = (args_t*)args;
+    mmult_view_t v = mmult_row_major_view(arguments);
+    size_t cutoff = arguments->cutoff ? arguments->cutoff : STRASSEN_DEFAULT_CUTOFF;
+
+    /* The recursion uses R as scratch and reads its operands by
+     * quadrant, so scaled, transposed or fused products go to the
+     * packed engine                                                    */
+    if (v.transa || v.transb || v.alpha != 1.0f || v.beta != 0.0f || v.epi.ops) {
+        gemm_sgemm(v.transa, v.transb, v.M, v.N, v.K, v.alpha, v.A, v.lda, v.B, v.ldb,
+                   v.beta, v.R, v.ldr, &v.epi, gemm_select_blocking(v.M, v.N, v.K));
+        return NULL;
+    }
+
+    /* Preallocate the workspace arena for every recursion level */
+    size_t ws_size = strassen_workspace_size(v.M, v.K, v.N, cutoff);
+    float* ws = ws_size ? __ALLOC_DATA(float, ws_size) : NULL;
+
+    strassen_gemm(v.M, v.K, v.N, v.A, v.lda, v.B, v.ldb, v.R, v.ldr, cutoff, ws);
+
+    free(ws);
+    return NULL;
+}
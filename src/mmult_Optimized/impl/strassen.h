@@ -0,0 +1,24 @@
+#ifndef __IMPL_STRASSEN_H_
+#define __IMPL_STRASSEN_H_
+
+#include <stddef.h>
+
+/* Recursion stops once M, K or N is at or below this size */
+#define STRASSEN_DEFAULT_CUTOFF 256
+
+/* Function declaration: uses args->cutoff (0 = default) */
+void* impl_strassen(void* args);
+
+/* Floats of workspace needed to multiply M x K by K x N with `cutoff` */
+size_t strassen_workspace_size(size_t M, size_t K, size_t N, size_t cutoff);
+
+/* C = A * B (row-major) with Strassen-Winograd recursion down to
+ * `cutoff`, then the packed blocked kernel. `ws` must hold at least
+ * strassen_workspace_size(M, K, N, cutoff) floats.                  */
+void strassen_gemm(size_t M, size_t K, size_t N,
+                   const float* A, size_t lda,
+                   const float* B, size_t ldb,
+                   float* C, size_t ldc,
+                   size_t cutoff, float* ws);
+
+#endif //__IMPL_STRASSEN_H_
@@ -0,0 +1,324 @@
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <unistd.h>
+
+/* Include common headers */
+#include "common/macros.h"
+#include "common/types.h"
+
+/* Include application-specific headers */
+#include "include/types.h"
+#include "include/layout.h"
+#include "impl/transpose.h"
+
+/* Blocks of work a thread should get before another one is started */
+#define TRANSPOSE_MIN_BLOCKS 4
+
+/* Out-of-place results from this size on are written around the caches */
+#define TRANSPOSE_STREAM_BYTES (16 << 20)
+
+/* One thread's range of blocks */
+typedef struct {
+    size_t rows, cols;       /* Out of place: src shape; in place: n x n */
+    const float* src; size_t lds;
+    float* dst; size_t ldd;
+    int stream;              /* Non-temporal stores of dst              */
+    size_t off;              /* Rows in the head block row              */
+    size_t b0, b1;
+} transpose_task_t;
+
+/* Scalar transpose of a rows x cols block */
+static void transpose_scalar(size_t rows, size_t cols, const float* src, size_t lds,
+                             float* dst, size_t ldd) {
+    for (size_t i = 0; i < rows; i++) {
+        for (size_t j = 0; j < cols; j++) {
+            dst[j * ldd + i] = src[i * lds + j];
+        }
+    }
+}
+
+/* Cache block of the out-of-place transpose: 8 x 8 register tiles
+ * into a contiguous buffer, scalar on the ragged edges             */
+static void transpose_block(size_t rows, size_t cols, const float* src, size_t lds,
+                            float* dst, size_t ldd, int stream) {
+#if defined(__AVX__)
+    size_t r8 = rows & ~(size_t)7, c8 = cols & ~(size_t)7;
+    float buf[TRANSPOSE_BLOCK * TRANSPOSE_BLOCK] __attribute__((aligned(32)));
+    for (size_t i = 0; i < r8; i += 8) {
+        for (size_t j = 0; j < c8; j += 8) {
+            transpose_8x8(&src[i * lds + j], lds, &buf[j * TRANSPOSE_BLOCK + i], TRANSPOSE_BLOCK);
+        }
+    }
+    /* Rows of dst leave the buffer whole: around the caches for a
+     * large dst, which would otherwise be read in before every write */
+    for (size_t j = 0; j < c8; j++) {
+        float* d = &dst[j * ldd];
+        const float* b = &buf[j * TRANSPOSE_BLOCK];
+        size_t i = 0;
+        if (stream) {
+            /* Partial lines at either end are shared with the blocks
+             * beside this one and go through the cache              */
+            size_t head = ((64 - ((uintptr_t)d & 63)) & 63) / sizeof(float);
+            if (head > r8) head = r8;
+            memcpy(d, b, head * sizeof(float));
+            for (i = head; i + 16 <= r8; i += 16) {
+                _mm256_stream_ps(&d[i], _mm256_loadu_ps(&b[i]));
+                _mm256_stream_ps(&d[i + 8], _mm256_loadu_ps(&b[i + 8]));
+            }
+        }
+        memcpy(&d[i], &b[i], (r8 - i) * sizeof(float));
+    }
+    transpose_scalar(r8, cols - c8, &src[c8], lds, &dst[c8 * ldd], ldd);
+    transpose_scalar(rows - r8, cols, &src[r8 * lds], lds, &dst[r8], ldd);
+#else
+    (void)stream;
+    transpose_scalar(rows, cols, src, lds, dst, ldd);
+#endif
+}
+
+/* First row of block row bi: with a head of `off` rows, block row 0
+ * is that head and the rest of the grid starts after it           */
+static size_t transpose_block_row(size_t bi, size_t off) {
+    if (off == 0) return bi * TRANSPOSE_BLOCK;
+    return bi == 0 ? 0 : off + (bi - 1) * TRANSPOSE_BLOCK;
+}
+
+static void* transpose_out_worker(void* arg) {
+    transpose_task_t* t = (transpose_task_t*)arg;
+    size_t nbj = (t->cols + TRANSPOSE_BLOCK - 1) / TRANSPOSE_BLOCK;
+
+    for (size_t b = t->b0; b < t->b1; b++) {
+        size_t i = transpose_block_row(b / nbj, t->off), j = (b % nbj) * TRANSPOSE_BLOCK;
+        size_t bi = transpose_block_row(b / nbj + 1, t->off) - i;
+        size_t bj = (t->cols - j < TRANSPOSE_BLOCK) ? t->cols - j : TRANSPOSE_BLOCK;
+        float* dst = &t->dst[j * t->ldd + i];
+        if (t->rows - i < bi) bi = t->rows - i;
+        transpose_block(bi, bj, &t->src[i * t->lds + j], t->lds, dst, t->ldd, t->stream);
+    }
+#if defined(__AVX__)
+    if (t->stream) _mm_sfence();
+#endif
+    return NULL;
+}
+
+/* Swap tile (ti, tj) with tile (tj, ti), both transposed; a diagonal
+ * tile is transposed on its own                                      */
+static void transpose_swap_8x8(float* X, size_t ld, size_t ti, size_t tj) {
+#if defined(__AVX__)
+    __m256 a[8], b[8];
+    float* pa = &X[ti * ld + tj];
+    float* pb = &X[tj * ld + ti];
+    for (int r = 0; r < 8; r++) a[r] = _mm256_loadu_ps(&pa[r * ld]);
+    transpose_8x8_regs(a);
+    if (ti == tj) {
+        for (int r = 0; r < 8; r++) _mm256_storeu_ps(&pa[r * ld], a[r]);
+        return;
+    }
+    for (int r = 0; r < 8; r++) b[r] = _mm256_loadu_ps(&pb[r * ld]);
+    transpose_8x8_regs(b);
+    for (int r = 0; r < 8; r++) {
+        _mm256_storeu_ps(&pa[r * ld], b[r]);
+        _mm256_storeu_ps(&pb[r * ld], a[r]);
+    }
+#else
+    for (size_t r = 0; r < 8; r++) {
+        for (size_t c = (ti == tj) ? r + 1 : 0; c < 8; c++) {
+            float tmp = X[(ti + r) * ld + tj + c];
+            X[(ti + r) * ld + tj + c] = X[(tj + c) * ld + ti + r];
+            X[(tj + c) * ld + ti + r] = tmp;
+        }
+    }
+#endif
+}
+
+/* In place: block pairs (I, J) with I <= J of the upper triangle are
+ * numbered row by row; every pair swaps its 8 x 8 tiles with the mirror */
+static void* transpose_inplace_worker(void* arg) {
+    transpose_task_t* t = (transpose_task_t*)arg;
+    size_t n8 = t->rows & ~(size_t)7;
+    size_t nb = (n8 + TRANSPOSE_BLOCK - 1) / TRANSPOSE_BLOCK;
+    size_t I = 0, first = 0;
+
+    /* Find the block row holding pair b0: row I has nb - I pairs */
+    while (I < nb && first + (nb - I) <= t->b0) {
+        first += nb - I;
+        I++;
+    }
+
+    for (size_t b = t->b0; b < t->b1; b++) {
+        if (b - first >= nb - I) {
+            first += nb - I;
+            I++;
+        }
+        size_t J = I + (b - first);
+        size_t i0 = I * TRANSPOSE_BLOCK, i1 = (i0 + TRANSPOSE_BLOCK < n8) ? i0 + TRANSPOSE_BLOCK : n8;
+        size_t j0 = J * TRANSPOSE_BLOCK, j1 = (j0 + TRANSPOSE_BLOCK < n8) ? j0 + TRANSPOSE_BLOCK : n8;
+
+        for (size_t ti = i0; ti < i1; ti += 8) {
+            for (size_t tj = (I == J) ? ti : j0; tj < j1; tj += 8) {
+                transpose_swap_8x8(t->dst, t->ldd, ti, tj);
+            }
+        }
+    }
+    return NULL;
+}
+
+/* Run `fn` over nblocks blocks on up to nthreads threads */
+static void transpose_parallel(void* (*fn)(void*), const transpose_task_t* proto,
+                               size_t nblocks, int nthreads) {
+    if (nthreads <= 0) nthreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (nthreads <= 0) nthreads = 1;
+    size_t max_threads = nblocks / TRANSPOSE_MIN_BLOCKS;
+    if ((size_t)nthreads > max_threads) nthreads = max_threads > 0 ? (int)max_threads : 1;
+
+    pthread_t tid[nthreads];
+    transpose_task_t tasks[nthreads];
+    for (int t = 0; t < nthreads; t++) {
+        tasks[t] = *proto;
+        tasks[t].b0 = nblocks * t / nthreads;
+        tasks[t].b1 = nblocks * (t + 1) / nthreads;
+        if (t > 0) pthread_create(&tid[t], NULL, fn, &tasks[t]);
+    }
+
+    fn(&tasks[0]);
+
+    for (int t = 1; t < nthreads; t++) {
+        pthread_join(tid[t], NULL);
+    }
+}
+
+void transpose_out(size_t rows, size_t cols, const float* src, size_t lds,
+                   float* dst, size_t ldd, int nthreads) {
+    /* When all rows of dst share one alignment, the block grid is
+     * shifted so every block writes whole lines of dst               */
+    int stream = rows * cols * sizeof(float) >= TRANSPOSE_STREAM_BYTES && ((uintptr_t)dst & 3) == 0;
+    size_t off = (stream && (ldd * sizeof(float)) % 64 == 0) ?
+                 ((64 - ((uintptr_t)dst & 63)) & 63) / sizeof(float) : 0;
+    if (off >= rows) off = 0;
+
+    transpose_task_t t = { rows, cols, src, lds, dst, ldd, stream, off, 0, 0 };
+    size_t nbi = (off > 0) + (rows - off + TRANSPOSE_BLOCK - 1) / TRANSPOSE_BLOCK;
+    size_t nblocks = nbi * ((cols + TRANSPOSE_BLOCK - 1) / TRANSPOSE_BLOCK);
+    if (rows == 0 || nblocks == 0) return;
+    transpose_parallel(transpose_out_worker, &t, nblocks, nthreads);
+}
+
+void transpose_inplace(size_t n, float* X, size_t ld, int nthreads) {
+    transpose_task_t t = { n, n, X, ld, X, ld, 0, 0, 0, 0 };
+    size_t n8 = n & ~(size_t)7;
+    size_t nb = (n8 + TRANSPOSE_BLOCK - 1) / TRANSPOSE_BLOCK;
+    if (nb > 0) transpose_parallel(transpose_inplace_worker, &t, nb * (nb + 1) / 2, nthreads);
+
+    /* The last n % 8 columns against everything above the diagonal */
+    for (size_t j = n8; j < n; j++) {
+        for (size_t i = 0; i < j; i++) {
+            float tmp = X[i * ld + j];
+            X[i * ld + j] = X[j * ld + i];
+            X[j * ld + i] = tmp;
+        }
+    }
+}
+
+#if defined(__AVX2__) && defined(__FMA__)
+static inline float hsum256(__m256 v) {
+    __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    return _mm_cvtss_f32(_mm_add_ss(s, _mm_movehdup_ps(s)));
+}
+#endif
+
+static float dot(const float* a, const float* b, size_t n) {
+    size_t k = 0;
+    float sum = 0.0f;
+#if defined(__AVX2__) && defined(__FMA__)
+    __m256 acc = _mm256_setzero_ps();
+    for (; k + 8 <= n; k += 8) {
+        acc = _mm256_fmadd_ps(_mm256_loadu_ps(&a[k]), _mm256_loadu_ps(&b[k]), acc);
+    }
+    sum = hsum256(acc);
+#endif
+    for (; k < n; k++) sum += a[k] * b[k];
+    return sum;
+}
+
+/* Columns of B^T per block, so the block stays in L2 while every row
+ * of A goes past it                                                  */
+#define TRANSPOSED_NB 64
+
+void* impl_transposed(void* args) {
+    /* Extract arguments */
+    args_t* arguments = (args_t*)args;
+    mmult_view_t v = mmult_row_major_view(arguments);
+    size_t M = v.M, N = v.N, K = v.K;
+
+    /* Rows of op(A) and of op(B)^T have to be contiguous */
+    const float* Ar = v.A;
+    const float* Bt = v.B;
+    size_t lda = v.lda, ldb = v.ldb;
+    float* At_buf = NULL;
+    float* Bt_buf = NULL;
+    if (v.transa && M * K > 0) {
+        At_buf = __ALLOC_DATA(float, M * K);
+        transpose_out(K, M, v.A, v.lda, At_buf, K, 1);
+        Ar = At_buf;
+        lda = K;
+    }
+    if (!v.transb && K * N > 0) {
+        Bt_buf = __ALLOC_DATA(float, N * K);
+        transpose_out(K, N, v.B, v.ldb, Bt_buf, K, 1);
+        Bt = Bt_buf;
+        ldb = K;
+    }
+
+    for (size_t jb = 0; jb < N; jb += TRANSPOSED_NB) {
+        size_t je = (jb + TRANSPOSED_NB < N) ? jb + TRANSPOSED_NB : N;
+        for (size_t i = 0; i < M; i++) {
+            const float* a = &Ar[i * lda];
+            size_t j = jb;
+#if defined(__AVX2__) && defined(__FMA__)
+            /* Four dot products share every load of the row of A */
+            for (; j + 4 <= je; j += 4) {
+                const float* b0 = &Bt[(j + 0) * ldb];
+                const float* b1 = &Bt[(j + 1) * ldb];
+                const float* b2 = &Bt[(j + 2) * ldb];
+                const float* b3 = &Bt[(j + 3) * ldb];
+                __m256 s0 = _mm256_setzero_ps(), s1 = _mm256_setzero_ps();
+                __m256 s2 = _mm256_setzero_ps(), s3 = _mm256_setzero_ps();
+                size_t k = 0;
+                for (; k + 8 <= K; k += 8) {
+                    __m256 va = _mm256_loadu_ps(&a[k]);
+                    s0 = _mm256_fmadd_ps(va, _mm256_loadu_ps(&b0[k]), s0);
+                    s1 = _mm256_fmadd_ps(va, _mm256_loadu_ps(&b1[k]), s1);
+                    s2 = _mm256_fmadd_ps(va, _mm256_loadu_ps(&b2[k]), s2);
+                    s3 = _mm256_fmadd_ps(va, _mm256_loadu_ps(&b3[k]), s3);
+                }
+                float d[4] = { hsum256(s0), hsum256(s1), hsum256(s2), hsum256(s3) };
+                for (; k < K; k++) {
+                    d[0] += a[k] * b0[k];
+                    d[1] += a[k] * b1[k];
+                    d[2] += a[k] * b2[k];
+                    d[3] += a[k] * b3[k];
+                }
+                for (int q = 0; q < 4; q++) {
+                    float* r = &v.R[i * v.ldr + j + q];
+                    float val = v.alpha * d[q] + (v.beta != 0.0f ? v.beta * *r : 0.0f);
+                    *r = v.epi.ops ? mmult_epilogue_apply(&v.epi, i, j + q, val) : val;
+                }
+            }
+#endif
+            for (; j < je; j++) {
+                float* r = &v.R[i * v.ldr + j];
+                float val = v.alpha * dot(a, &Bt[j * ldb], K) + (v.beta != 0.0f ? v.beta * *r : 0.0f);
+                *r = v.epi.ops ? mmult_epilogue_apply(&v.epi, i, j, val) : val;
+            }
+        }
+    }
+
+    free(At_buf);
+    free(Bt_buf);
+    return NULL;
+}
@@ -0,0 +1,79 @@
+/* transpose.h
+ *
+ * Matrix transposes. The out-of-place kernel walks the matrix in
+ * TRANSPOSE_BLOCK x TRANSPOSE_BLOCK cache blocks, moves 8 x 8 sub-blocks
+ * through registers with AVX shuffles into a contiguous buffer, and
+ * writes whole rows of the result from there; a large, line-aligned
+ * result is written non-temporally, so its lines are not read in
+ * before being overwritten. The in-place kernel (square matrices)
+ * swaps mirrored 8 x 8 tiles the same way. Both split their blocks
+ * across threads.
+ */
+
+#ifndef __IMPL_TRANSPOSE_H_
+#define __IMPL_TRANSPOSE_H_
+
+#include <stddef.h>
+/*  -> SIMD header file  */
+#if defined(__amd64__) || defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+/* Cache block edge in floats: a 64 x 64 block and its transpose take 32 KiB */
+#define TRANSPOSE_BLOCK 64
+
+/* dst (cols x rows, leading dimension ldd) = src^T, src being rows x
+ * cols with leading dimension lds (row-major). nthreads <= 0 uses all
+ * CPUs. src and dst must not overlap.                                */
+void transpose_out(size_t rows, size_t cols, const float* src, size_t lds,
+                   float* dst, size_t ldd, int nthreads);
+
+/* X (n x n, leading dimension ld) = X^T in place */
+void transpose_inplace(size_t n, float* X, size_t ld, int nthreads);
+
+/* Function declaration: R = op(A) * op(B) as dot products of rows of
+ * op(A) with rows of op(B)^T, each made contiguous by a transpose    */
+void* impl_transposed(void* args);
+
+#if defined(__AVX__)
+/* Transpose the 8 x 8 block held in r[0..7] (row i in r[i]) */
+static inline __attribute__((always_inline)) void transpose_8x8_regs(__m256 r[8]) {
+    __m256 t0 = _mm256_unpacklo_ps(r[0], r[1]);
+    __m256 t1 = _mm256_unpackhi_ps(r[0], r[1]);
+    __m256 t2 = _mm256_unpacklo_ps(r[2], r[3]);
+    __m256 t3 = _mm256_unpackhi_ps(r[2], r[3]);
+    __m256 t4 = _mm256_unpacklo_ps(r[4], r[5]);
+    __m256 t5 = _mm256_unpackhi_ps(r[4], r[5]);
+    __m256 t6 = _mm256_unpacklo_ps(r[6], r[7]);
+    __m256 t7 = _mm256_unpackhi_ps(r[6], r[7]);
+
+    __m256 s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+    r[0] = _mm256_permute2f128_ps(s0, s4, 0x20);
+    r[1] = _mm256_permute2f128_ps(s1, s5, 0x20);
+    r[2] = _mm256_permute2f128_ps(s2, s6, 0x20);
+    r[3] = _mm256_permute2f128_ps(s3, s7, 0x20);
+    r[4] = _mm256_permute2f128_ps(s0, s4, 0x31);
+    r[5] = _mm256_permute2f128_ps(s1, s5, 0x31);
+    r[6] = _mm256_permute2f128_ps(s2, s6, 0x31);
+    r[7] = _mm256_permute2f128_ps(s3, s7, 0x31);
+}
+
+/* dst (8 x 8, leading dimension ldd) = src^T (8 x 8, leading dimension lds) */
+static inline __attribute__((always_inline))
+void transpose_8x8(const float* src, size_t lds, float* dst, size_t ldd) {
+    __m256 r[8];
+    for (int i = 0; i < 8; i++) r[i] = _mm256_loadu_ps(&src[i * lds]);
+    transpose_8x8_regs(r);
+    for (int i = 0; i < 8; i++) _mm256_storeu_ps(&dst[i * ldd], r[i]);
+}
+#endif
+
+#endif //__IMPL_TRANSPOSE_H_
@@ -0,0 +1,97 @@
+#ifndef __INCLUDE_LAYOUT_H_
+#define __INCLUDE_LAYOUT_H_
+
+#include <stddef.h>
+
+#include "include/types.h"
+
+/* Row-major view of a multiplication. A column-major product
+ * R = op(A) * op(B) is the row-major product R^T = op(B)^T * op(A)^T
+ * over the same memory, so every kernel only has to implement the
+ * row-major case. A column-major X is a row-major X^T, so the operands
+ * swap but keep their own transpose flags.                           */
+typedef struct {
+    size_t M, N, K;
+    const float* A; size_t lda;
+    const float* B; size_t ldb;
+    float*       R; size_t ldr;
+    int transa, transb;
+    float alpha, beta;
+    mmult_epilogue_t epi;     /* ops == 0 when there is no epilogue */
+} mmult_view_t;
+
+static inline mmult_view_t mmult_row_major_view(const args_t* args) {
+    mmult_view_t v;
+
+    if (args->layout == MMULT_COL_MAJOR) {
+        v.M = args->N; v.N = args->M; v.K = args->K;
+        v.A = (const float*)args->input1; v.lda = args->ldb;
+        v.B = (const float*)args->input0; v.ldb = args->lda;
+        v.transa = args->transb == MMULT_TRANS;
+        v.transb = args->transa == MMULT_TRANS;
+    } else {
+        v.M = args->M; v.N = args->N; v.K = args->K;
+        v.A = (const float*)args->input0; v.lda = args->lda;
+        v.B = (const float*)args->input1; v.ldb = args->ldb;
+        v.transa = args->transa == MMULT_TRANS;
+        v.transb = args->transb == MMULT_TRANS;
+    }
+    v.R = (float*)args->output; v.ldr = args->ldr;
+    v.alpha = args->alpha;
+    v.beta = args->beta;
+
+    /* Rows of a column-major R are the columns of the view */
+    v.epi = args->epilogue ? *args->epilogue : (mmult_epilogue_t){ .ops = 0 };
+    if (args->layout == MMULT_COL_MAJOR) {
+        unsigned ops = v.epi.ops & ~(unsigned)(MMULT_EPI_ROW_BIAS | MMULT_EPI_COL_BIAS);
+        if (v.epi.ops & MMULT_EPI_ROW_BIAS) ops |= MMULT_EPI_COL_BIAS;
+        if (v.epi.ops & MMULT_EPI_COL_BIAS) ops |= MMULT_EPI_ROW_BIAS;
+        const float* row_bias = v.epi.row_bias;
+        v.epi.row_bias = v.epi.col_bias;
+        v.epi.col_bias = row_bias;
+        v.epi.ops = ops;
+    }
+
+    return v;
+}
+
+/* Elements of op(A) and op(B) in a row-major view */
+static inline float mmult_view_a(const mmult_view_t* v, size_t i, size_t k) {
+    return v->transa ? v->A[k * v->lda + i] : v->A[i * v->lda + k];
+}
+
+static inline float mmult_view_b(const mmult_view_t* v, size_t k, size_t j) {
+    return v->transb ? v->B[j * v->ldb + k] : v->B[k * v->ldb + j];
+}
+
+/* Apply an epilogue to element (i, j). The comparisons mirror the
+ * vector max/min instructions so both paths agree on NaN.           */
+static inline float mmult_epilogue_apply(const mmult_epilogue_t* e, size_t i, size_t j, float v) {
+    if (e->ops & MMULT_EPI_ROW_BIAS) v += e->row_bias[i];
+    if (e->ops & MMULT_EPI_COL_BIAS) v += e->col_bias[j];
+    if (e->ops & MMULT_EPI_RELU)     v = v > 0.0f ? v : 0.0f;
+    if (e->ops & MMULT_EPI_CLAMP) {
+        v = v > e->lo ? v : e->lo;
+        v = v < e->hi ? v : e->hi;
+    }
+    if (e->ops & MMULT_EPI_SCALE)    v *= e->scale;
+    return v;
+}
+
+/* The epilogue of the sub-matrix starting at (i, j), in `tmp`.
+ * NULL stays NULL, so callers can pass "no epilogue" through.       */
+static inline const mmult_epilogue_t* mmult_epilogue_at(const mmult_epilogue_t* e, size_t i, size_t j,
+                                                        mmult_epilogue_t* tmp) {
+    if (e == NULL || e->ops == 0) return NULL;
+    *tmp = *e;
+    if (tmp->row_bias) tmp->row_bias += i;
+    if (tmp->col_bias) tmp->col_bias += j;
+    return tmp;
+}
+
+/* Offset of element (i, j) in a matrix with leading dimension ld */
+static inline size_t mmult_index(mmult_layout_t layout, size_t i, size_t j, size_t ld) {
+    return layout == MMULT_COL_MAJOR ? j * ld + i : i * ld + j;
+}
+
+#endif // __INCLUDE_LAYOUT_H_
@@ -3,13 +3,59 @@
 
 #include <stddef.h>  // For size_t
 
-// Define the argument structure
+// Storage order of A, B and R
+typedef enum {
+    MMULT_ROW_MAJOR = 0,   // Element (i, j) at [i * ld + j]
+    MMULT_COL_MAJOR = 1    // Element (i, j) at [j * ld + i]
+} mmult_layout_t;
+
+// Whether an operand is used as stored or transposed
+typedef enum {
+    MMULT_NO_TRANS = 0,    // op(X) = X
+    MMULT_TRANS    = 1     // op(X) = X^T
+} mmult_trans_t;
+
+// Operations fused into the store of R, applied in this order
+typedef enum {
+    MMULT_EPI_ROW_BIAS = 1 << 0,   // R(i, j) += row_bias[i]
+    MMULT_EPI_COL_BIAS = 1 << 1,   // R(i, j) += col_bias[j]
+    MMULT_EPI_RELU     = 1 << 2,   // R = max(R, 0)
+    MMULT_EPI_CLAMP    = 1 << 3,   // R = min(max(R, lo), hi)
+    MMULT_EPI_SCALE    = 1 << 4    // R *= scale
+} mmult_epilogue_op_t;
+
+#define MMULT_EPI_ALL    0x1f      // Every operation
+#define MMULT_EPI_COMBOS 32        // Number of operation subsets
+
+// Epilogue applied to every element of R after the product
+typedef struct {
+    unsigned ops;                  // Bitwise OR of mmult_epilogue_op_t
+    const float* row_bias;         // M entries (MMULT_EPI_ROW_BIAS)
+    const float* col_bias;         // N entries (MMULT_EPI_COL_BIAS)
+    float lo, hi;                  // Bounds (MMULT_EPI_CLAMP)
+    float scale;                   // Factor (MMULT_EPI_SCALE)
+} mmult_epilogue_t;
+
+// Define the argument structure: R (M x N) = alpha * op(A) (M x K) * op(B) (K x N) + beta * R
 typedef struct {
-    void* input;       // Pointer to the input data (e.g., matrices A and B as floats)
-    void* output;      // Pointer to the output data (e.g., result matrix R as floats)
-    size_t size;       // Dimension size (used to define M, N, P)
+    void* input0;      // Pointer to matrix A (floats)
+    void* input1;      // Pointer to matrix B (floats)
+    void* output;      // Pointer to the result matrix R (floats)
+    size_t M;          // Rows of A and R
+    size_t K;          // Columns of A, rows of B
+    size_t N;          // Columns of B and R
+    size_t lda;        // Leading dimension of the stored A (K x M when transposed)
+    size_t ldb;        // Leading dimension of the stored B (N x K when transposed)
+    size_t ldr;        // Leading dimension of R (>= N row-major, >= M column-major)
+    mmult_layout_t layout; // Storage order shared by A, B and R
+    mmult_trans_t transa;  // op(A)
+    mmult_trans_t transb;  // op(B)
+    float alpha;       // Scale of the product
+    float beta;        // Scale of the incoming R (0: R is not read)
+    const mmult_epilogue_t* epilogue; // Fused operations on R (optional, NULL = none)
     int cpu;           // CPU core to execute the benchmark (optional)
     int nthreads;      // Number of threads to use (optional for parallel implementation)
+    size_t cutoff;     // Strassen recursion cutoff (optional, 0 = default)
 } args_t;
 
-#endif // __INCLUDE_TYPES_H_
\ No newline at end of file
+#endif // __INCLUDE_TYPES_H_
@@ -0,0 +1,143 @@
+/* csv.c
+ *
+ * Parallel CSV export. The rows are processed in rounds: each thread
+ * formats one block of rows into its own buffer, then the caller
+ * writes the buffers in order and the next round starts. Fields go
+ * through a fixed-point formatter instead of printf; values it cannot
+ * represent exactly in 64-bit fixed point fall back to snprintf.
+ */
+
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include <unistd.h>
+
+/* Include application-specific headers */
+#include "include/layout.h"
+#include "io/csv.h"
+
+/* Bytes of formatted text each thread produces per round */
+#define CSV_BLOCK_BYTES (4 << 20)
+
+/* Above this magnitude v * 1e6 no longer fits the fast path */
+#define CSV_FAST_LIMIT 1e12
+
+size_t csv_format_float(char* buf, float v) {
+    double d = (double)v;
+    if (!(fabs(d) < CSV_FAST_LIMIT)) {
+        return (size_t)snprintf(buf, CSV_MAX_FIELD, "%.6f", d);
+    }
+
+    char* p = buf;
+    if (signbit(d)) {
+        *p++ = '-';
+        d = -d;
+    }
+
+    /* A float has at most 24 significant bits, so d * 1e6 is exact in
+     * a double below the limit and rounding matches printf            */
+    unsigned long long fixed = (unsigned long long)llrint(d * 1e6);
+    unsigned long long ipart = fixed / 1000000ull;
+    unsigned long long fpart = fixed % 1000000ull;
+
+    char tmp[24];
+    int n = 0;
+    do {
+        tmp[n++] = (char)('0' + ipart % 10);
+        ipart /= 10;
+    } while (ipart > 0);
+    while (n > 0) *p++ = tmp[--n];
+
+    *p++ = '.';
+    for (int i = 5; i >= 0; i--) {
+        p[i] = (char)('0' + fpart % 10);
+        fpart /= 10;
+    }
+    return (size_t)(p + 6 - buf);
+}
+
+typedef struct {
+    const float* X;
+    size_t cols, ld;
+    mmult_layout_t layout;
+    size_t r0, r1;     /* Rows of the current round */
+    char*  buf;
+    size_t len;
+} csv_task_t;
+
+static void* csv_format_rows(void* arg) {
+    csv_task_t* t = (csv_task_t*)arg;
+    char* p = t->buf;
+    for (size_t i = t->r0; i < t->r1; i++) {
+        for (size_t j = 0; j < t->cols; j++) {
+            p += csv_format_float(p, t->X[mmult_index(t->layout, i, j, t->ld)]);
+            *p++ = (j < t->cols - 1) ? ',' : '\n';
+        }
+    }
+    t->len = (size_t)(p - t->buf);
+    return NULL;
+}
+
+int csv_write_matrix(const char* path, const float* X, size_t rows, size_t cols,
+                     size_t ld, mmult_layout_t layout, int nthreads) {
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        fprintf(stderr, "Error opening file %s for writing.\n", path);
+        return -1;
+    }
+    if (rows == 0 || cols == 0) {
+        fclose(file);
+        return 0;
+    }
+
+    if (nthreads <= 0) nthreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (nthreads < 1) nthreads = 1;
+
+    /* Rows per block, at least one */
+    size_t row_bytes = cols * (CSV_MAX_FIELD + 1);
+    size_t block = CSV_BLOCK_BYTES / row_bytes;
+    if (block == 0) block = 1;
+
+    pthread_t tid[nthreads];
+    csv_task_t tasks[nthreads];
+    int ret = 0;
+
+    for (int t = 0; t < nthreads; t++) {
+        tasks[t] = (csv_task_t){ .X = X, .cols = cols, .ld = ld, .layout = layout };
+        tasks[t].buf = malloc(block * row_bytes);
+        if (tasks[t].buf == NULL) ret = -1;
+    }
+
+    for (size_t r = 0; ret == 0 && r < rows; r += block * nthreads) {
+        int active = 0;
+        for (int t = 0; t < nthreads; t++) {
+            size_t r0 = r + t * block;
+            if (r0 >= rows) break;
+            tasks[t].r0 = r0;
+            tasks[t].r1 = r0 + block < rows ? r0 + block : rows;
+            if (t > 0) pthread_create(&tid[t], NULL, csv_format_rows, &tasks[t]);
+            active++;
+        }
+
+        csv_format_rows(&tasks[0]);
+
+        for (int t = 1; t < active; t++) {
+            pthread_join(tid[t], NULL);
+        }
+        for (int t = 0; t < active; t++) {
+            if (fwrite(tasks[t].buf, 1, tasks[t].len, file) != tasks[t].len) ret = -1;
+        }
+    }
+
+    for (int t = 0; t < nthreads; t++) {
+        free(tasks[t].buf);
+    }
+    if (fclose(file) != 0) ret = -1;
+    if (ret != 0) {
+        fprintf(stderr, "Error writing file %s\n", path);
+    }
+    return ret;
+}
@@ -0,0 +1,19 @@
+#ifndef __IO_CSV_H_
+#define __IO_CSV_H_
+
+#include <stddef.h>
+
+#include "include/types.h"
+
+/* Format a float like "%.6f" into buf (at least CSV_MAX_FIELD bytes),
+ * returning the number of characters written (no terminator).        */
+#define CSV_MAX_FIELD 64
+size_t csv_format_float(char* buf, float v);
+
+/* Write a rows x cols matrix as CSV with "%.6f" fields. Rows are
+ * formatted by nthreads threads (<= 0: online CPUs) into large buffers
+ * that are written out in order. 0 on success.                       */
+int csv_write_matrix(const char* path, const float* X, size_t rows, size_t cols,
+                     size_t ld, mmult_layout_t layout, int nthreads);
+
+#endif //__IO_CSV_H_
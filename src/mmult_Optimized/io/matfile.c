@@ -0,0 +1,168 @@
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/* Include application-specific headers */
+#include "include/layout.h"
+#include "io/matfile.h"
+
+static void matfile_init_header(matfile_header_t* hdr, size_t rows, size_t cols,
+                                mmult_layout_t layout) {
+    memset(hdr, 0, sizeof(*hdr));
+    memcpy(hdr->magic, MATFILE_MAGIC, sizeof(MATFILE_MAGIC));
+    hdr->version     = MATFILE_VERSION;
+    hdr->layout      = (uint32_t)layout;
+    hdr->rows        = rows;
+    hdr->cols        = cols;
+    hdr->data_offset = MATFILE_DATA_OFFSET;
+}
+
+static size_t matfile_size(const matfile_header_t* hdr) {
+    return hdr->data_offset + hdr->rows * hdr->cols * sizeof(float);
+}
+
+/* Write all of buf, retrying short writes */
+static int write_all(int fd, const void* buf, size_t nbytes) {
+    const char* p = (const char*)buf;
+    while (nbytes > 0) {
+        ssize_t n = write(fd, p, nbytes);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        p += n;
+        nbytes -= (size_t)n;
+    }
+    return 0;
+}
+
+int matfile_write(const char* path, const float* X, size_t rows, size_t cols,
+                  size_t ld, mmult_layout_t layout) {
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "Error opening file %s for writing: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    char head[MATFILE_DATA_OFFSET] = {0};
+    matfile_init_header((matfile_header_t*)head, rows, cols, layout);
+    int ret = write_all(fd, head, sizeof(head));
+
+    /* One write when the matrix is already dense, else per row/column */
+    size_t outer = layout == MMULT_COL_MAJOR ? cols : rows;
+    size_t inner = layout == MMULT_COL_MAJOR ? rows : cols;
+    if (ret == 0 && ld == inner) {
+        ret = write_all(fd, X, outer * inner * sizeof(float));
+    } else {
+        for (size_t o = 0; ret == 0 && o < outer; o++) {
+            ret = write_all(fd, &X[o * ld], inner * sizeof(float));
+        }
+    }
+
+    if (close(fd) != 0) ret = -1;
+    if (ret != 0) {
+        fprintf(stderr, "Error writing file %s: %s\n", path, strerror(errno));
+    }
+    return ret;
+}
+
+int matfile_map(matfile_t* mf, const char* path, int writable) {
+    memset(mf, 0, sizeof(*mf));
+    mf->fd = open(path, writable ? O_RDWR : O_RDONLY);
+    if (mf->fd < 0) {
+        fprintf(stderr, "Error opening file %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(mf->fd, &st) != 0 || (size_t)st.st_size < sizeof(matfile_header_t) ||
+        pread(mf->fd, &mf->hdr, sizeof(mf->hdr), 0) != (ssize_t)sizeof(mf->hdr) ||
+        memcmp(mf->hdr.magic, MATFILE_MAGIC, sizeof(MATFILE_MAGIC)) != 0 ||
+        mf->hdr.version != MATFILE_VERSION ||
+        (size_t)st.st_size < matfile_size(&mf->hdr)) {
+        fprintf(stderr, "%s is not a valid matrix file\n", path);
+        close(mf->fd);
+        mf->fd = -1;
+        return -1;
+    }
+
+    mf->map_size = matfile_size(&mf->hdr);
+    mf->map = mmap(NULL, mf->map_size, writable ? PROT_READ | PROT_WRITE : PROT_READ,
+                   MAP_SHARED, mf->fd, 0);
+    if (mf->map == MAP_FAILED) {
+        fprintf(stderr, "Error mapping file %s: %s\n", path, strerror(errno));
+        close(mf->fd);
+        mf->fd = -1;
+        mf->map = NULL;
+        return -1;
+    }
+    mf->data = (float*)((char*)mf->map + mf->hdr.data_offset);
+    return 0;
+}
+
+int matfile_create(matfile_t* mf, const char* path, size_t rows, size_t cols,
+                   mmult_layout_t layout) {
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "Error opening file %s for writing: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    matfile_header_t hdr;
+    matfile_init_header(&hdr, rows, cols, layout);
+    int ret = (write_all(fd, &hdr, sizeof(hdr)) == 0 &&
+               ftruncate(fd, (off_t)matfile_size(&hdr)) == 0) ? 0 : -1;
+    close(fd);
+    if (ret != 0) {
+        fprintf(stderr, "Error creating file %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+    return matfile_map(mf, path, 1);
+}
+
+int matfile_read(const char* path, float* X, size_t rows, size_t cols,
+                 size_t ld, mmult_layout_t layout) {
+    matfile_t mf;
+    if (matfile_map(&mf, path, 0) != 0) return -1;
+
+    if (mf.hdr.rows != rows || mf.hdr.cols != cols) {
+        fprintf(stderr, "%s holds a %llu x %llu matrix, expected %zu x %zu\n", path,
+                (unsigned long long)mf.hdr.rows, (unsigned long long)mf.hdr.cols, rows, cols);
+        matfile_unmap(&mf);
+        return -1;
+    }
+
+    mmult_layout_t src = (mmult_layout_t)mf.hdr.layout;
+    size_t src_ld = matfile_ld(&mf.hdr);
+    madvise(mf.map, mf.map_size, MADV_SEQUENTIAL);
+    if (src == layout) {
+        size_t outer = layout == MMULT_COL_MAJOR ? cols : rows;
+        size_t inner = layout == MMULT_COL_MAJOR ? rows : cols;
+        for (size_t o = 0; o < outer; o++) {
+            memcpy(&X[o * ld], &mf.data[o * src_ld], inner * sizeof(float));
+        }
+    } else {
+        for (size_t i = 0; i < rows; i++) {
+            for (size_t j = 0; j < cols; j++) {
+                X[mmult_index(layout, i, j, ld)] = mf.data[mmult_index(src, i, j, src_ld)];
+            }
+        }
+    }
+
+    matfile_unmap(&mf);
+    return 0;
+}
+
+void matfile_unmap(matfile_t* mf) {
+    if (mf->map != NULL) munmap(mf->map, mf->map_size);
+    if (mf->fd >= 0) close(mf->fd);
+    mf->map = NULL;
+    mf->data = NULL;
+    mf->fd = -1;
+}
@@ -0,0 +1,58 @@
+#ifndef __IO_MATFILE_H_
+#define __IO_MATFILE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "include/types.h"
+
+/* Binary matrix file: a fixed header padded to MATFILE_DATA_OFFSET,
+ * then rows x cols floats stored densely in the recorded layout (the
+ * leading dimension is the minor extent). The data starts on a page
+ * boundary so a mapping of the file can be handed to the kernels
+ * without copying.                                                    */
+#define MATFILE_MAGIC       "MMATF32"
+#define MATFILE_VERSION     1
+#define MATFILE_DATA_OFFSET 4096
+
+typedef struct {
+    char     magic[8];
+    uint32_t version;
+    uint32_t layout;      /* mmult_layout_t */
+    uint64_t rows;
+    uint64_t cols;
+    uint64_t data_offset;
+} matfile_header_t;
+
+/* A memory-mapped matrix file */
+typedef struct {
+    matfile_header_t hdr;
+    float*  data;         /* First element, ld = matfile_ld(&hdr) */
+    void*   map;
+    size_t  map_size;
+    int     fd;
+} matfile_t;
+
+static inline size_t matfile_ld(const matfile_header_t* hdr) {
+    return hdr->layout == MMULT_COL_MAJOR ? hdr->rows : hdr->cols;
+}
+
+/* Write a rows x cols matrix with leading dimension ld. 0 on success. */
+int matfile_write(const char* path, const float* X, size_t rows, size_t cols,
+                  size_t ld, mmult_layout_t layout);
+
+/* Copy a file into X (rows x cols, leading dimension ld, any layout).
+ * Fails if the stored shape differs. 0 on success.                   */
+int matfile_read(const char* path, float* X, size_t rows, size_t cols,
+                 size_t ld, mmult_layout_t layout);
+
+/* Map an existing file, read-only or read-write. 0 on success. */
+int matfile_map(matfile_t* mf, const char* path, int writable);
+
+/* Create (or truncate) a file of the given shape and map it read-write */
+int matfile_create(matfile_t* mf, const char* path, size_t rows, size_t cols,
+                   mmult_layout_t layout);
+
+void matfile_unmap(matfile_t* mf);
+
+#endif //__IO_MATFILE_H_
@@ -25,6 +25,29 @@
 
 /* Include application-specific headers */
 #include "include/types.h"
+#include "include/layout.h"
+#include "bench/bench.h"
+#include "bench/shapes.h"
+#include "bench/scaling.h"
+#include "bench/strassen.h"
+#include "bench/batched.h"
+#include "bench/qgemm.h"
+#include "bench/sparse.h"
+#include "bench/ooc.h"
+#include "bench/semantics.h"
+#include "bench/epilogue.h"
+#include "bench/sweep.h"
+#include "bench/morton.h"
+#include "bench/summa.h"
+#include "bench/pipeline.h"
+#include "bench/igemm.h"
+#include "bench/lu.h"
+#include "bench/conv.h"
+#include "bench/gemv.h"
+#include "bench/transpose.h"
+#include "impl/freivalds.h"
+#include "io/matfile.h"
+#include "io/csv.h"
 
 /* Helper function to print a matrix */
 void print_matrix(const char* name, float* matrix, size_t rows, size_t cols) {
@@ -50,109 +73,579 @@ void create_result_directory() {
     }
 }
 
-/* Helper function to export a matrix to a CSV file in the Result directory */
-void export_matrix_to_csv(const char* filename, float* matrix, size_t rows, size_t cols) {
-    char filepath[256];
-    snprintf(filepath, sizeof(filepath), "Result/%s", filename);
+/* Format of the exported matrices */
+typedef enum {
+    EXPORT_NONE,
+    EXPORT_BIN,
+    EXPORT_CSV
+} export_format_t;
 
-    FILE* file = fopen(filepath, "w");
-    if (!file) {
-        fprintf(stderr, "Error opening file %s for writing.\n", filepath);
-        return;
-    }
+/* Helper function to export a matrix to Result/<name>.{bin|csv} */
+void export_matrix(const char* name, float* matrix, size_t rows, size_t cols,
+                   size_t ld, mmult_layout_t layout, export_format_t format, int nthreads) {
+    char filepath[256];
 
-    for (size_t i = 0; i < rows; i++) {
-        for (size_t j = 0; j < cols; j++) {
-            fprintf(file, "%.6f", matrix[i * cols + j]);
-            if (j < cols - 1) {
-                fprintf(file, ",");
-            }
-        }
-        fprintf(file, "\n");
+    switch (format) {
+        case EXPORT_BIN:
+            snprintf(filepath, sizeof(filepath), "Result/%s.bin", name);
+            matfile_write(filepath, matrix, rows, cols, ld, layout);
+            break;
+        case EXPORT_CSV:
+            snprintf(filepath, sizeof(filepath), "Result/%s.csv", name);
+            csv_write_matrix(filepath, matrix, rows, cols, ld, layout, nthreads);
+            break;
+        default:
+            break;
     }
-
-    fclose(file);
 }
 
 int main(int argc, char** argv) {
     /* Set the buffer for printf to NULL */
     setbuf(stdout, NULL);
     /* Default settings */
-    void* (*impl)(void* args) = NULL;
-    const char* impl_str = NULL;
+    const bench_impl_t* impl = NULL;
     bool run_both = false;
+    bool shape_sweep = false;
+    bool scaling = false;
+    bool strassen_sweep = false;
+    size_t cutoff = 0;
+    size_t batch = 0;
+    bool int8 = false;
+    bool igemm = false;
+    bool lu = false;
+    bool conv = false;
+    const char* conv_spec = NULL;
+    size_t conv_stride = 1, conv_pad = 0;
+    int conv_layout = -1;
+    double densities[16];
+    int ndensities = 0;
+    export_format_t export_format = EXPORT_BIN;
+    const char* load_A = NULL;
+    const char* load_B = NULL;
+    size_t ooc_cap_mb = 0;
+    mmult_trans_t transa = MMULT_NO_TRANS, transb = MMULT_NO_TRANS;
+    float alpha = 1.0f, beta = 0.0f;
+    bool gemm_check = false;
+    bool epilogue_bench = false;
+    bool morton_bench = false;
+    bool gemv_bench = false;
+    bool transpose_bench = false;
+    bool pipeline_bench = false;
+    const char* summa_spec = NULL;
+    dist_transport_kind_t transport = DIST_TRANSPORT_SHM;
+    const char* sizes_spec = NULL;
+    const char* impls_list = NULL;
+    bool verify = false;
+    double fp_prob = 1e-6;
+    float verify_tol = 0.0f;
+    sweep_config_t sweep = { .nruns = 5, .nwarmup = 1, .nstdevs = 3, .csv = "mmult_sweep.csv" };
+    int nthreads = 0;
+    int cpu = 0;
+    size_t rows_A = 0, cols_A = 0, cols_B = 0;
+    mmult_layout_t layout = MMULT_ROW_MAJOR;
+    size_t ld_pad = 0;
     /* Parse command-line arguments */
     for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "-i") == 0 || strcmp(argv[i], "--impl") == 0) {
             assert(++i < argc);
-            if (strcmp(argv[i], "naive") == 0) {
-                impl = impl_scalar_naive;
-                impl_str = "naive";
-            } else if (strcmp(argv[i], "opt") == 0) {
-                impl = impl_scalar_opt;
-                impl_str = "opt";
-            }else if (strcmp(argv[i], "simd") == 0) {
-                impl = impl_simd;
-                impl_str = "simd";
-            }else if (strcmp(argv[i], "mimd") == 0) {
-                impl = impl_mimd;
-                impl_str = "mimd";
-            }  else if (strcmp(argv[i], "all") == 0) {
+            if (strcmp(argv[i], "all") == 0) {
                 run_both = true;
-            } else {
+            } else if ((impl = bench_find_impl(argv[i])) == NULL) {
                 fprintf(stderr, "Unknown implementation: %s\n", argv[i]);
                 exit(1);
             }
             continue;
         }
+        /* Problem shape: R (M x N) = A (M x K) * B (K x N) */
+        if (strcmp(argv[i], "-M") == 0) {
+            assert(++i < argc);
+            rows_A = strtoull(argv[i], NULL, 10);
+            continue;
+        }
+        if (strcmp(argv[i], "-K") == 0) {
+            assert(++i < argc);
+            cols_A = strtoull(argv[i], NULL, 10);
+            continue;
+        }
+        if (strcmp(argv[i], "-N") == 0) {
+            assert(++i < argc);
+            cols_B = strtoull(argv[i], NULL, 10);
+            continue;
+        }
+        if (strcmp(argv[i], "--layout") == 0) {
+            assert(++i < argc);
+            if (strcmp(argv[i], "row") == 0) {
+                layout = MMULT_ROW_MAJOR;
+            } else if (strcmp(argv[i], "col") == 0) {
+                layout = MMULT_COL_MAJOR;
+            } else {
+                fprintf(stderr, "Unknown layout: %s\n", argv[i]);
+                exit(1);
+            }
+            continue;
+        }
+        if (strcmp(argv[i], "--ld-pad") == 0) {
+            assert(++i < argc);
+            ld_pad = strtoull(argv[i], NULL, 10);
+            continue;
+        }
+        /* R = alpha * op(A) * op(B) + beta * R */
+        if (strcmp(argv[i], "--transa") == 0) {
+            transa = MMULT_TRANS;
+            continue;
+        }
+        if (strcmp(argv[i], "--transb") == 0) {
+            transb = MMULT_TRANS;
+            continue;
+        }
+        if (strcmp(argv[i], "--alpha") == 0) {
+            assert(++i < argc);
+            alpha = strtof(argv[i], NULL);
+            continue;
+        }
+        if (strcmp(argv[i], "--beta") == 0) {
+            assert(++i < argc);
+            beta = strtof(argv[i], NULL);
+            continue;
+        }
+        if (strcmp(argv[i], "--gemm-check") == 0) {
+            gemm_check = true;
+            continue;
+        }
+        /* Freivalds verification of every result */
+        if (strcmp(argv[i], "--verify") == 0) {
+            verify = true;
+            continue;
+        }
+        if (strcmp(argv[i], "--fp-prob") == 0) {
+            assert(++i < argc);
+            fp_prob = atof(argv[i]);
+            continue;
+        }
+        if (strcmp(argv[i], "--tol") == 0) {
+            assert(++i < argc);
+            verify_tol = strtof(argv[i], NULL);
+            continue;
+        }
+        /* Non-interactive sweep */
+        if (strcmp(argv[i], "--sizes") == 0) {
+            assert(++i < argc);
+            sizes_spec = argv[i];
+            continue;
+        }
+        if (strcmp(argv[i], "--impls") == 0) {
+            assert(++i < argc);
+            impls_list = argv[i];
+            continue;
+        }
+        if (strcmp(argv[i], "--nruns") == 0) {
+            assert(++i < argc);
+            sweep.nruns = atoi(argv[i]);
+            continue;
+        }
+        if (strcmp(argv[i], "--warmup") == 0) {
+            assert(++i < argc);
+            sweep.nwarmup = atoi(argv[i]);
+            continue;
+        }
+        if (strcmp(argv[i], "--nstdevs") == 0) {
+            assert(++i < argc);
+            sweep.nstdevs = atoi(argv[i]);
+            continue;
+        }
+        if (strcmp(argv[i], "--csv") == 0) {
+            assert(++i < argc);
+            sweep.csv = strcmp(argv[i], "none") == 0 ? NULL : argv[i];
+            continue;
+        }
+        if (strcmp(argv[i], "--epilogue-bench") == 0) {
+            epilogue_bench = true;
+            continue;
+        }
+        if (strcmp(argv[i], "--morton-bench") == 0) {
+            morton_bench = true;
+            continue;
+        }
+        if (strcmp(argv[i], "--gemv-bench") == 0) {
+            gemv_bench = true;
+            continue;
+        }
+        if (strcmp(argv[i], "--transpose-bench") == 0) {
+            transpose_bench = true;
+            continue;
+        }
+        if (strcmp(argv[i], "--pipeline-bench") == 0) {
+            pipeline_bench = true;
+            continue;
+        }
+        /* Distributed SUMMA: comma-separated process counts */
+        if (strcmp(argv[i], "--summa") == 0) {
+            assert(++i < argc);
+            summa_spec = argv[i];
+            continue;
+        }
+        if (strcmp(argv[i], "--transport") == 0) {
+            assert(++i < argc);
+            if (dist_transport_parse(argv[i], &transport) != 0) {
+                fprintf(stderr, "Unknown transport: %s\n", argv[i]);
+                exit(1);
+            }
+            continue;
+        }
+        if (strcmp(argv[i], "--shape-sweep") == 0) {
+            shape_sweep = true;
+            continue;
+        }
+        /* Parallelization */
+        if (strcmp(argv[i], "-n") == 0 || strcmp(argv[i], "--nthreads") == 0) {
+            assert(++i < argc);
+            nthreads = atoi(argv[i]);
+            continue;
+        }
+        if (strcmp(argv[i], "-c") == 0 || strcmp(argv[i], "--cpu") == 0) {
+            assert(++i < argc);
+            cpu = atoi(argv[i]);
+            continue;
+        }
+        if (strcmp(argv[i], "--scaling") == 0) {
+            scaling = true;
+            continue;
+        }
+        /* Strassen */
+        if (strcmp(argv[i], "--cutoff") == 0) {
+            assert(++i < argc);
+            cutoff = strtoull(argv[i], NULL, 10);
+            continue;
+        }
+        if (strcmp(argv[i], "--strassen-sweep") == 0) {
+            strassen_sweep = true;
+            continue;
+        }
+        /* Quantized int8 */
+        if (strcmp(argv[i], "--int8") == 0) {
+            int8 = true;
+            continue;
+        }
+        /* Exact int32 / int16 */
+        if (strcmp(argv[i], "--igemm") == 0) {
+            igemm = true;
+            continue;
+        }
+        /* LU factorization and solve */
+        if (strcmp(argv[i], "--lu") == 0) {
+            lu = true;
+            continue;
+        }
+        /* Convolution lowered to GEMM */
+        if (strcmp(argv[i], "--conv") == 0) {
+            conv = true;
+            continue;
+        }
+        if (strcmp(argv[i], "--conv-shape") == 0) {
+            assert(++i < argc);
+            conv_spec = argv[i];
+            continue;
+        }
+        if (strcmp(argv[i], "--stride") == 0) {
+            assert(++i < argc);
+            conv_stride = strtoull(argv[i], NULL, 10);
+            continue;
+        }
+        if (strcmp(argv[i], "--pad") == 0) {
+            assert(++i < argc);
+            conv_pad = strtoull(argv[i], NULL, 10);
+            continue;
+        }
+        if (strcmp(argv[i], "--conv-layout") == 0) {
+            assert(++i < argc);
+            if (strcmp(argv[i], "nchw") == 0) {
+                conv_layout = CONV_NCHW;
+            } else if (strcmp(argv[i], "nhwc") == 0) {
+                conv_layout = CONV_NHWC;
+            } else {
+                fprintf(stderr, "Unknown convolution layout: %s\n", argv[i]);
+                exit(1);
+            }
+            continue;
+        }
+        /* Batched small matrices */
+        if (strcmp(argv[i], "--batch") == 0) {
+            assert(++i < argc);
+            batch = strtoull(argv[i], NULL, 10);
+            continue;
+        }
+        /* Matrix files */
+        if (strcmp(argv[i], "--export") == 0) {
+            assert(++i < argc);
+            if (strcmp(argv[i], "bin") == 0) {
+                export_format = EXPORT_BIN;
+            } else if (strcmp(argv[i], "csv") == 0) {
+                export_format = EXPORT_CSV;
+            } else if (strcmp(argv[i], "none") == 0) {
+                export_format = EXPORT_NONE;
+            } else {
+                fprintf(stderr, "Unknown export format: %s\n", argv[i]);
+                exit(1);
+            }
+            continue;
+        }
+        if (strcmp(argv[i], "--no-export") == 0) {
+            export_format = EXPORT_NONE;
+            continue;
+        }
+        if (strcmp(argv[i], "--load-a") == 0) {
+            assert(++i < argc);
+            load_A = argv[i];
+            continue;
+        }
+        if (strcmp(argv[i], "--load-b") == 0) {
+            assert(++i < argc);
+            load_B = argv[i];
+            continue;
+        }
+        /* Out-of-core product under a memory cap in MB */
+        if (strcmp(argv[i], "--ooc") == 0) {
+            assert(++i < argc);
+            ooc_cap_mb = strtoull(argv[i], NULL, 10);
+            continue;
+        }
+        /* Sparse A: comma-separated fractions of non-zeros */
+        if (strcmp(argv[i], "--density") == 0) {
+            assert(++i < argc);
+            for (char* tok = strtok(argv[i], ","); tok != NULL && ndensities < 16; tok = strtok(NULL, ",")) {
+                densities[ndensities++] = atof(tok);
+            }
+            continue;
+        }
+    }
+    if (gemm_check) {
+        /* Small ragged shape by default, every edge path is exercised */
+        srand((unsigned int)time(NULL));
+        return bench_gemm_semantics(rows_A ? rows_A : 37, cols_A ? cols_A : 301,
+                                    cols_B ? cols_B : 45, nthreads);
+    }
+    if (transpose_bench) {
+        /* -M picks a single size */
+        srand((unsigned int)time(NULL));
+        return bench_transpose(rows_A, nthreads);
+    }
+    if (pipeline_bench) {
+        /* -M picks a single size */
+        srand((unsigned int)time(NULL));
+        return bench_pipeline(rows_A);
+    }
+    if (gemv_bench) {
+        srand((unsigned int)time(NULL));
+        return bench_gemv(nthreads);
+    }
+    if (morton_bench) {
+        /* --sizes replaces the default sizes */
+        size_t sizes[SWEEP_MAX_SIZES];
+        int nsizes = 0;
+        if (sizes_spec != NULL && (nsizes = bench_parse_sizes(sizes_spec, sizes, SWEEP_MAX_SIZES)) < 0) {
+            fprintf(stderr, "Invalid size list: %s (expected lo:hi:xF, lo:hi:+S or a,b,c)\n", sizes_spec);
+            exit(1);
+        }
+        srand((unsigned int)time(NULL));
+        return bench_morton(nsizes > 0 ? sizes : NULL, nsizes);
+    }
+    if (summa_spec != NULL) {
+        /* Defaults to a 2048^3 product */
+        size_t counts[SWEEP_MAX_SIZES];
+        int procs[SWEEP_MAX_SIZES];
+        int nprocs = bench_parse_sizes(summa_spec, counts, SWEEP_MAX_SIZES);
+        if (nprocs < 0) {
+            fprintf(stderr, "Invalid process counts: %s (expected a,b,c or lo:hi:xF)\n", summa_spec);
+            exit(1);
+        }
+        for (int p = 0; p < nprocs; p++) procs[p] = (int)counts[p];
+        return bench_summa(procs, nprocs, rows_A ? rows_A : 2048, cols_A ? cols_A : 2048,
+                           cols_B ? cols_B : 2048, transport, cpu);
+    }
+    if (lu) {
+        /* --sizes replaces the default sizes */
+        size_t sizes[SWEEP_MAX_SIZES];
+        int nsizes = 0;
+        if (sizes_spec != NULL && (nsizes = bench_parse_sizes(sizes_spec, sizes, SWEEP_MAX_SIZES)) < 0) {
+            fprintf(stderr, "Invalid size list: %s (expected lo:hi:xF, lo:hi:+S or a,b,c)\n", sizes_spec);
+            exit(1);
+        }
+        srand((unsigned int)time(NULL));
+        return bench_lu(nsizes > 0 ? sizes : NULL, nsizes, nthreads);
+    }
+    if (conv) {
+        /* --conv-shape replaces the default layers */
+        conv_shape_t shape = { .stride_h = conv_stride, .stride_w = conv_stride,
+                               .pad_h = conv_pad, .pad_w = conv_pad };
+        if (conv_spec != NULL) {
+            if (sscanf(conv_spec, "%zu,%zu,%zu,%zu,%zu,%zu,%zu", &shape.N, &shape.C, &shape.H, &shape.W,
+                       &shape.K, &shape.R, &shape.S) != 7 || shape.N * shape.C * shape.K == 0 ||
+                shape.R == 0 || shape.S == 0 || conv_stride == 0 ||
+                shape.H + 2 * conv_pad < shape.R || shape.W + 2 * conv_pad < shape.S) {
+                fprintf(stderr, "Invalid convolution shape: %s (expected N,C,H,W,K,R,S)\n", conv_spec);
+                exit(1);
+            }
+        }
+        srand((unsigned int)time(NULL));
+        return bench_conv(conv_spec != NULL ? &shape : NULL, conv_layout, nthreads);
+    }
+    if (sizes_spec != NULL) {
+        /* The naive kernel is opt-in, it takes hours at the large sizes */
+        sweep.nsizes = bench_parse_sizes(sizes_spec, sweep.sizes, SWEEP_MAX_SIZES);
+        if (sweep.nsizes < 0) {
+            fprintf(stderr, "Invalid size list: %s (expected lo:hi:xF, lo:hi:+S or a,b,c)\n", sizes_spec);
+            exit(1);
+        }
+        if (bench_parse_impls(impls_list ? impls_list : "opt,simd,mimd,strassen", sweep.impls) != 0) {
+            exit(1);
+        }
+        sweep.layout = layout;
+        sweep.pad = ld_pad;
+        sweep.nthreads = nthreads;
+        sweep.cpu = cpu;
+        srand((unsigned int)time(NULL));
+        return bench_sweep(&sweep);
+    }
+    if (epilogue_bench) {
+        srand((unsigned int)time(NULL));
+        return bench_epilogue();
+    }
+    if (shape_sweep) {
+        srand((unsigned int)time(NULL));
+        return bench_shape_sweep(layout, ld_pad, nthreads);
+    }
+    if (scaling) {
+        /* Defaults to a 2048^3 product, -n caps the thread count */
+        srand((unsigned int)time(NULL));
+        return bench_strong_scaling(rows_A ? rows_A : 2048, cols_A ? cols_A : 2048,
+                                    cols_B ? cols_B : 2048, nthreads, cpu);
+    }
+    if (strassen_sweep) {
+        /* -M caps the largest size, 2048 by default */
+        srand((unsigned int)time(NULL));
+        return bench_strassen(rows_A ? rows_A : 2048, cutoff);
+    }
+    if (int8) {
+        srand((unsigned int)time(NULL));
+        return bench_qgemm(rows_A, cols_A, cols_B);
+    }
+    if (igemm) {
+        srand((unsigned int)time(NULL));
+        return bench_igemm(rows_A, cols_A, cols_B, nthreads);
+    }
+    if (ooc_cap_mb > 0) {
+        /* Generated inputs default to a 4096^3 product */
+        srand((unsigned int)time(NULL));
+        create_result_directory();
+        return bench_ooc(rows_A ? rows_A : 4096, cols_A ? cols_A : 4096, cols_B ? cols_B : 4096,
+                         ooc_cap_mb << 20, load_A, load_B);
+    }
+    if (ndensities > 0) {
+        /* Defaults to a 2048^3 product */
+        srand((unsigned int)time(NULL));
+        return bench_sparse(rows_A ? rows_A : 2048, cols_A ? cols_A : 2048,
+                            cols_B ? cols_B : 2048, densities, ndensities, nthreads);
+    }
+    if (batch > 0) {
+        srand((unsigned int)time(NULL));
+        return bench_batched(batch, nthreads);
     }
     if (impl == NULL && !run_both) {
-        fprintf(stderr, "Usage: %s -i {naive|opt|simd|mimd|all}\n", argv[0]);
+        fprintf(stderr, "Usage: %s -i {naive|opt|simd|mimd|strassen|morton|transposed|pipelined|all} [-M rows_A -K cols_A -N cols_B]\n"
+                        "          [--layout {row|col}] [--ld-pad elems] [-n nthreads] [-c cpu]\n"
+                        "          [--cutoff strassen_cutoff] [--export {bin|csv|none}] [--no-export]\n"
+                        "          [--load-a file.bin] [--load-b file.bin]\n"
+                        "          [--transa] [--transb] [--alpha a] [--beta b]\n"
+                        "          [--verify] [--fp-prob p] [--tol relative_tolerance]\n"
+                        "       %s --gemm-check [-M rows_A -K cols_A -N cols_B] [-n nthreads]\n"
+                        "       %s --epilogue-bench\n"
+                        "       %s --transpose-bench [-M size] [-n nthreads]\n"
+                        "       %s --pipeline-bench [-M size]\n"
+                        "       %s --gemv-bench [-n nthreads]\n"
+                        "       %s --morton-bench [--sizes {lo:hi:xF|lo:hi:+S|a,b,c}]\n"
+                        "       %s --summa P[,P...] [--transport {shm|unix|tcp}] [-M rows_A -K cols_A -N cols_B] [-c cpu]\n"
+                        "       %s --lu [--sizes {lo:hi:xF|lo:hi:+S|a,b,c}] [-n nthreads]\n"
+                        "       %s --conv [--conv-shape N,C,H,W,K,R,S [--stride s] [--pad p]]\n"
+                        "          [--conv-layout {nchw|nhwc}] [-n nthreads]\n"
+                        "       %s --sizes {lo:hi:xF|lo:hi:+S|a,b,c} [--impls name,...] [--nruns n]\n"
+                        "          [--warmup n] [--nstdevs n] [--csv file|none] [--layout {row|col}]\n"
+                        "          [--ld-pad elems] [-n nthreads] [-c cpu]\n"
+                        "       %s --shape-sweep [--layout {row|col}] [--ld-pad elems] [-n nthreads]\n"
+                        "       %s --scaling [-M rows_A -K cols_A -N cols_B] [-n max_threads] [-c cpu]\n"
+                        "       %s --strassen-sweep [-M max_size] [--cutoff strassen_cutoff]\n"
+                        "       %s --batch count [-n nthreads]\n"
+                        "       %s --int8 [-M rows_A -K cols_A -N cols_B]\n"
+                        "       %s --igemm [-M rows_A -K cols_A -N cols_B] [-n nthreads]\n"
+                        "       %s --density d[,d...] [-M rows_A -K cols_A -N cols_B] [-n nthreads]\n"
+                        "       %s --ooc cap_MB [-M rows_A -K cols_A -N cols_B | --load-a A.bin --load-b B.bin]\n",
+                argv[0], argv[0], argv[0], argv[0], argv[0], argv[0], argv[0], argv[0], argv[0], argv[0],
+                argv[0], argv[0], argv[0], argv[0], argv[0], argv[0], argv[0], argv[0], argv[0]);
         exit(1);
     }
     /* Create the Result directory */
-    create_result_directory();
-    /* Prompt the user for matrix dimensions */
-    size_t rows_A, cols_A, rows_B, cols_B;
-    printf("Enter the number of rows for Matrix A: ");
-    scanf("%zu", &rows_A);
-    printf("Enter the number of columns for Matrix A: ");
-    scanf("%zu", &cols_A);
-    printf("Enter the number of rows for Matrix B: ");
-    scanf("%zu", &rows_B);
-    /* Ensure cols_A == rows_B */
-    while (cols_A != rows_B) {
-        printf("Number of columns for Matrix A must equal the number of rows for Matrix B.\n");
+    if (export_format != EXPORT_NONE) {
+        create_result_directory();
+    }
+    /* Prompt the user for matrix dimensions not given on the command line */
+    size_t rows_B;
+    if (rows_A == 0 || cols_A == 0 || cols_B == 0) {
+        printf("Enter the number of rows for Matrix A: ");
+        scanf("%zu", &rows_A);
+        printf("Enter the number of columns for Matrix A: ");
+        scanf("%zu", &cols_A);
         printf("Enter the number of rows for Matrix B: ");
         scanf("%zu", &rows_B);
+        /* Ensure cols_A == rows_B */
+        while (cols_A != rows_B) {
+            printf("Number of columns for Matrix A must equal the number of rows for Matrix B.\n");
+            printf("Enter the number of rows for Matrix B: ");
+            scanf("%zu", &rows_B);
+        }
+        printf("Enter the number of columns for Matrix B: ");
+        scanf("%zu", &cols_B);
     }
-    printf("Enter the number of columns for Matrix B: ");
-    scanf("%zu", &cols_B);
+    rows_B = cols_A;
 
     /* Allocate matrices */
     srand((unsigned int)time(NULL)); 
 
-    float* A = malloc(rows_A * cols_A * sizeof(float));
-    float* B = malloc(rows_B * cols_B * sizeof(float));
-    float* R_naive = malloc(rows_A * cols_B * sizeof(float));
-    float* R_opt = malloc(rows_A * cols_B * sizeof(float));
-
-    float* R_vec = malloc(rows_A * cols_B * sizeof(float));
-    float* R_para = malloc(rows_A * cols_B * sizeof(float));
-    float* R_simd = malloc(rows_A * cols_B * sizeof(float));
-    float* R_mimd = malloc(rows_A * cols_B * sizeof(float));
-    if (!A || !B || !R_naive || !R_opt|| !R_mimd|| !R_simd) {
-        fprintf(stderr, "Memory allocation failed.\n");
+    args_t args;
+    bench_setup_args(&args, rows_A, cols_A, cols_B, layout, ld_pad, NULL, NULL, NULL);
+    args.nthreads = nthreads;
+    args.cpu = cpu;
+    args.cutoff = cutoff;
+    args.alpha = alpha;
+    args.beta = beta;
+    bench_set_transpose(&args, transa, transb, ld_pad);
+
+    /* Stored shapes: a transposed operand is kept as its transpose */
+    size_t a_rows = transa ? cols_A : rows_A, a_cols = transa ? rows_A : cols_A;
+    size_t b_rows = transb ? cols_B : rows_B, b_cols = transb ? rows_B : cols_B;
+
+    float* A = bench_alloc_matrix(a_rows, a_cols, args.lda, layout);
+    float* B = bench_alloc_matrix(b_rows, b_cols, args.ldb, layout);
+    float* R = bench_alloc_matrix(rows_A, cols_B, args.ldr, layout);
+    args.input0 = A;
+    args.input1 = B;
+    args.output = R;
+
+    /* Replace the random inputs with matrix files */
+    if ((load_A && matfile_read(load_A, A, a_rows, a_cols, args.lda, layout) != 0) ||
+        (load_B && matfile_read(load_B, B, b_rows, b_cols, args.ldb, layout) != 0)) {
         exit(1);
     }
 
-    /* Initialize input matrices */
-    for (size_t i = 0; i < rows_A * cols_A; i++) {
-        A[i] = (float)(rand() % 10);
-    }
-
-    for (size_t i = 0; i < rows_B * cols_B; i++) {
-        B[i] = (float)(rand() % 10);
+    /* With beta != 0 every implementation starts from the same R */
+    size_t r_bytes = bench_matrix_elems(rows_A, cols_B, args.ldr, layout) * sizeof(float);
+    float* R0 = NULL;
+    if (beta != 0.0f) {
+        R0 = malloc(r_bytes ? r_bytes : 1);
+        if (R0 == NULL) {
+            fprintf(stderr, "Memory allocation failed.\n");
+            exit(1);
+        }
+        memcpy(R0, R, r_bytes);
+        export_matrix("matrix_R0", R0, rows_A, cols_B, args.ldr, layout, export_format, nthreads);
     }
 
     /* Print input matrices */
@@ -160,93 +653,49 @@ int main(int argc, char** argv) {
    /* print_matrix("Matrix B", B, rows_B, cols_B);*/
 
     /* Export input matrices */
-    export_matrix_to_csv("matrix_A.csv", A, rows_A, cols_A);
-    export_matrix_to_csv("matrix_B.csv", B, rows_B, cols_B);
-
-    double naive_time = 0.0, opt_time = 0.0, vec_time = 0.0, para_time = 0.0, simd_time = 0.0, mimd_time = 0.0;// Declare timing variables
-    /* Run naive implementation */
-    if (run_both || impl == impl_scalar_naive) {
-        args_t args_naive = { .input = malloc((rows_A * cols_A + rows_B * cols_B) * sizeof(float)), .output = R_naive, .size = rows_A };
-        memcpy(args_naive.input, A, rows_A * cols_A * sizeof(float));
-        memcpy((float*)args_naive.input + rows_A * cols_A, B, rows_B * cols_B * sizeof(float));
-
-        clock_t start_naive = clock();
-        impl_scalar_naive(&args_naive);
-        clock_t end_naive = clock();
-
-        naive_time = (double)(end_naive - start_naive) / CLOCKS_PER_SEC;
-        printf("Naive Implementation Runtime: %.6f seconds\n", naive_time);
-        /* print_matrix("Result Matrix R (Naive)", R_naive, rows_A, cols_B);*/
-        export_matrix_to_csv("result_naive.csv", R_naive, rows_A, cols_B);
-
-        free(args_naive.input);
-    }
-
-    /* Run optimized implementation */
-    if (run_both || impl == impl_scalar_opt) {
-        args_t args_opt = { .input = malloc((rows_A * cols_A + rows_B * cols_B) * sizeof(float)), .output = R_opt, .size = rows_A };
-        memcpy(args_opt.input, A, rows_A * cols_A * sizeof(float));
-        memcpy((float*)args_opt.input + rows_A * cols_A, B, rows_B * cols_B * sizeof(float));
-
-        clock_t start_opt = clock();
-        impl_scalar_opt(&args_opt);
-        clock_t end_opt = clock();
-
-        opt_time = (double)(end_opt - start_opt) / CLOCKS_PER_SEC;
-        printf("Optimized Implementation Runtime: %.6f seconds\n", opt_time);
-       /* print_matrix("Result Matrix R (Optimized)", R_opt, rows_A, cols_B); */
-        export_matrix_to_csv("result_opt.csv", R_opt, rows_A, cols_B);
-
-        free(args_opt.input);
-    }
-        /* Run simd implementation */
-    if (run_both || impl == impl_simd) {
-        args_t args_simd = { .input = malloc((rows_A * cols_A + rows_B * cols_B) * sizeof(float)), .output = R_simd, .size = rows_A };
-        memcpy(args_simd.input, A, rows_A * cols_A * sizeof(float));
-        memcpy((float*)args_simd.input + rows_A * cols_A, B, rows_B * cols_B * sizeof(float));
-
-        clock_t start_simd = clock();
-        impl_simd(&args_simd);
-        clock_t end_simd = clock();
-
-        simd_time = (double)(end_simd - start_simd) / CLOCKS_PER_SEC;
-        printf("SIMD Implementation Runtime: %.6f seconds\n", simd_time);
-        /* print_matrix("Result Matrix R (SIMD)", R_simd, rows_A, cols_B);*/
-        export_matrix_to_csv("result_simd.csv", R_simd, rows_A, cols_B);
-
-        free(args_simd.input);
-    }
-
-        /* Run mimd implementation */
-    if (run_both || impl == impl_mimd) {
-        args_t args_mimd = { .input = malloc((rows_A * cols_A + rows_B * cols_B) * sizeof(float)), .output = R_mimd, .size = rows_A };
-        memcpy(args_mimd.input, A, rows_A * cols_A * sizeof(float));
-        memcpy((float*)args_mimd.input + rows_A * cols_A, B, rows_B * cols_B * sizeof(float));
-
-        clock_t start_mimd = clock();
-        impl_mimd(&args_mimd);
-        clock_t end_mimd = clock();
-
-        mimd_time = (double)(end_mimd - start_mimd) / CLOCKS_PER_SEC;
-        printf("MIMD Implementation Runtime: %.6f seconds\n", mimd_time);
-        /* print_matrix("Result Matrix R (MIMD)", R_mimd, rows_A, cols_B);*/
-        export_matrix_to_csv("result_mimd.csv", R_mimd, rows_A, cols_B);
+    export_matrix("matrix_A", A, a_rows, a_cols, args.lda, layout, export_format, nthreads);
+    export_matrix("matrix_B", B, b_rows, b_cols, args.ldb, layout, export_format, nthreads);
+
+    double runtimes[bench_num_impls];
+    for (int i = 0; i < bench_num_impls; i++) {
+        const bench_impl_t* entry = &bench_impls[i];
+        runtimes[i] = 0.0;
+        if (!run_both && impl != entry) continue;
+        if (R0 != NULL) memcpy(R, R0, r_bytes);
+
+        /* Wall-clock time: clock() would add up the CPU time of every thread */
+        double start = bench_now();
+        entry->fn(&args);
+        runtimes[i] = bench_now() - start;
+        printf("%s Implementation Runtime: %.6f seconds\n", entry->label, runtimes[i]);
+        printf("%s Implementation Throughput: %.2f GFLOP/s\n", entry->label,
+               bench_gflops(rows_A, cols_B, cols_A, runtimes[i]));
+
+        if (verify) {
+            freivalds_result_t fv;
+            int res = freivalds_verify(&args, R0, freivalds_rounds(fp_prob), verify_tol,
+                                       nthreads, (unsigned int)rand(), &fv);
+            if (res < 0) {
+                printf("%s Implementation Verification: skipped\n", entry->label);
+            } else {
+                printf("%s Implementation Verification: %s (%d vectors, tol %.1e, error %.2f of tol, "
+                       "%.6f seconds = %.1f%% of the multiply)\n",
+                       entry->label, res == 0 ? "passed" : "FAILED", fv.rounds, fv.tol, fv.max_error,
+                       fv.seconds, runtimes[i] > 0 ? 100.0 * fv.seconds / runtimes[i] : 0.0);
+            }
+        }
 
-        free(args_mimd.input);
+        char name[64];
+        snprintf(name, sizeof(name), "result_%s", entry->name);
+        export_matrix(name, R, rows_A, cols_B, args.ldr, layout, export_format, nthreads);
     }
 
-  
-
-      /* Calculate and print speedup */
-    if (naive_time > 0) {
-        if (opt_time > 0) {
-            printf("Speedup (Optimized vs Naive): %.2fx\n", naive_time / opt_time);
-        }
-        if (simd_time > 0) {
-            printf("Speedup (SIMD vs Naive): %.2fx\n", naive_time / simd_time);
-        }
-        if (mimd_time > 0) {
-            printf("Speedup (MIMD vs Naive): %.2fx\n", naive_time / mimd_time);
+    /* Calculate and print speedup against the naive kernel (first entry) */
+    if (runtimes[0] > 0) {
+        for (int i = 1; i < bench_num_impls; i++) {
+            if (runtimes[i] > 0) {
+                printf("Speedup (%s vs Naive): %.2fx\n", bench_impls[i].label, runtimes[0] / runtimes[i]);
+            }
         }
     }
 
@@ -254,8 +703,8 @@ int main(int argc, char** argv) {
     /* Free memory */
     free(A);
     free(B);
-    free(R_naive);
-    free(R_opt);
+    free(R);
+    free(R0);
 
     return 0;
 }
@@ -15,52 +15,84 @@
 
 /* Include application-specific headers */
 #include "include/types.h"
+#include "include/ops.h"
 
 /* Alternative Implementation */
 #pragma GCC push_options
 #pragma GCC optimize ("O1")
-__attribute__ ((optimize(1)))
-void* impl_scalar_opt(void* args)
-{
-  /* Get the argument struct */
-  args_t* parsed_args = (args_t*)args;
 
-  /* Get all the arguments */
-  register       int*   dest = (      int*)(parsed_args->output);
-  register const int*   src0 = (const int*)(parsed_args->input0);
-  register const int*   src1 = (const int*)(parsed_args->input1);
-  register       size_t size =              parsed_args->size / 4;
+/* Element j of the current position */
+#define OPT_ELEM(op, T, U, MAD, j)                                       \
+  dest[j] = VV_SCALAR(op, T, U, MAD, src0[j], src1[j], src2[j], k)
 
-  register       size_t sz_8 = size / 8;
+/* Loop unrolled by 8, the remainder peeled first (Duff's device) */
+#define OPT_KERNEL(op, OP, name, NAME, T, U, MAD)                        \
+__attribute__ ((optimize(1)))                                            \
+static void opt_##op##_##name(const args_t* args, size_t begin, size_t end) \
+{                                                                        \
+  register       T*     dest = (      T*)(args->output) + begin;         \
+  register const T*     src0 = (const T*)(args->input0) + begin;         \
+  register const T*     src1 = (const T*)(args->input1) + begin;         \
+  register const T*     src2 = (const T*)(args->input2);                 \
+  register const T      k    = (T)(args->alpha);                         \
+  register       size_t size = end - begin;                              \
+                                                                         \
+  register       size_t sz_8 = size / 8;                                 \
+                                                                         \
+  if (src2 != NULL) src2 += begin;                                       \
+                                                                         \
+  switch (size % 8) {                                                    \
+    case 7:  OPT_ELEM(op, T, U, MAD, 6);                                 \
+    case 6:  OPT_ELEM(op, T, U, MAD, 5);                                 \
+    case 5:  OPT_ELEM(op, T, U, MAD, 4);                                 \
+    case 4:  OPT_ELEM(op, T, U, MAD, 3);                                 \
+    case 3:  OPT_ELEM(op, T, U, MAD, 2);                                 \
+    case 2:  OPT_ELEM(op, T, U, MAD, 1);                                 \
+    case 1:  OPT_ELEM(op, T, U, MAD, 0);                                 \
+    case 0:  break;                                                      \
+  }                                                                      \
+                                                                         \
+  dest += size % 8;                                                      \
+  src0 += size % 8;                                                      \
+  src1 += size % 8;                                                      \
+  if (src2 != NULL) src2 += size % 8;                                    \
+                                                                         \
+  while (sz_8 > 0) {                                                     \
+    OPT_ELEM(op, T, U, MAD, 0);                                          \
+    OPT_ELEM(op, T, U, MAD, 1);                                          \
+    OPT_ELEM(op, T, U, MAD, 2);                                          \
+    OPT_ELEM(op, T, U, MAD, 3);                                          \
+    OPT_ELEM(op, T, U, MAD, 4);                                          \
+    OPT_ELEM(op, T, U, MAD, 5);                                          \
+    OPT_ELEM(op, T, U, MAD, 6);                                          \
+    OPT_ELEM(op, T, U, MAD, 7);                                          \
+                                                                         \
+    dest += 8;                                                           \
+    src0 += 8;                                                           \
+    src1 += 8;                                                           \
+    if (src2 != NULL) src2 += 8;                                         \
+                                                                         \
+    --sz_8;                                                              \
+  }                                                                      \
+  (void)k;                                                               \
+}
 
-  switch (size % 8) {
-    case 7:  *(dest++) = *(src0++) + *(src1++);
-    case 6:  *(dest++) = *(src0++) + *(src1++);
-    case 5:  *(dest++) = *(src0++) + *(src1++);
-    case 4:  *(dest++) = *(src0++) + *(src1++);
-    case 3:  *(dest++) = *(src0++) + *(src1++);
-    case 2:  *(dest++) = *(src0++) + *(src1++);
-    case 1:  *(dest++) = *(src0++) + *(src1++);
-    case 0:  break;
-  }
+VV_FOR_EACH(OPT_KERNEL)
 
+#define OPT_ENTRY(op, OP, name, NAME, T, U, MAD) VV_ENTRY(opt, op, OP, name, NAME)
 
-  while (sz_8 > 0) {
-    dest[0] = src0[0] + src1[0];
-    dest[1] = src0[1] + src1[1];
-    dest[2] = src0[2] + src1[2];
-    dest[3] = src0[3] + src1[3];
-    dest[4] = src0[4] + src1[4];
-    dest[5] = src0[5] + src1[5];
-    dest[6] = src0[6] + src1[6];
-    dest[7] = src0[7] + src1[7];
+static const vv_kernel_t opt_kernels[VV_NUM_OPS][VV_NUM_TYPES] = {
+  VV_FOR_EACH(OPT_ENTRY)
+};
 
-    dest += 8;
-    src0 += 8;
-    src1 += 8;
+__attribute__ ((optimize(1)))
+void* impl_scalar_opt(void* args)
+{
+  /* Get the argument struct */
+  args_t* parsed_args = (args_t*)args;
 
-    --sz_8;
-  }
+  /* Run the kernel of the op and type over all elements */
+  opt_kernels[parsed_args->op][parsed_args->type](parsed_args, 0, parsed_args->size);
 
   /* Done */
   return NULL;
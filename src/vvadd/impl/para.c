@@ -10,6 +10,8 @@
 
 /* Standard C includes */
 #include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
 #include <pthread.h>
 #include <sched.h>
 #include <assert.h>
@@ -25,99 +27,128 @@
 
 /* Include application-specific headers */
 #include "include/types.h"
+#include "include/ops.h"
+#include "impl/pool.h"
+#include "impl/para.h"
+
+/* Per-thread kernels, one per (op, type); vectorized by the compiler */
+#define PARA_KERNEL(op, OP, name, NAME, T, U, MAD)                       \
+static void para_##op##_##name(const args_t* args, size_t begin, size_t end) \
+{                                                                        \
+  T*       dest = (      T*)(args->output);                              \
+  const T* src0 = (const T*)(args->input0);                              \
+  const T* src1 = (const T*)(args->input1);                              \
+  const T* src2 = (const T*)(args->input2);                              \
+  const T  k    = (T)(args->alpha);                                      \
+                                                                         \
+  for (size_t i = begin; i < end; i++) {                                 \
+    dest[i] = VV_SCALAR(op, T, U, MAD, src0[i], src1[i], src2[i], k);    \
+  }                                                                      \
+  (void)src2; (void)k;                                                   \
+}
 
-/* Alternative Implementation */
-void* worker(void* args) {
-  /* Parse the arguments structure */
-  args_t *p_args = (args_t*)args;
-
-  /* Get all the arguments */
-  register       int*   dest = (      int*)(p_args->output);
-  register const int*   src0 = (const int*)(p_args->input0);
-  register const int*   src1 = (const int*)(p_args->input1);
-  register       size_t size =              p_args->size;
-
-  for (int i = 0; i < size; i++) {
-    dest[i] = src0[i] + src1[i];
+VV_FOR_EACH(PARA_KERNEL)
+
+#define PARA_ENTRY(op, OP, name, NAME, T, U, MAD) VV_ENTRY(para, op, OP, name, NAME)
+
+static const vv_kernel_t para_kernels[VV_NUM_OPS][VV_NUM_TYPES] = {
+  VV_FOR_EACH(PARA_ENTRY)
+};
+
+/* Pool shared by every call, rebuilt when the threads or CPUs change */
+static pool_t* para_pool     = NULL;
+static int     para_nthreads = 0;
+static int*    para_cpus     = NULL;    /* Placement it was pinned with */
+
+/* Share tid of the elements, the first ones taking the remainder */
+static void para_task(void* ctx, int tid, int nthreads)
+{
+  const args_t* args = (const args_t*)ctx;
+
+  size_t size_per_thread = args->size / nthreads;
+  size_t remaining       = args->size % nthreads;
+  size_t t     = (size_t)tid;
+  size_t begin = t * size_per_thread + (t < remaining ? t : remaining);
+  size_t end   = begin + size_per_thread + (t < remaining);
+
+  para_kernels[args->op][args->type](args, begin, end);
+}
+
+/* Threads are created and pinned once, not on every call: the pool is
+ * only rebuilt when the thread count or the placement changes         */
+static void para_ensure_pool(const args_t* args)
+{
+  int  nthreads = args->nthreads > 0 ? args->nthreads : 1;
+  bool same     = para_pool != NULL && para_nthreads == nthreads &&
+                  (args->cpus == NULL) == (para_cpus == NULL) &&
+                  (args->cpus == NULL || memcmp(args->cpus, para_cpus, nthreads * sizeof(int)) == 0);
+  if (same) return;
+
+  impl_parallel_shutdown();
+  if (args->cpus != NULL) {
+    para_cpus = (int*)malloc(nthreads * sizeof(int));
+    memcpy(para_cpus, args->cpus, nthreads * sizeof(int));
   }
+  para_pool     = pool_create(nthreads, para_cpus);
+  para_nthreads = nthreads;
+  assert(para_pool != NULL);
+}
 
-  return NULL;
+/* Zero every thread's share of the inputs and the output on that thread */
+static void para_touch_task(void* ctx, int tid, int nthreads)
+{
+  const args_t* args = (const args_t*)ctx;
+  size_t elem = vv_type_sizes[args->type];
+
+  size_t size_per_thread = args->size / nthreads;
+  size_t remaining       = args->size % nthreads;
+  size_t t     = (size_t)tid;
+  size_t begin = (t * size_per_thread + (t < remaining ? t : remaining)) * elem;
+  size_t len   = (size_per_thread + (t < remaining)) * elem;
+
+  memset(args->input0 + begin, 0, len);
+  memset(args->input1 + begin, 0, len);
+  memset(args->output + begin, 0, len);
+  if (args->input2 != NULL) memset(args->input2 + begin, 0, len);
 }
 
+/* Alternative Implementation */
 void* impl_parallel(void* args)
 {
   /* Get the argument struct */
   args_t* p_args = (args_t*)args;
 
-  /* Get all the arguments */
-  register       int*   dest = (      int*)(p_args->output);
-  register const int*   src0 = (const int*)(p_args->input0);
-  register const int*   src1 = (const int*)(p_args->input1);
-  register       size_t size =              p_args->size / 4;
-
-  register       size_t nthreads = p_args->nthreads;
-  register       size_t cpu      = p_args->cpu;
-
-  /* Create all threads */
-  pthread_t tid[nthreads];
-  args_t    targs[nthreads];
-  cpu_set_t cpuset[nthreads];
-
-  /* Amount of work per thread */
-  size_t size_per_thread = size / nthreads;
-  size_t remaining = size % nthreads;
-
-  for (int i = 0; i < nthreads; i++) {
-    /* Initialize the argument structure */
-    targs[i].size     = size_per_thread;
-    targs[i].output   = (byte*)dest;
-    targs[i].input0   = (byte*)src0;
-    targs[i].input1   = (byte*)src1;
-
-    dest += targs[i].size;
-    src0 += targs[i].size;
-    src1 += targs[i].size;
-
-    targs[i].cpu      = (cpu + i) % nthreads;
-    targs[i].nthreads = nthreads;
-
-    /* Affinity */
-    CPU_ZERO(&(cpuset[i]));
-    CPU_SET(targs[i].cpu, &(cpuset[i]));
-
-    /* Set affinity */
-    if (i == 0) {
-      tid[i] = pthread_self();
-    } else {
-      int __attribute__((unused)) res = \
-                         pthread_create(&tid[i], NULL, worker, (void*)&targs[i]);
-    }
-
-    int __attribute__((unused)) res_affinity = pthread_setaffinity_np(tid[i],
-                                                sizeof(cpuset[i]), &(cpuset[i]));
-  }
-
-  if (nthreads > 0) {
-    /* Perform one portion of the work */
-    for (int i = 0; i < targs[0].size; i++) {
-      ((int*)targs[0].output)[i] =                            \
-                          ((const int*)targs[0].input0)[i] +  \
-                              ((const int*)targs[0].input1)[i];
-    }
-
-    /* Perform trailing elements */
-    for (int i = size - remaining; i < size; i++) {
-      ((int*)targs[0].output)[i] =                            \
-                          ((const int*)targs[0].input0)[i] +  \
-                              ((const int*)targs[0].input1)[i];
-    }
-  }
-
-  /* Wait for all threads to finish execution */
-  for (int i = 0; i < nthreads; i++) {
-    pthread_join(tid[i], NULL);
-  }
+  para_ensure_pool(p_args);
+  pool_run(para_pool, para_task, p_args);
 
   /* Done */
   return NULL;
 }
+
+void impl_parallel_stats(pool_stats_t* stats)
+{
+  pool_stats_t none = {0};
+  *stats = none;
+  if (para_pool != NULL) pool_get_stats(para_pool, stats);
+}
+
+void impl_parallel_reset_stats(void)
+{
+  if (para_pool != NULL) pool_reset_stats(para_pool);
+}
+
+void impl_parallel_touch(void* args)
+{
+  para_ensure_pool((const args_t*)args);
+  pool_run(para_pool, para_touch_task, args);
+  impl_parallel_reset_stats();
+}
+
+void impl_parallel_shutdown(void)
+{
+  pool_destroy(para_pool);
+  free(para_cpus);
+  para_pool     = NULL;
+  para_nthreads = 0;
+  para_cpus     = NULL;
+}
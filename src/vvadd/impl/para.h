@@ -9,7 +9,19 @@
 #ifndef __IMPL_PARA_H_
 #define __IMPL_PARA_H_
 
+#include "impl/pool.h"
+
 /* Function declaration */
 void* impl_parallel(void* args);
 
+/* The worker pool behind impl_parallel: its dispatch and join
+ * overheads, and the teardown of its threads                  */
+void impl_parallel_stats(pool_stats_t* stats);
+void impl_parallel_reset_stats(void);
+void impl_parallel_shutdown(void);
+
+/* First touch: every thread zeroes its share of the buffers of args,
+ * so the pages land on its NUMA node before the data is written     */
+void impl_parallel_touch(void* args);
+
 #endif //__IMPL_PARA_H_
@@ -0,0 +1,288 @@
+/* pool.c
+ *
+ *  Persistent pinned thread pool, see pool.h.
+ */
+
+#define _GNU_SOURCE
+
+/* Standard C includes */
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <limits.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#if defined(__linux__)
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#endif
+#if defined(__amd64__) || defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+/* If we are on Darwin, include the compatibility header */
+#if defined(__APPLE__)
+#include "common/mach_pthread_compatibility.h"
+#endif
+
+/* Include application-specific headers */
+#include "impl/pool.h"
+
+/* Spins before a waiter goes to sleep on the futex */
+#define POOL_SPINS       (1 << 14)
+#define POOL_YIELD_EVERY 256
+
+#define POOL_CACHE_LINE 64
+
+/* Sense-reversing centralized barrier; sense is the futex word */
+typedef struct {
+  int count    __attribute__((aligned(POOL_CACHE_LINE)));
+  int sense    __attribute__((aligned(POOL_CACHE_LINE)));
+  int sleepers __attribute__((aligned(POOL_CACHE_LINE)));
+  int nthreads;
+} pool_barrier_t;
+
+/* Per-member state, one cache line each */
+typedef struct {
+  pool_t*   pool;
+  int       tid;
+  int       start_sense; /* Local senses of the barriers */
+  int       done_sense;
+  uint64_t  t_start;     /* Share started / finished     */
+  uint64_t  t_end;
+  pthread_t thread;
+} __attribute__((aligned(POOL_CACHE_LINE))) pool_member_t;
+
+struct pool {
+  int            nthreads;
+  pool_barrier_t start;
+  pool_barrier_t done;
+
+  /* Current task, published before the start barrier */
+  pool_task_t    task;
+  void*          ctx;
+  bool           quit;
+
+  pool_member_t* members;
+  pool_stats_t   stats;
+};
+
+static inline uint64_t pool_now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static inline void pool_relax(void)
+{
+#if defined(__amd64__) || defined(__x86_64__)
+  _mm_pause();
+#elif defined(__aarch64__) || defined(__arm64__)
+  __asm__ __volatile__ ("yield");
+#endif
+}
+
+static void pool_futex_wait(int* addr, int val)
+{
+#if defined(__linux__)
+  syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, val, NULL, NULL, 0);
+#else
+  (void)addr; (void)val;
+  sched_yield();
+#endif
+}
+
+static void pool_futex_wake(int* addr)
+{
+#if defined(__linux__)
+  syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+#else
+  (void)addr;
+#endif
+}
+
+static void pool_barrier_init(pool_barrier_t* b, int nthreads)
+{
+  b->count    = 0;
+  b->sense    = 0;
+  b->sleepers = 0;
+  b->nthreads = nthreads;
+}
+
+static void pool_barrier_wait(pool_barrier_t* b, int* local_sense)
+{
+  int sense = !*local_sense;
+  *local_sense = sense;
+
+  if (__atomic_add_fetch(&b->count, 1, __ATOMIC_ACQ_REL) == b->nthreads) {
+    /* Last to arrive: reset and release the others */
+    __atomic_store_n(&b->count, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&b->sense, sense, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&b->sleepers, __ATOMIC_SEQ_CST) > 0) {
+      pool_futex_wake(&b->sense);
+    }
+    return;
+  }
+
+  /* Spin, giving the CPU away now and then in case the member we
+   * wait for shares it with us                                    */
+  for (int i = 1; i <= POOL_SPINS; i++) {
+    if (__atomic_load_n(&b->sense, __ATOMIC_ACQUIRE) == sense) return;
+    if (i % POOL_YIELD_EVERY == 0) {
+      sched_yield();
+    } else {
+      pool_relax();
+    }
+  }
+
+  /* Either the releaser sees us as a sleeper, or we see its sense */
+  __atomic_add_fetch(&b->sleepers, 1, __ATOMIC_SEQ_CST);
+  while (__atomic_load_n(&b->sense, __ATOMIC_SEQ_CST) != sense) {
+    pool_futex_wait(&b->sense, !sense);
+  }
+  __atomic_sub_fetch(&b->sleepers, 1, __ATOMIC_RELAXED);
+}
+
+static void pool_pin(pthread_t thread, int cpu)
+{
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  CPU_SET(cpu, &cpuset);
+  int __attribute__((unused)) res = pthread_setaffinity_np(thread, sizeof(cpuset), &cpuset);
+}
+
+static void* pool_worker(void* arg)
+{
+  pool_member_t* self = (pool_member_t*)arg;
+  pool_t*        pool = self->pool;
+
+  for (;;) {
+    pool_barrier_wait(&pool->start, &self->start_sense);
+    if (pool->quit) break;
+
+    self->t_start = pool_now();
+    pool->task(pool->ctx, self->tid, pool->nthreads);
+    self->t_end   = pool_now();
+
+    pool_barrier_wait(&pool->done, &self->done_sense);
+  }
+
+  return NULL;
+}
+
+pool_t* pool_create(int nthreads, const int* cpus)
+{
+  if (nthreads < 1) nthreads = 1;
+
+  /* The barriers are cache-line aligned, calloc would not honour it */
+  pool_t* pool = (pool_t*)aligned_alloc(POOL_CACHE_LINE, sizeof(pool_t));
+  if (pool == NULL) return NULL;
+  memset(pool, 0, sizeof(pool_t));
+
+  pool->members = (pool_member_t*)aligned_alloc(POOL_CACHE_LINE, nthreads * sizeof(pool_member_t));
+  if (pool->members == NULL) {
+    free(pool);
+    return NULL;
+  }
+
+  pool->nthreads = nthreads;
+  pool_barrier_init(&pool->start, nthreads);
+  pool_barrier_init(&pool->done , nthreads);
+
+  for (int i = 0; i < nthreads; i++) {
+    pool->members[i].pool        = pool;
+    pool->members[i].tid         = i;
+    pool->members[i].start_sense = 0;
+    pool->members[i].done_sense  = 0;
+    pool->members[i].t_start     = 0;
+    pool->members[i].t_end       = 0;
+  }
+
+  pool->members[0].thread = pthread_self();
+  if (cpus != NULL) pool_pin(pool->members[0].thread, cpus[0]);
+
+  for (int i = 1; i < nthreads; i++) {
+    if (pthread_create(&pool->members[i].thread, NULL, pool_worker, &pool->members[i]) != 0) {
+      /* Shrink to the workers that did start */
+      pool->nthreads = i;
+      pool->start.nthreads = pool->done.nthreads = i;
+      break;
+    }
+    if (cpus != NULL) pool_pin(pool->members[i].thread, cpus[i]);
+  }
+
+  return pool;
+}
+
+void pool_run(pool_t* pool, pool_task_t task, void* ctx)
+{
+  pool_member_t* self = &pool->members[0];
+
+  if (pool->nthreads == 1) {
+    task(ctx, 0, 1);
+    return;
+  }
+
+  uint64_t t0 = pool_now();
+
+  pool->task = task;
+  pool->ctx  = ctx;
+  pool_barrier_wait(&pool->start, &self->start_sense);
+
+  task(ctx, 0, pool->nthreads);
+  self->t_end = pool_now();
+
+  pool_barrier_wait(&pool->done, &self->done_sense);
+  uint64_t t1 = pool_now();
+
+  /* The slowest start and the slowest finish bound the overheads */
+  uint64_t last_start = t0, last_end = self->t_end;
+  for (int i = 1; i < pool->nthreads; i++) {
+    if (pool->members[i].t_start > last_start) last_start = pool->members[i].t_start;
+    if (pool->members[i].t_end   > last_end  ) last_end   = pool->members[i].t_end;
+  }
+
+  uint64_t dispatch = last_start - t0;
+  uint64_t join     = t1 - last_end;
+
+  pool->stats.calls       += 1;
+  pool->stats.dispatch_ns += dispatch;
+  pool->stats.join_ns     += join;
+  if (dispatch > pool->stats.max_dispatch_ns) pool->stats.max_dispatch_ns = dispatch;
+  if (join     > pool->stats.max_join_ns    ) pool->stats.max_join_ns     = join;
+}
+
+int pool_nthreads(const pool_t* pool)
+{
+  return pool->nthreads;
+}
+
+void pool_get_stats(const pool_t* pool, pool_stats_t* stats)
+{
+  *stats = pool->stats;
+}
+
+void pool_reset_stats(pool_t* pool)
+{
+  pool_stats_t zero = {0};
+  pool->stats = zero;
+}
+
+void pool_destroy(pool_t* pool)
+{
+  if (pool == NULL) return;
+
+  if (pool->nthreads > 1) {
+    pool->quit = true;
+    pool_barrier_wait(&pool->start, &pool->members[0].start_sense);
+    for (int i = 1; i < pool->nthreads; i++) {
+      pthread_join(pool->members[i].thread, NULL);
+    }
+  }
+
+  free(pool->members);
+  free(pool);
+}
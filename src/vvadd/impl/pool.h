@@ -0,0 +1,51 @@
+/* pool.h
+ *
+ * Persistent pool of pinned worker threads. The calling thread is
+ * member 0; members 1 .. nthreads-1 are created once and wait at a
+ * sense-reversing barrier between tasks. A task is dispatched by the
+ * caller arriving at the start barrier and joined at the done barrier.
+ * Waiters spin (with a pause) for a bounded number of iterations and
+ * then sleep on a futex, so an oversubscribed machine still makes
+ * progress.
+ *
+ * Every pool_run records two overheads (in ns):
+ *   dispatch = last worker starting its share - caller entering pool_run
+ *   join     = caller leaving pool_run - last member finishing its share
+*/
+
+#ifndef __IMPL_POOL_H_
+#define __IMPL_POOL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Share tid of nthreads of a task */
+typedef void (*pool_task_t)(void* ctx, int tid, int nthreads);
+
+typedef struct pool pool_t;
+
+typedef struct {
+  uint64_t calls;          /* pool_run calls with nthreads > 1 */
+  uint64_t dispatch_ns;    /* Sum over those calls             */
+  uint64_t join_ns;
+  uint64_t max_dispatch_ns;
+  uint64_t max_join_ns;
+} pool_stats_t;
+
+/* Start nthreads - 1 workers, member i pinned to cpus[i] (the caller
+ * too); cpus == NULL leaves the affinity alone. NULL on failure.     */
+pool_t* pool_create(int nthreads, const int* cpus);
+
+/* Run task on every member and return once all shares are done */
+void pool_run(pool_t* pool, pool_task_t task, void* ctx);
+
+int pool_nthreads(const pool_t* pool);
+
+/* Overheads recorded since the pool started or was last reset */
+void pool_get_stats(const pool_t* pool, pool_stats_t* stats);
+void pool_reset_stats(pool_t* pool);
+
+/* Stop and join the workers */
+void pool_destroy(pool_t* pool);
+
+#endif //__IMPL_POOL_H_
@@ -18,6 +18,31 @@
 
 /* Include application-specific headers */
 #include "include/types.h"
+#include "include/ops.h"
+
+/* Reference kernels, one per (op, type) */
+#define REF_KERNEL(op, OP, name, NAME, T, U, MAD)                        \
+static void ref_##op##_##name(const args_t* args, size_t begin, size_t end) \
+{                                                                        \
+  T*       dest = (      T*)(args->output);                              \
+  const T* src0 = (const T*)(args->input0);                              \
+  const T* src1 = (const T*)(args->input1);                              \
+  const T* src2 = (const T*)(args->input2);                              \
+  const T  k    = (T)(args->alpha);                                      \
+                                                                         \
+  for (size_t i = begin; i < end; i++) {                                 \
+    dest[i] = VV_SCALAR(op, T, U, MAD, src0[i], src1[i], src2[i], k);    \
+  }                                                                      \
+  (void)src2; (void)k;                                                   \
+}
+
+VV_FOR_EACH(REF_KERNEL)
+
+#define REF_ENTRY(op, OP, name, NAME, T, U, MAD) VV_ENTRY(ref, op, OP, name, NAME)
+
+static const vv_kernel_t ref_kernels[VV_NUM_OPS][VV_NUM_TYPES] = {
+  VV_FOR_EACH(REF_ENTRY)
+};
 
 /* Reference Implementation */
 void* impl_ref(void* args)
@@ -25,15 +50,8 @@ void* impl_ref(void* args)
   /* Get the argument struct */
   args_t* parsed_args = (args_t*) args;
 
-  /* Get all the arguments */
-  register       int*   dest = (      int*)(parsed_args->output);
-  register const int*   src0 = (const int*)(parsed_args->input0);
-  register const int*   src1 = (const int*)(parsed_args->input1);
-  register       size_t size =              parsed_args->size / 4;
-
-  for (register int i = 0; i < size; i++) {
-    dest[i] = src0[i] + src1[i];
-  }
+  /* Run the kernel of the op and type over all elements */
+  ref_kernels[parsed_args->op][parsed_args->type](parsed_args, 0, parsed_args->size);
 
   /* Done */
   return NULL;
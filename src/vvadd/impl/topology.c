@@ -0,0 +1,250 @@
+/* topology.c
+ *
+ *  CPU topology from sysfs and thread placements, see topology.h.
+ */
+
+#define _GNU_SOURCE
+
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+
+/* Include application-specific headers */
+#include "impl/topology.h"
+
+#define TOPO_ROOT     "/sys/devices/system"
+#define TOPO_MAX_CPUS 1024          /* CPU_SETSIZE on Linux */
+
+static const char* const topo_policy_names[TOPO_NUM_POLICIES] = {
+  "linear", "compact", "scatter", "numa"
+};
+
+/* First line of a sysfs file */
+static int topo_read_line(const char* path, char* buf, size_t len)
+{
+  FILE* fp = fopen(path, "r");
+  if (fp == NULL) return -1;
+
+  char* res = fgets(buf, (int)len, fp);
+  fclose(fp);
+  if (res == NULL) return -1;
+
+  buf[strcspn(buf, "\n")] = '\0';
+  return 0;
+}
+
+static int topo_read_int(const char* path, int* val)
+{
+  char buf[64];
+  if (topo_read_line(path, buf, sizeof(buf)) != 0) return -1;
+  *val = atoi(buf);
+  return 0;
+}
+
+/* A cpulist ("0-3,8,10-11") into set[0 .. TOPO_MAX_CPUS) */
+static int topo_read_list(const char* path, bool* set)
+{
+  char buf[4096];
+  if (topo_read_line(path, buf, sizeof(buf)) != 0) return -1;
+
+  memset(set, 0, TOPO_MAX_CPUS * sizeof(bool));
+  for (char* tok = strtok(buf, ","); tok != NULL; tok = strtok(NULL, ",")) {
+    int lo, hi;
+    int n = sscanf(tok, "%d-%d", &lo, &hi);
+    if (n < 1) continue;
+    if (n == 1) hi = lo;
+    for (int c = lo; c <= hi && c < TOPO_MAX_CPUS; c++) {
+      if (c >= 0) set[c] = true;
+    }
+  }
+  return 0;
+}
+
+int topo_load(topology_t* topo, const char* root)
+{
+  char  path[512];
+  bool* online = (bool*)calloc(TOPO_MAX_CPUS, sizeof(bool));
+  bool* list   = (bool*)calloc(TOPO_MAX_CPUS, sizeof(bool));
+
+  if (root == NULL) root = TOPO_ROOT;
+  memset(topo, 0, sizeof(*topo));
+  topo->from_sysfs = true;
+
+  /* Online CPUs, or the first N if sysfs is not there */
+  snprintf(path, sizeof(path), "%s/cpu/online", root);
+  if (topo_read_list(path, online) != 0) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    for (long c = 0; c < n && c < TOPO_MAX_CPUS; c++) online[c] = true;
+    topo->from_sysfs = false;
+  }
+
+  for (int c = 0; c < TOPO_MAX_CPUS; c++) topo->ncpus += online[c];
+  if (topo->ncpus == 0) {
+    free(online);
+    free(list);
+    return -1;
+  }
+  topo->cpus = (topo_cpu_t*)calloc(topo->ncpus, sizeof(topo_cpu_t));
+
+  /* Package, raw core_id and SMT rank of every CPU */
+  int* core_id = (int*)calloc(topo->ncpus, sizeof(int));
+  for (int c = 0, i = 0; c < TOPO_MAX_CPUS; c++) {
+    if (!online[c]) continue;
+    topo_cpu_t* t = &topo->cpus[i];
+    t->cpu = c;
+
+    snprintf(path, sizeof(path), "%s/cpu/cpu%d/topology/physical_package_id", root, c);
+    if (topo_read_int(path, &t->package) != 0) t->package = 0;
+    snprintf(path, sizeof(path), "%s/cpu/cpu%d/topology/core_id", root, c);
+    if (topo_read_int(path, &core_id[i]) != 0) core_id[i] = c;
+
+    /* Rank among the online siblings of the core */
+    snprintf(path, sizeof(path), "%s/cpu/cpu%d/topology/thread_siblings_list", root, c);
+    if (topo_read_list(path, list) == 0) {
+      for (int s = 0; s < c; s++) t->smt += list[s] && online[s];
+    }
+    i++;
+  }
+
+  /* NUMA node of every CPU (node 0 without the node directory) */
+  snprintf(path, sizeof(path), "%s/node/online", root);
+  bool* nodes = (bool*)calloc(TOPO_MAX_CPUS, sizeof(bool));
+  if (topo_read_list(path, nodes) == 0) {
+    for (int n = 0; n < TOPO_MAX_CPUS; n++) {
+      if (!nodes[n]) continue;
+      snprintf(path, sizeof(path), "%s/node/node%d/cpulist", root, n);
+      if (topo_read_list(path, list) != 0) continue;
+      for (int i = 0; i < topo->ncpus; i++) {
+        if (list[topo->cpus[i].cpu]) topo->cpus[i].node = n;
+      }
+    }
+  }
+
+  /* Number cores by first appearance: globally and within the node */
+  int* node_cores = (int*)calloc(TOPO_MAX_CPUS, sizeof(int));
+  for (int i = 0; i < topo->ncpus; i++) {
+    topo_cpu_t* t = &topo->cpus[i];
+    int j;
+    for (j = 0; j < i; j++) {
+      if (topo->cpus[j].package == t->package && core_id[j] == core_id[i]) break;
+    }
+    if (j < i) {
+      t->core         = topo->cpus[j].core;
+      t->core_in_node = topo->cpus[j].core_in_node;
+      continue;
+    }
+
+    if (node_cores[t->node] == 0) topo->nnodes++;
+    t->core         = topo->ncores++;
+    t->core_in_node = node_cores[t->node]++;
+
+    for (j = 0; j < i; j++) {
+      if (topo->cpus[j].package == t->package) break;
+    }
+    if (j == i) topo->npackages++;
+  }
+
+  free(core_id);
+  free(node_cores);
+  free(nodes);
+  free(online);
+  free(list);
+  return 0;
+}
+
+void topo_free(topology_t* topo)
+{
+  free(topo->cpus);
+  topo->cpus  = NULL;
+  topo->ncpus = 0;
+}
+
+const char* topo_policy_name(topo_policy_t policy)
+{
+  return (policy >= 0 && policy < TOPO_NUM_POLICIES) ? topo_policy_names[policy] : "unknown";
+}
+
+int topo_parse_placement(const char* spec, topo_placement_t* placement)
+{
+  char buf[64];
+  snprintf(buf, sizeof(buf), "%s", spec);
+
+  placement->policy = TOPO_LINEAR;
+  placement->smt    = true;
+
+  char* tok = strtok(buf, ",");
+  if (tok == NULL) return -1;
+
+  int p;
+  for (p = 0; p < TOPO_NUM_POLICIES; p++) {
+    if (strcmp(tok, topo_policy_names[p]) == 0) break;
+  }
+  if (p == TOPO_NUM_POLICIES) return -1;
+  placement->policy = (topo_policy_t)p;
+
+  for (tok = strtok(NULL, ","); tok != NULL; tok = strtok(NULL, ",")) {
+    if (strcmp(tok, "smt") == 0) {
+      placement->smt = true;
+    } else if (strcmp(tok, "nosmt") == 0) {
+      placement->smt = false;
+    } else {
+      return -1;
+    }
+  }
+  return 0;
+}
+
+/* Sort key of a CPU: up to three fields, then the CPU number */
+static uint64_t topo_key(const topo_cpu_t* t, topo_policy_t policy)
+{
+  uint64_t f0 = 0, f1 = 0, f2 = 0;
+
+  switch (policy) {
+    case TOPO_COMPACT: f0 = t->node; f1 = t->core        ; f2 = t->smt ; break;
+    case TOPO_SCATTER: f0 = t->smt ; f1 = t->core        ; f2 = 0      ; break;
+    case TOPO_NUMA:    f0 = t->smt ; f1 = t->core_in_node; f2 = t->node; break;
+    default:                                                           break;
+  }
+
+  return (f0 << 48) | (f1 << 32) | (f2 << 16) | (uint64_t)t->cpu;
+}
+
+int topo_place(const topology_t* topo, const topo_placement_t* placement,
+               int cpu, int nthreads, int* cpus)
+{
+  int       n     = 0;
+  int*      order = (int*)malloc(topo->ncpus * sizeof(int));
+  uint64_t* keys  = (uint64_t*)malloc(topo->ncpus * sizeof(uint64_t));
+
+  /* Eligible CPUs, insertion-sorted by key */
+  for (int i = 0; i < topo->ncpus; i++) {
+    const topo_cpu_t* t = &topo->cpus[i];
+    if (!placement->smt && t->smt > 0) continue;
+
+    uint64_t key = topo_key(t, placement->policy);
+    int j = n++;
+    for (; j > 0 && keys[j - 1] > key; j--) {
+      keys [j] = keys [j - 1];
+      order[j] = order[j - 1];
+    }
+    keys [j] = key;
+    order[j] = t->cpu;
+  }
+
+  /* Start at the main CPU */
+  int start = 0;
+  for (int i = 0; i < n; i++) {
+    if (order[i] == cpu) start = i;
+  }
+
+  for (int i = 0; i < nthreads; i++) {
+    cpus[i] = order[(start + i) % n];
+  }
+
+  free(order);
+  free(keys);
+  return nthreads < n ? nthreads : n;
+}
@@ -0,0 +1,71 @@
+/* topology.h
+ *
+ * CPU topology read from sysfs (/sys/devices/system/cpu and
+ * /sys/devices/system/node) and the thread placements built on it.
+ * A placement orders the online CPUs, starts at the main CPU and
+ * gives thread i the i-th CPU of that order (wrapping around when
+ * there are more threads than CPUs):
+ *
+ *  - linear : by CPU number (the historical behaviour)
+ *  - compact: node by node, core by core, SMT siblings together
+ *  - scatter: one thread per core before any core gets a second one
+ *  - numa   : like scatter, but consecutive threads on different NUMA
+ *             nodes, so every memory controller is used
+ *
+ * With SMT off only the first hardware thread of every core is used.
+*/
+
+#ifndef __IMPL_TOPOLOGY_H_
+#define __IMPL_TOPOLOGY_H_
+
+#include <stdbool.h>
+
+typedef enum {
+  TOPO_LINEAR  = 0,
+  TOPO_COMPACT = 1,
+  TOPO_SCATTER = 2,
+  TOPO_NUMA    = 3,
+  TOPO_NUM_POLICIES
+} topo_policy_t;
+
+typedef struct {
+  topo_policy_t policy;
+  bool          smt;        /* Use every hardware thread of a core */
+} topo_placement_t;
+
+/* One online CPU */
+typedef struct {
+  int cpu;
+  int package;
+  int core;                 /* Index among all cores, from 0      */
+  int core_in_node;         /* Index among the cores of its node  */
+  int smt;                  /* Index among the threads of its core */
+  int node;
+} topo_cpu_t;
+
+typedef struct {
+  int         ncpus;
+  int         ncores;
+  int         npackages;
+  int         nnodes;
+  bool        from_sysfs;   /* false: one core per CPU, one node   */
+  topo_cpu_t* cpus;         /* Ordered by CPU number               */
+} topology_t;
+
+/* Read the topology under root (NULL = /sys/devices/system). Missing
+ * files degrade to one core per online CPU on a single node.
+ * Returns 0, or -1 if no CPU at all could be found.                  */
+int  topo_load(topology_t* topo, const char* root);
+void topo_free(topology_t* topo);
+
+/* "compact", "scatter,nosmt", "numa,smt", ...; returns 0 or -1 */
+int  topo_parse_placement(const char* spec, topo_placement_t* placement);
+const char* topo_policy_name(topo_policy_t policy);
+
+/* CPU of threads 0 .. nthreads-1 in cpus, thread 0 on cpu if it is
+ * one of the placement's CPUs (on the first one otherwise). Returns
+ * the number of distinct CPUs used.                                 */
+int  topo_place(const topology_t* topo, const topo_placement_t* placement,
+                int cpu, int nthreads, int* cpus);
+
+#endif //__IMPL_TOPOLOGY_H_
@@ -23,49 +23,168 @@
 
 /* Include application-specific headers */
 #include "include/types.h"
+#include "include/ops.h"
 
-/* Alternative Implementation */
-void* impl_vector(void* args)
-{
 #if defined(__amd64__) || defined(__x86_64__)
-  /* Get the argument struct */
-  args_t* parsed_args = (args_t*)args;
+/* AVX2 has no 8-bit multiply: multiply the even and odd bytes as
+ * 16-bit lanes and merge the low bytes of the products             */
+static inline __m256i vec_mullo_epi8(__m256i a, __m256i b)
+{
+  __m256i even = _mm256_mullo_epi16(a, b);
+  __m256i odd  = _mm256_mullo_epi16(_mm256_srli_epi16(a, 8), _mm256_srli_epi16(b, 8));
+  return _mm256_or_si256(_mm256_slli_epi16(odd, 8),
+                         _mm256_and_si256(even, _mm256_set1_epi16(0x00ff)));
+}
 
-  /* Get all the arguments */
-  register       int*   dest = (      int*)(parsed_args->output);
-  register const int*   src0 = (const int*)(parsed_args->input0);
-  register const int*   src1 = (const int*)(parsed_args->input1);
-  register       size_t size =              parsed_args->size / 4;
+/* Nor a 64-bit one: lo(a) lo(b) + (lo(a) hi(b) + hi(a) lo(b)) << 32 */
+static inline __m256i vec_mullo_epi64(__m256i a, __m256i b)
+{
+  __m256i cross = _mm256_mullo_epi32(a, _mm256_shuffle_epi32(b, 0xb1));
+  __m256i sum   = _mm256_add_epi32(cross, _mm256_srli_epi64(cross, 32));
+  return _mm256_add_epi64(_mm256_mul_epu32(a, b), _mm256_slli_epi64(sum, 32));
+}
+
+/* Nor 64-bit min/max: select on a signed compare */
+#define vec_min_epi64(a, b) _mm256_blendv_epi8((a), (b), _mm256_cmpgt_epi64((a), (b)))
+#define vec_max_epi64(a, b) _mm256_blendv_epi8((a), (b), _mm256_cmpgt_epi64((b), (a)))
+
+/* Per type: vector type, load, store, broadcast and the primitives */
+#define VEC_T_int8               __m256i
+#define VEC_LOAD_int8(p)         _mm256_loadu_si256((const __m256i*)(p))
+#define VEC_STORE_int8(p, v)     _mm256_storeu_si256((__m256i*)(p), v)
+#define VEC_SET1_int8(k)         _mm256_set1_epi8(k)
+#define VEC_ADD_int8(a, b)       _mm256_add_epi8(a, b)
+#define VEC_SUB_int8(a, b)       _mm256_sub_epi8(a, b)
+#define VEC_MUL_int8(a, b)       vec_mullo_epi8(a, b)
+#define VEC_MIN_int8(a, b)       _mm256_min_epi8(a, b)
+#define VEC_MAX_int8(a, b)       _mm256_max_epi8(a, b)
 
-  __m256i vm = _mm256_set1_epi32(0x80000000);
-  const int max_vlen = 32 / sizeof(int);
+#define VEC_T_int16              __m256i
+#define VEC_LOAD_int16(p)        VEC_LOAD_int8(p)
+#define VEC_STORE_int16(p, v)    VEC_STORE_int8(p, v)
+#define VEC_SET1_int16(k)        _mm256_set1_epi16(k)
+#define VEC_ADD_int16(a, b)      _mm256_add_epi16(a, b)
+#define VEC_SUB_int16(a, b)      _mm256_sub_epi16(a, b)
+#define VEC_MUL_int16(a, b)      _mm256_mullo_epi16(a, b)
+#define VEC_MIN_int16(a, b)      _mm256_min_epi16(a, b)
+#define VEC_MAX_int16(a, b)      _mm256_max_epi16(a, b)
 
-  for (register size_t hw_vlen, i = 0; i < size; i += hw_vlen) {
+#define VEC_T_int32              __m256i
+#define VEC_LOAD_int32(p)        VEC_LOAD_int8(p)
+#define VEC_STORE_int32(p, v)    VEC_STORE_int8(p, v)
+#define VEC_SET1_int32(k)        _mm256_set1_epi32(k)
+#define VEC_ADD_int32(a, b)      _mm256_add_epi32(a, b)
+#define VEC_SUB_int32(a, b)      _mm256_sub_epi32(a, b)
+#define VEC_MUL_int32(a, b)      _mm256_mullo_epi32(a, b)
+#define VEC_MIN_int32(a, b)      _mm256_min_epi32(a, b)
+#define VEC_MAX_int32(a, b)      _mm256_max_epi32(a, b)
 
-    register int rem = size - i;
-    hw_vlen = rem < max_vlen ? rem : max_vlen;        /* num of elems      */
-    if (hw_vlen < max_vlen) {
-      unsigned int m[max_vlen];
-      for (size_t j = 0; j < max_vlen; j++)
-        m[j] = (j < hw_vlen) ? 0x80000000 : 0x00000000;
-      vm = _mm256_setr_epi32(m[0], m[1], m[2], m[3],
-                             m[4], m[5], m[6], m[7]);
-    }
+#define VEC_T_int64              __m256i
+#define VEC_LOAD_int64(p)        VEC_LOAD_int8(p)
+#define VEC_STORE_int64(p, v)    VEC_STORE_int8(p, v)
+#define VEC_SET1_int64(k)        _mm256_set1_epi64x(k)
+#define VEC_ADD_int64(a, b)      _mm256_add_epi64(a, b)
+#define VEC_SUB_int64(a, b)      _mm256_sub_epi64(a, b)
+#define VEC_MUL_int64(a, b)      vec_mullo_epi64(a, b)
+#define VEC_MIN_int64(a, b)      vec_min_epi64(a, b)
+#define VEC_MAX_int64(a, b)      vec_max_epi64(a, b)
 
-    __m256i vec0 = _mm256_maskload_epi32(src0, vm);   /* Load vectors from */
-    __m256i vec1 = _mm256_maskload_epi32(src1, vm);   /* src0 and src1     */
+#define VEC_T_float              __m256
+#define VEC_LOAD_float(p)        _mm256_loadu_ps(p)
+#define VEC_STORE_float(p, v)    _mm256_storeu_ps(p, v)
+#define VEC_SET1_float(k)        _mm256_set1_ps(k)
+#define VEC_ADD_float(a, b)      _mm256_add_ps(a, b)
+#define VEC_SUB_float(a, b)      _mm256_sub_ps(a, b)
+#define VEC_MUL_float(a, b)      _mm256_mul_ps(a, b)
+#define VEC_MIN_float(a, b)      _mm256_min_ps(a, b)
+#define VEC_MAX_float(a, b)      _mm256_max_ps(a, b)
+#define VEC_MAD_float(a, b, c)   _mm256_fmadd_ps(a, b, c)
 
-    __m256i res  = _mm256_add_epi32(vec0, vec1);      /* Do the compute    */
+#define VEC_T_double             __m256d
+#define VEC_LOAD_double(p)       _mm256_loadu_pd(p)
+#define VEC_STORE_double(p, v)   _mm256_storeu_pd(p, v)
+#define VEC_SET1_double(k)       _mm256_set1_pd(k)
+#define VEC_ADD_double(a, b)     _mm256_add_pd(a, b)
+#define VEC_SUB_double(a, b)     _mm256_sub_pd(a, b)
+#define VEC_MUL_double(a, b)     _mm256_mul_pd(a, b)
+#define VEC_MIN_double(a, b)     _mm256_min_pd(a, b)
+#define VEC_MAX_double(a, b)     _mm256_max_pd(a, b)
+#define VEC_MAD_double(a, b, c)  _mm256_fmadd_pd(a, b, c)
 
-    _mm256_maskstore_epi32(dest, vm, res);            /* Store output      */
+/* Integer multiply-add is a multiply and an add, as in VV_IMAD */
+#define VEC_MAD_int8(a, b, c)    VEC_ADD_int8 (VEC_MUL_int8 (a, b), c)
+#define VEC_MAD_int16(a, b, c)   VEC_ADD_int16(VEC_MUL_int16(a, b), c)
+#define VEC_MAD_int32(a, b, c)   VEC_ADD_int32(VEC_MUL_int32(a, b), c)
+#define VEC_MAD_int64(a, b, c)   VEC_ADD_int64(VEC_MUL_int64(a, b), c)
 
-    src0 += hw_vlen;                                  /* -\                */
-    src1 += hw_vlen;                                  /*   |-> ptr arith   */
-    dest += hw_vlen;                                  /* -/                */
-  }
+/* The ops on a = src0, b = src1, p = &src2[i] (only loaded by fma) */
+#define VEC_OP_add(name, a, b, p, k)   VEC_ADD_##name(a, b)
+#define VEC_OP_sub(name, a, b, p, k)   VEC_SUB_##name(a, b)
+#define VEC_OP_mul(name, a, b, p, k)   VEC_MUL_##name(a, b)
+#define VEC_OP_min(name, a, b, p, k)   VEC_MIN_##name(a, b)
+#define VEC_OP_max(name, a, b, p, k)   VEC_MAX_##name(a, b)
+#define VEC_OP_fma(name, a, b, p, k)   VEC_MAD_##name(a, b, VEC_LOAD_##name(p))
+#define VEC_OP_saxpy(name, a, b, p, k) VEC_MAD_##name(k, a, b)
+
+/* 256-bit vectors (32 / sizeof(T) lanes), the tail element-wise */
+#define VEC_KERNEL(op, OP, name, NAME, T, U, MAD)                        \
+static void vec_##op##_##name(const args_t* args, size_t begin, size_t end) \
+{                                                                        \
+  T*       dest = (      T*)(args->output);                              \
+  const T* src0 = (const T*)(args->input0);                              \
+  const T* src1 = (const T*)(args->input1);                              \
+  const T* src2 = (const T*)(args->input2);                              \
+  const T  k    = (T)(args->alpha);                                      \
+                                                                         \
+  const size_t  vlen = sizeof(VEC_T_##name) / sizeof(T);                 \
+  VEC_T_##name  vk   = VEC_SET1_##name(k);                               \
+                                                                         \
+  size_t i = begin;                                                      \
+  for (; i + vlen <= end; i += vlen) {                                   \
+    VEC_T_##name a = VEC_LOAD_##name(&src0[i]);                          \
+    VEC_T_##name b = VEC_LOAD_##name(&src1[i]);                          \
+    VEC_STORE_##name(&dest[i], VEC_OP_##op(name, a, b, &src2[i], vk));   \
+  }                                                                      \
+  for (; i < end; i++) {                                                 \
+    dest[i] = VV_SCALAR(op, T, U, MAD, src0[i], src1[i], src2[i], k);    \
+  }                                                                      \
+  (void)src2; (void)vk;                                                  \
+}
+#else
+/* No SIMD path for this target: leave it to the compiler */
+#define VEC_KERNEL(op, OP, name, NAME, T, U, MAD)                        \
+static void vec_##op##_##name(const args_t* args, size_t begin, size_t end) \
+{                                                                        \
+  T*       dest = (      T*)(args->output);                              \
+  const T* src0 = (const T*)(args->input0);                              \
+  const T* src1 = (const T*)(args->input1);                              \
+  const T* src2 = (const T*)(args->input2);                              \
+  const T  k    = (T)(args->alpha);                                      \
+                                                                         \
+  for (size_t i = begin; i < end; i++) {                                 \
+    dest[i] = VV_SCALAR(op, T, U, MAD, src0[i], src1[i], src2[i], k);    \
+  }                                                                      \
+  (void)src2; (void)k;                                                   \
+}
+#endif
+
+VV_FOR_EACH(VEC_KERNEL)
+
+#define VEC_ENTRY(op, OP, name, NAME, T, U, MAD) VV_ENTRY(vec, op, OP, name, NAME)
+
+static const vv_kernel_t vec_kernels[VV_NUM_OPS][VV_NUM_TYPES] = {
+  VV_FOR_EACH(VEC_ENTRY)
+};
+
+/* Alternative Implementation */
+void* impl_vector(void* args)
+{
+  /* Get the argument struct */
+  args_t* parsed_args = (args_t*)args;
+
+  /* Run the kernel of the op and type over all elements */
+  vec_kernels[parsed_args->op][parsed_args->type](parsed_args, 0, parsed_args->size);
 
   /* Done */
   return NULL;
-#elif defined(__aarch__) || defined(__aarch64__) || defined(__arm64__)
-#endif
 }
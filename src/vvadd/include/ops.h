@@ -0,0 +1,96 @@
+/* ops.h
+ *
+ * Templates of the element-wise operations. Every implementation
+ * generates one kernel per (op, type) from VV_FOR_EACH and picks it
+ * from a table indexed by args->op and args->type, so the kernels of
+ * all implementations compute the same thing element by element:
+ *
+ *  - integer arithmetic wraps (it is carried out in an unsigned type
+ *    at least as wide as int, so int8/int16 products cannot overflow
+ *    the promoted int);
+ *  - min/max are (a < b ? a : b) and (a > b ? a : b), which is what
+ *    the SIMD min/max instructions return for floats too;
+ *  - fma and saxpy are fused (single rounding) for float and double.
+ *
+ * Results are therefore bit-exact across implementations.
+*/
+
+#ifndef __INCLUDE_OPS_H_
+#define __INCLUDE_OPS_H_
+
+/* Standard C includes */
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+/* Include application-specific headers */
+#include "include/types.h"
+
+/* Multiply-add in the arithmetic type U */
+#define VV_IMAD(U, a, b, c) ((U)(a) * (U)(b) + (U)(c))
+#define VV_FMAF(U, a, b, c) fmaf((a), (b), (c))
+#define VV_FMA(U, a, b, c)  fma((a), (b), (c))
+
+/* Calls X(op, OP, name, NAME, T, U, MAD) for every type of op:
+ * T is the element type, U the type arithmetic is carried out in
+ * and MAD its multiply-add.                                        */
+#define VV_FOR_EACH_TYPE(X, op, OP)                                  \
+  X(op, OP, int8  , INT8  , int8_t , uint32_t, VV_IMAD)              \
+  X(op, OP, int16 , INT16 , int16_t, uint32_t, VV_IMAD)              \
+  X(op, OP, int32 , INT32 , int32_t, uint32_t, VV_IMAD)              \
+  X(op, OP, int64 , INT64 , int64_t, uint64_t, VV_IMAD)              \
+  X(op, OP, float , FLOAT , float  , float   , VV_FMAF)              \
+  X(op, OP, double, DOUBLE, double , double  , VV_FMA )
+
+/* Calls X for every (op, type) */
+#define VV_FOR_EACH(X)                                               \
+  VV_FOR_EACH_TYPE(X, add  , ADD  )                                  \
+  VV_FOR_EACH_TYPE(X, sub  , SUB  )                                  \
+  VV_FOR_EACH_TYPE(X, mul  , MUL  )                                  \
+  VV_FOR_EACH_TYPE(X, min  , MIN  )                                  \
+  VV_FOR_EACH_TYPE(X, max  , MAX  )                                  \
+  VV_FOR_EACH_TYPE(X, fma  , FMA  )                                  \
+  VV_FOR_EACH_TYPE(X, saxpy, SAXPY)
+
+/* One element: a = src0[i], b = src1[i], c = src2[i], k = alpha.
+ * c is only evaluated by fma, so src2 may be NULL for other ops.   */
+#define VV_SCALAR_add(T, U, MAD, a, b, c, k)   ((T)((U)(a) + (U)(b)))
+#define VV_SCALAR_sub(T, U, MAD, a, b, c, k)   ((T)((U)(a) - (U)(b)))
+#define VV_SCALAR_mul(T, U, MAD, a, b, c, k)   ((T)((U)(a) * (U)(b)))
+#define VV_SCALAR_min(T, U, MAD, a, b, c, k)   ((a) < (b) ? (a) : (b))
+#define VV_SCALAR_max(T, U, MAD, a, b, c, k)   ((a) > (b) ? (a) : (b))
+#define VV_SCALAR_fma(T, U, MAD, a, b, c, k)   ((T)MAD(U, a, b, c))
+#define VV_SCALAR_saxpy(T, U, MAD, a, b, c, k) ((T)MAD(U, k, a, b))
+
+#define VV_SCALAR(op, T, U, MAD, a, b, c, k) VV_SCALAR_##op(T, U, MAD, a, b, c, k)
+
+/* Table entry of the kernel of (op, type) */
+#define VV_ENTRY(prefix, op, OP, name, NAME) \
+  [VV_OP_##OP][VV_##NAME] = prefix##_##op##_##name,
+
+/* Kernel signature: elements [begin, end) of args */
+typedef void (*vv_kernel_t)(const args_t* args, size_t begin, size_t end);
+
+static const char* const vv_op_names[VV_NUM_OPS] = {
+  "add", "sub", "mul", "min", "max", "fma", "saxpy"
+};
+
+static const char* const vv_type_names[VV_NUM_TYPES] = {
+  "int8", "int16", "int32", "int64", "float", "double"
+};
+
+static const size_t vv_type_sizes[VV_NUM_TYPES] = {
+  sizeof(int8_t), sizeof(int16_t), sizeof(int32_t), sizeof(int64_t),
+  sizeof(float), sizeof(double)
+};
+
+/* Index of name in names[0 .. n), or -1 */
+static inline int vv_lookup(const char* const* names, int n, const char* name)
+{
+  for (int i = 0; i < n; i++) {
+    if (strcmp(names[i], name) == 0) return i;
+  }
+  return -1;
+}
+
+#endif //__INCLUDE_OPS_H_
@@ -9,15 +9,46 @@
 #ifndef __INCLUDE_TYPES_H_
 #define __INCLUDE_TYPES_H_
 
+#include <stddef.h>
+
+/* Element-wise operations (same order as VV_FOR_EACH in ops.h) */
+typedef enum {
+  VV_OP_ADD   = 0,   /* dest = src0 + src1          */
+  VV_OP_SUB   = 1,   /* dest = src0 - src1          */
+  VV_OP_MUL   = 2,   /* dest = src0 * src1          */
+  VV_OP_MIN   = 3,   /* dest = min(src0, src1)      */
+  VV_OP_MAX   = 4,   /* dest = max(src0, src1)      */
+  VV_OP_FMA   = 5,   /* dest = src0 * src1 + src2   */
+  VV_OP_SAXPY = 6,   /* dest = alpha * src0 + src1  */
+  VV_NUM_OPS
+} vv_op_t;
+
+/* Element types (same order as VV_FOR_EACH in ops.h) */
+typedef enum {
+  VV_INT8   = 0,
+  VV_INT16  = 1,
+  VV_INT32  = 2,
+  VV_INT64  = 3,
+  VV_FLOAT  = 4,
+  VV_DOUBLE = 5,
+  VV_NUM_TYPES
+} vv_type_t;
+
 typedef struct {
   byte*   input0;
   byte*   input1;
+  byte*   input2;    /* Only read by VV_OP_FMA */
   byte*   output;
 
-  size_t size;
+  size_t  size;      /* In elements of type    */
+
+  vv_op_t   op;
+  vv_type_t type;
+  double    alpha;   /* VV_OP_SAXPY, converted to type */
 
   int     cpu;
   int     nthreads;
+  const int* cpus;   /* CPU of thread i (impl_parallel), NULL = unpinned */
 } args_t;
 
 #endif //__INCLUDE_TYPES_H_
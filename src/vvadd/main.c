@@ -20,6 +20,14 @@
  * Then, the file will calculate the standard deviation and calculate
  * an outlier-free average by excluding runtimes that are larger than
  * 2 standard deviation of the original average.
+ *
+ * The element-wise operation and the element type are chosen with --op
+ * and --type (see include/ops.h); "all" runs, checks and times every
+ * combination in turn and prints a summary table.
+ *
+ * The threads of impl_parallel are placed with --placement on the CPU
+ * topology read from sysfs (see impl/topology.h); thread 0 runs on the
+ * main CPU given with --cpu.
  */
 
 /* Set features         */
@@ -48,6 +56,7 @@
 #include "impl/opt.h"
 #include "impl/vec.h"
 #include "impl/para.h"
+#include "impl/topology.h"
 
 /* Include common headers */
 #include "common/types.h"
@@ -55,195 +64,78 @@
 
 /* Include application-specific headers */
 #include "include/types.h"
+#include "include/ops.h"
 
 const int SIZE_DATA = 4 * 1024 * 1024;
 
-int main(int argc, char** argv)
+/* Random elements of type: any bit pattern for the integers (they
+ * wrap), small multiples of 1/16 for floats so that no NaN or infinity
+ * can come out of any op                                              */
+static void init_data(vv_type_t type, byte* data, size_t nelems)
 {
-  /* Set the buffer for printf to NULL */
-  setbuf(stdout, NULL);
-
-  /* Arguments */
-  int nthreads = 1;
-  int cpu      = 0;
-
-  int nruns    = 10000;
-  int nstdevs  = 3;
-
-  /* Data */
-  int data_size = SIZE_DATA;
-
-  /* Parse arguments */
-  /* Function pointers */
-  void* (*impl_scalar_naive_ptr)(void* args) = impl_scalar_naive;
-  void* (*impl_scalar_opt_ptr  )(void* args) = impl_scalar_opt;
-  void* (*impl_vector_ptr      )(void* args) = impl_vector;
-  void* (*impl_parallel_ptr    )(void* args) = impl_parallel;
-
-  /* Chosen */
-  void* (*impl)(void* args) = NULL;
-  const char* impl_str      = NULL;
-
-  bool help = false;
-  for (int i = 1; i < argc; i++) {
-    /* Implementations */
-    if (strcmp(argv[i], "-i") == 0 || strcmp(argv[i], "--impl") == 0) {
-      assert (++i < argc);
-      if (strcmp(argv[i], "naive") == 0) {
-        impl = impl_scalar_naive_ptr; impl_str = "scalar_naive";
-      } else if (strcmp(argv[i], "opt"  ) == 0) {
-        impl = impl_scalar_opt_ptr  ; impl_str = "scalar_opt"  ;
-      } else if (strcmp(argv[i], "vec"  ) == 0) {
-        impl = impl_vector_ptr      ; impl_str = "vectorized"  ;
-      } else if (strcmp(argv[i], "para" ) == 0) {
-        impl = impl_parallel_ptr    ; impl_str = "parallelized";
-      } else {
-        impl = NULL                 ; impl_str = "unknown"     ;
-      }
-
-      continue;
-    }
-
-    /* Input/output data size */
-    if (strcmp(argv[i], "-s") == 0 || strcmp(argv[i], "--size") == 0) {
-      assert (++i < argc);
-      data_size = atoi(argv[i]) * sizeof(int);
-
-      continue;
-    }
-
-    /* Run parameterization */
-    if (strcmp(argv[i], "--nruns") == 0) {
-      assert (++i < argc);
-      nruns = atoi(argv[i]);
-
-      continue;
-    }
-
-    if (strcmp(argv[i], "--nstdevs") == 0) {
-      assert (++i < argc);
-      nstdevs = atoi(argv[i]);
-
-      continue;
-    }
-
-    /* Parallelization */
-    if (strcmp(argv[i], "-n") == 0 || strcmp(argv[i], "--nthreads") == 0) {
-      assert (++i < argc);
-      nthreads = atoi(argv[i]);
-
-      continue;
-    }
-
-    if (strcmp(argv[i], "-c") == 0 || strcmp(argv[i], "--cpu") == 0) {
-      assert (++i < argc);
-      cpu = atoi(argv[i]);
-
-      continue;
-    }
-
-    /* Help */
-    if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
-      help = true;
-
-      continue;
-    }
+  switch (type) {
+    case VV_FLOAT:
+      for (size_t i = 0; i < nelems; i++)
+        ((float*)data)[i] = (float)(rand() % 2001 - 1000) / 16.0f;
+      break;
+    case VV_DOUBLE:
+      for (size_t i = 0; i < nelems; i++)
+        ((double*)data)[i] = (double)(rand() % 2001 - 1000) / 16.0;
+      break;
+    default:
+      for (size_t i = 0; i < nelems * vv_type_sizes[type]; i++)
+        data[i] = rand() % 256;
+      break;
   }
+}
 
-  if (help || impl == NULL) {
-    if (!help) {
-      if (impl_str != NULL) {
-        printf("\n");
-        printf("ERROR: Unknown \"%s\" implementation.\n", impl_str);
-      } else {
-        printf("\n");
-        printf("ERROR: No implementation was chosen.\n");
-      }
-    }
-    printf("\n");
-    printf("Usage:\n");
-    printf("  %s {-i | --impl} impl_str [Options]\n", argv[0]);
-    printf("  \n");
-    printf("  Required:\n");
-    printf("    -i | --impl      Available implementations = {naive, opt, vec, para}\n");
-    printf("    \n");
-    printf("  Options:\n");
-    printf("    -h | --help      Print this message\n");
-    printf("    -n | --nthreads  Set number of threads available (default = %d)\n", nthreads);
-    printf("    -c | --cpu       Set the main CPU for the program (default = %d)\n", cpu);
-    printf("    -s | --size      Size of input and output data (default = %ld)\n", data_size / sizeof(int));
-    printf("         --nruns     Number of runs to the implementation (default = %d)\n", nruns);
-    printf("         --stdevs    Number of standard deviation to exclude outliers (default = %d)\n", nstdevs);
-    printf("\n");
-
-    exit(help? 0 : 1);
-  }
-
-  /* Set our priority the highest */
-  int nice_level = -20;
-
-  printf("Setting up schedulers and affinity:\n");
-  printf("  * Setting the niceness level:\n");
-  do {
-    errno = 0;
-    printf("      -> trying niceness level = %d\n", nice_level);
-    int __attribute__((unused)) ret = nice(nice_level);
-  } while (errno != 0 && nice_level++);
+/* Time impl on (op, type) over nelems elements, nruns x 16 calls, and
+ * check it against impl_ref; returns whether the output matched       */
+static bool run(void* (*impl)(void* args), const char* impl_str,
+                vv_op_t op, vv_type_t type, size_t nelems, double alpha,
+                int nruns, int nstdevs, int cpu, int nthreads, const int* cpus,
+                uint64_t* avg_ns)
+{
+  /* Statistics */
+  __DECLARE_STATS(nruns, nstdevs);
 
-  printf("    + Process has niceness level = %d\n", nice_level);
+  /* Datasets */
+  size_t data_size = nelems * vv_type_sizes[type];
 
-  /* If we are on an apple operating system, skip the scheduling  *
-   * routine; Darwin does not support sched_set* system calls ... *
-   *                                                              *
-   * hawajkm: and here I was--thinking that MacOS is POSIX ...    *
-   *          Silly me!                                           */
-#if !defined(__APPLE__)
-  /* Set scheduling to reduce context switching */
-  /*    -> Set scheduling scheme                */
-  printf("  * Setting up FIFO scheduling scheme and high priority ... ");
-  pid_t pid    = 0;
-  int   policy = SCHED_FIFO;
-  struct sched_param param;
+  /* Allocation and initialization; src2 only for fma */
+  byte* src0  = __ALLOC_DATA(byte, data_size + 0);
+  byte* src1  = __ALLOC_DATA(byte, data_size + 0);
+  byte* src2  = op == VV_OP_FMA ? __ALLOC_DATA(byte, data_size + 0) : NULL;
+  byte* ref   = __ALLOC_DATA(byte, data_size + 4);
+  byte* dest  = __ALLOC_DATA(byte, data_size + 4);
 
-  param.sched_priority = sched_get_priority_max(policy);
-  int res = sched_setscheduler(pid, policy, &param);
-  if (res != 0) {
-    printf("Failed\n");
-  } else {
-    printf("Succeeded\n");
-  }
+  /* Arguments for the function */
+  args_t args;
 
-  /*    -> Set affinity                         */
-  printf("  * Setting up scheduling affinity ... ");
-  cpu_set_t cpumask;
+  args.size     = nelems;
+  args.input0   = src0;
+  args.input1   = src1;
+  args.input2   = src2;
+  args.output   = dest;
 
-  CPU_ZERO(&cpumask);
-  for (int i = 0; i < nthreads; i++) {
-    CPU_SET((cpu + i) % nthreads, &cpumask);
-  }
+  args.op       = op;
+  args.type     = type;
+  args.alpha    = alpha;
 
-  res = sched_setaffinity(pid, sizeof(cpumask), &cpumask);
+  args.cpu      = cpu;
+  args.nthreads = nthreads;
+  args.cpus     = cpus;
 
-  if (res != 0) {
-    printf("Failed\n");
-  } else {
-    printf("Succeeded\n");
+  /* First touch by the pool, so every thread's share of the pages is
+   * on its own NUMA node; ref stays with the main thread             */
+  bool pooled = (impl == impl_parallel);
+  if (pooled) {
+    impl_parallel_touch(&args);
   }
-#endif
-  printf("\n");
 
-  /* Statistics */
-  __DECLARE_STATS(nruns, nstdevs);
-
-  /* Initialize Rand */
-  srand(0xdeadbeef);
-
-  /* Datasets */
-  /* Allocation and initialization */
-  byte* src0  = __ALLOC_INIT_DATA(byte, data_size + 0);
-  byte* src1  = __ALLOC_INIT_DATA(byte, data_size + 0);
-  byte* ref   = __ALLOC_INIT_DATA(byte, data_size + 4);
-  byte* dest  = __ALLOC_DATA     (byte, data_size + 4);
+  init_data(type, src0, nelems);
+  init_data(type, src1, nelems);
+  if (src2 != NULL) init_data(type, src2, nelems);
 
   /* Setting a guards, which is 0xdeadcafe.
      The guard should not change or be touched. */
@@ -254,31 +146,33 @@ int main(int argc, char** argv)
   /* Arguments for the functions */
   args_t args_ref;
 
-  args_ref.size     = data_size;
+  args_ref.size     = nelems;
   args_ref.input0   = src0;
   args_ref.input1   = src1;
+  args_ref.input2   = src2;
   args_ref.output   = ref;
 
+  args_ref.op       = op;
+  args_ref.type     = type;
+  args_ref.alpha    = alpha;
+
   args_ref.cpu      = cpu;
   args_ref.nthreads = nthreads;
+  args_ref.cpus     = cpus;
 
   /* Running the reference function */
   impl_ref(&args_ref);
 
   /* Execute the requested implementation */
-  /* Arguments for the function */
-  args_t args;
-
-  args.size     = data_size;
-  args.input0   = src0;
-  args.input1   = src1;
-  args.output   = dest;
-
-  args.cpu      = cpu;
-  args.nthreads = nthreads;
-
   /* Start execution */
-  printf("Running \"%s\" implementation:\n", impl_str);
+  printf("Running \"%s\" implementation (%s, %s):\n", impl_str,
+         vv_op_names[op], vv_type_names[type]);
+
+  /* Warm up the pool of impl_parallel */
+  if (pooled) {
+    (*impl)(&args);
+    impl_parallel_reset_stats();
+  }
 
   printf("  * Invoking the implementation %d times .... ", num_runs);
   for (int i = 0; i < num_runs; i++) {
@@ -383,12 +277,25 @@ int main(int argc, char** argv)
   printf("  * Runtimes (%s): ", __PRINT_MATCH(match));
   printf(" %" PRIu64 " ns\n"  , avg                 );
 
+  /* Overheads of the worker pool, per call */
+  if (pooled) {
+    pool_stats_t pstats;
+    impl_parallel_stats(&pstats);
+    if (pstats.calls > 0) {
+      printf("  * Pool overheads over %" PRIu64 " calls:\n", pstats.calls);
+      printf("    - Dispatch (last worker started) = %" PRIu64 " ns avg, %" PRIu64 " ns max\n",
+             pstats.dispatch_ns / pstats.calls, pstats.max_dispatch_ns);
+      printf("    - Join (last share finished)     = %" PRIu64 " ns avg, %" PRIu64 " ns max\n",
+             pstats.join_ns / pstats.calls, pstats.max_join_ns);
+    }
+  }
+
   /* Dump */
   printf("  * Dumping runtime informations:\n");
   FILE * fp;
   char filename[256];
-  strcpy(filename, impl_str);
-  strcat(filename, "_runtimes.csv");
+  snprintf(filename, sizeof(filename), "%s_%s_%s_runtimes.csv",
+           impl_str, vv_op_names[op], vv_type_names[type]);
   printf("    - Filename: %s\n", filename);
   printf("    - Opening file .... ");
   fp = fopen(filename, "w");
@@ -398,6 +305,12 @@ int main(int argc, char** argv)
     printf("    - Writing runtimes ... ");
     fprintf(fp, "impl,%s", impl_str);
 
+    fprintf(fp, "\n");
+    fprintf(fp, "op,%s", vv_op_names[op]);
+
+    fprintf(fp, "\n");
+    fprintf(fp, "type,%s", vv_type_names[type]);
+
     fprintf(fp, "\n");
     fprintf(fp, "num_of_runs,%d", num_runs);
 
@@ -422,6 +335,7 @@ int main(int argc, char** argv)
   /* Manage memory */
   free(src0);
   free(src1);
+  free(src2);
   free(dest);
   free(ref);
 
@@ -429,5 +343,311 @@ int main(int argc, char** argv)
   __DESTROY_STATS();
 
   /* Done */
-  return 0;
+  *avg_ns = avg;
+  return match && guard;
+}
+
+int main(int argc, char** argv)
+{
+  /* Set the buffer for printf to NULL */
+  setbuf(stdout, NULL);
+
+  /* Arguments */
+  int nthreads = 1;
+  int cpu      = 0;
+
+  int nruns    = 10000;
+  int nstdevs  = 3;
+
+  /* Data */
+  size_t nelems = SIZE_DATA / sizeof(int);
+
+  /* Operation and element type (-1 = all of them) */
+  int    op_sel   = VV_OP_ADD;
+  int    type_sel = VV_INT32;
+  double alpha    = 3.0;
+
+  /* Thread placement */
+  const char*      placement_str = "linear";
+  topo_placement_t placement;
+  topo_parse_placement(placement_str, &placement);
+
+  /* Per (op, type) results */
+  uint64_t summary_avg[VV_NUM_OPS][VV_NUM_TYPES];
+  bool     summary_ok [VV_NUM_OPS][VV_NUM_TYPES];
+
+  /* Parse arguments */
+  /* Function pointers */
+  void* (*impl_scalar_naive_ptr)(void* args) = impl_scalar_naive;
+  void* (*impl_scalar_opt_ptr  )(void* args) = impl_scalar_opt;
+  void* (*impl_vector_ptr      )(void* args) = impl_vector;
+  void* (*impl_parallel_ptr    )(void* args) = impl_parallel;
+
+  /* Chosen */
+  void* (*impl)(void* args) = NULL;
+  const char* impl_str      = NULL;
+
+  bool help = false;
+  for (int i = 1; i < argc; i++) {
+    /* Implementations */
+    if (strcmp(argv[i], "-i") == 0 || strcmp(argv[i], "--impl") == 0) {
+      assert (++i < argc);
+      if (strcmp(argv[i], "naive") == 0) {
+        impl = impl_scalar_naive_ptr; impl_str = "scalar_naive";
+      } else if (strcmp(argv[i], "opt"  ) == 0) {
+        impl = impl_scalar_opt_ptr  ; impl_str = "scalar_opt"  ;
+      } else if (strcmp(argv[i], "vec"  ) == 0) {
+        impl = impl_vector_ptr      ; impl_str = "vectorized"  ;
+      } else if (strcmp(argv[i], "para" ) == 0) {
+        impl = impl_parallel_ptr    ; impl_str = "parallelized";
+      } else {
+        impl = NULL                 ; impl_str = "unknown"     ;
+      }
+
+      continue;
+    }
+
+    /* Input/output data size */
+    if (strcmp(argv[i], "-s") == 0 || strcmp(argv[i], "--size") == 0) {
+      assert (++i < argc);
+      nelems = strtoull(argv[i], NULL, 10);
+
+      continue;
+    }
+
+    /* Operation and element type */
+    if (strcmp(argv[i], "--op") == 0) {
+      assert (++i < argc);
+      op_sel = strcmp(argv[i], "all") == 0 ? -1 : vv_lookup(vv_op_names, VV_NUM_OPS, argv[i]);
+      if (op_sel < 0 && strcmp(argv[i], "all") != 0) {
+        printf("ERROR: Unknown \"%s\" operation.\n", argv[i]);
+        exit(1);
+      }
+
+      continue;
+    }
+
+    if (strcmp(argv[i], "--type") == 0) {
+      assert (++i < argc);
+      type_sel = strcmp(argv[i], "all") == 0 ? -1 : vv_lookup(vv_type_names, VV_NUM_TYPES, argv[i]);
+      if (type_sel < 0 && strcmp(argv[i], "all") != 0) {
+        printf("ERROR: Unknown \"%s\" type.\n", argv[i]);
+        exit(1);
+      }
+
+      continue;
+    }
+
+    if (strcmp(argv[i], "--alpha") == 0) {
+      assert (++i < argc);
+      alpha = atof(argv[i]);
+
+      continue;
+    }
+
+    /* Run parameterization */
+    if (strcmp(argv[i], "--nruns") == 0) {
+      assert (++i < argc);
+      nruns = atoi(argv[i]);
+
+      continue;
+    }
+
+    if (strcmp(argv[i], "--nstdevs") == 0) {
+      assert (++i < argc);
+      nstdevs = atoi(argv[i]);
+
+      continue;
+    }
+
+    /* Parallelization */
+    if (strcmp(argv[i], "-n") == 0 || strcmp(argv[i], "--nthreads") == 0) {
+      assert (++i < argc);
+      nthreads = atoi(argv[i]);
+
+      continue;
+    }
+
+    if (strcmp(argv[i], "-c") == 0 || strcmp(argv[i], "--cpu") == 0) {
+      assert (++i < argc);
+      cpu = atoi(argv[i]);
+
+      continue;
+    }
+
+    if (strcmp(argv[i], "--placement") == 0) {
+      assert (++i < argc);
+      placement_str = argv[i];
+      if (topo_parse_placement(placement_str, &placement) != 0) {
+        printf("ERROR: Unknown \"%s\" placement.\n", placement_str);
+        exit(1);
+      }
+
+      continue;
+    }
+
+    /* Help */
+    if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+      help = true;
+
+      continue;
+    }
+  }
+
+  if (help || impl == NULL) {
+    if (!help) {
+      if (impl_str != NULL) {
+        printf("\n");
+        printf("ERROR: Unknown \"%s\" implementation.\n", impl_str);
+      } else {
+        printf("\n");
+        printf("ERROR: No implementation was chosen.\n");
+      }
+    }
+    printf("\n");
+    printf("Usage:\n");
+    printf("  %s {-i | --impl} impl_str [Options]\n", argv[0]);
+    printf("  \n");
+    printf("  Required:\n");
+    printf("    -i | --impl      Available implementations = {naive, opt, vec, para}\n");
+    printf("    \n");
+    printf("  Options:\n");
+    printf("    -h | --help      Print this message\n");
+    printf("    -n | --nthreads  Set number of threads available (default = %d)\n", nthreads);
+    printf("    -c | --cpu       Set the main CPU for the program (default = %d)\n", cpu);
+    printf("         --placement Thread placement = {linear, compact, scatter, numa}[,nosmt] (default = %s)\n", placement_str);
+    printf("    -s | --size      Number of elements of input and output data (default = %zu)\n", nelems);
+    printf("         --op        Operation = {add, sub, mul, min, max, fma, saxpy, all} (default = add)\n");
+    printf("         --type      Element type = {int8, int16, int32, int64, float, double, all} (default = int32)\n");
+    printf("         --alpha     Scalar of saxpy, converted to the element type (default = %g)\n", alpha);
+    printf("         --nruns     Number of runs to the implementation (default = %d)\n", nruns);
+    printf("         --stdevs    Number of standard deviation to exclude outliers (default = %d)\n", nstdevs);
+    printf("\n");
+
+    exit(help? 0 : 1);
+  }
+
+  /* CPU topology and the CPU of every thread */
+  topology_t topo;
+  if (nthreads < 1) nthreads = 1;
+  if (topo_load(&topo, NULL) != 0) {
+    printf("ERROR: No online CPU found.\n");
+    exit(1);
+  }
+
+  int cpus[nthreads];
+  int ndistinct = topo_place(&topo, &placement, cpu, nthreads, cpus);
+
+  printf("Thread placement:\n");
+  printf("  * Topology (%s): %d CPU(s), %d core(s), %d package(s), %d node(s)\n",
+         topo.from_sysfs ? "sysfs" : "fallback",
+         topo.ncpus, topo.ncores, topo.npackages, topo.nnodes);
+  printf("  * Placement (%s%s):", topo_policy_name(placement.policy),
+         placement.smt ? "" : ",nosmt");
+  for (int i = 0; i < nthreads; i++) printf(" %d", cpus[i]);
+  printf("\n");
+  if (ndistinct < nthreads) {
+    printf("    + %d thread(s) share %d CPU(s)\n", nthreads, ndistinct);
+  }
+  printf("\n");
+
+  /* Set our priority the highest */
+  int nice_level = -20;
+
+  printf("Setting up schedulers and affinity:\n");
+  printf("  * Setting the niceness level:\n");
+  do {
+    errno = 0;
+    printf("      -> trying niceness level = %d\n", nice_level);
+    int __attribute__((unused)) ret = nice(nice_level);
+  } while (errno != 0 && nice_level++);
+
+  printf("    + Process has niceness level = %d\n", nice_level);
+
+  /* If we are on an apple operating system, skip the scheduling  *
+   * routine; Darwin does not support sched_set* system calls ... *
+   *                                                              *
+   * hawajkm: and here I was--thinking that MacOS is POSIX ...    *
+   *          Silly me!                                           */
+#if !defined(__APPLE__)
+  /* Set scheduling to reduce context switching */
+  /*    -> Set scheduling scheme                */
+  printf("  * Setting up FIFO scheduling scheme and high priority ... ");
+  pid_t pid    = 0;
+  int   policy = SCHED_FIFO;
+  struct sched_param param;
+
+  param.sched_priority = sched_get_priority_max(policy);
+  int res = sched_setscheduler(pid, policy, &param);
+  if (res != 0) {
+    printf("Failed\n");
+  } else {
+    printf("Succeeded\n");
+  }
+
+  /*    -> Set affinity                         */
+  printf("  * Setting up scheduling affinity ... ");
+  cpu_set_t cpumask;
+
+  CPU_ZERO(&cpumask);
+  for (int i = 0; i < nthreads; i++) {
+    CPU_SET(cpus[i], &cpumask);
+  }
+
+  res = sched_setaffinity(pid, sizeof(cpumask), &cpumask);
+
+  if (res != 0) {
+    printf("Failed\n");
+  } else {
+    printf("Succeeded\n");
+  }
+#endif
+  printf("\n");
+
+  /* Initialize Rand */
+  srand(0xdeadbeef);
+
+  /* Every requested (op, type) */
+  int nfailed = 0;
+  int ncombos = 0;
+  for (int op = 0; op < VV_NUM_OPS; op++) {
+    if (op_sel >= 0 && op != op_sel) continue;
+    for (int type = 0; type < VV_NUM_TYPES; type++) {
+      if (type_sel >= 0 && type != type_sel) continue;
+
+      uint64_t avg;
+      bool ok = run(impl, impl_str, (vv_op_t)op, (vv_type_t)type, nelems, alpha,
+                    nruns, nstdevs, cpu, nthreads, cpus, &avg);
+      nfailed += !ok;
+      ncombos += 1;
+      summary_avg[op][type] = avg;
+      summary_ok [op][type] = ok;
+    }
+  }
+
+  if (ncombos > 1) {
+    printf("Summary (\"%s\", %zu elements, average ns per call):\n", impl_str, nelems);
+    printf("  %-6s", "");
+    for (int type = 0; type < VV_NUM_TYPES; type++)
+      if (type_sel < 0 || type == type_sel) printf(" %12s", vv_type_names[type]);
+    printf("\n");
+    for (int op = 0; op < VV_NUM_OPS; op++) {
+      if (op_sel >= 0 && op != op_sel) continue;
+      printf("  %-6s", vv_op_names[op]);
+      for (int type = 0; type < VV_NUM_TYPES; type++) {
+        if (type_sel >= 0 && type != type_sel) continue;
+        printf(" %11" PRIu64 "%c", summary_avg[op][type], summary_ok[op][type] ? ' ' : '!');
+      }
+      printf("\n");
+    }
+    printf("  %d of %d combination(s) %s\n", ncombos - nfailed, ncombos, "matching the reference");
+    printf("\n");
+  }
+
+  /* Stop the workers of impl_parallel, if it started any */
+  impl_parallel_shutdown();
+  topo_free(&topo);
+
+  /* Done */
+  return nfailed > 0 ? 1 : 0;
 }